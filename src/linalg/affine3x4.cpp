@@ -0,0 +1,196 @@
+
+#include "affine3x4.h"
+
+#include <iostream>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Set to the identity transform
+///
+/// @return     the updated transform
+///
+affine3x4& affine3x4::id() {
+    m_aff = {{
+        1, 0, 0,
+        0, 1, 0,
+        0, 0, 1,
+        0, 0, 0 }};
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply this transform by another. As with matrix4::mul,
+/// this transform is applied first and then the other one. Only the 3x3
+/// part and the translation are computed (36 multiplies instead of 64).
+///
+/// @param[in]  other  The other transform
+///
+/// @return     the updated transform
+///
+affine3x4& affine3x4::mul(const affine3x4& other) {
+    // Copies, so that other can be this transform
+    auto m00 = other.m_aff[0], m01 = other.m_aff[1], m02 = other.m_aff[2],
+         m10 = other.m_aff[3], m11 = other.m_aff[4], m12 = other.m_aff[5],
+         m20 = other.m_aff[6], m21 = other.m_aff[7], m22 = other.m_aff[8],
+         m30 = other.m_aff[9], m31 = other.m_aff[10], m32 = other.m_aff[11];
+
+    for (auto i = 0u; i < 12; i += 3) {
+        auto b0 = m_aff[i], b1 = m_aff[i + 1], b2 = m_aff[i + 2];
+        m_aff[i] = b0 * m00 + b1 * m10 + b2 * m20;
+        m_aff[i + 1] = b0 * m01 + b1 * m11 + b2 * m21;
+        m_aff[i + 2] = b0 * m02 + b1 * m12 + b2 * m22;
+    }
+
+    // The translation row also picks up the other translation
+    m_aff[9] += m30;
+    m_aff[10] += m31;
+    m_aff[11] += m32;
+    return *this;
+}
+affine3x4& affine3x4::operator*=(const affine3x4& other) {
+    return mul(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert this transform. Only the 3x3 part needs a cofactor
+/// inverse; the translation is then moved through it.
+///
+/// @return     the updated transform (unchanged if it is singular)
+///
+affine3x4& affine3x4::invert() {
+    auto a00 = m_aff[0], a01 = m_aff[1], a02 = m_aff[2],
+         a10 = m_aff[3], a11 = m_aff[4], a12 = m_aff[5],
+         a20 = m_aff[6], a21 = m_aff[7], a22 = m_aff[8],
+         tx = m_aff[9], ty = m_aff[10], tz = m_aff[11];
+
+    auto b00 = a11 * a22 - a12 * a21,
+         b10 = a12 * a20 - a10 * a22,
+         b20 = a10 * a21 - a11 * a20;
+
+    // Calculate the determinant
+    auto det = a00 * b00 + a01 * b10 + a02 * b20;
+    if (nearly_equal(det, 0)) {
+        return *this;
+    }
+    det = static_cast<scalar>(1.0) / det;
+
+    m_aff[0] = b00 * det;
+    m_aff[1] = (a02 * a21 - a01 * a22) * det;
+    m_aff[2] = (a01 * a12 - a02 * a11) * det;
+    m_aff[3] = b10 * det;
+    m_aff[4] = (a00 * a22 - a02 * a20) * det;
+    m_aff[5] = (a02 * a10 - a00 * a12) * det;
+    m_aff[6] = b20 * det;
+    m_aff[7] = (a01 * a20 - a00 * a21) * det;
+    m_aff[8] = (a00 * a11 - a01 * a10) * det;
+
+    // The translation is -t times the inverted 3x3
+    m_aff[9] = -(tx * m_aff[0] + ty * m_aff[3] + tz * m_aff[6]);
+    m_aff[10] = -(tx * m_aff[1] + ty * m_aff[4] + tz * m_aff[7]);
+    m_aff[11] = -(tx * m_aff[2] + ty * m_aff[5] + tz * m_aff[8]);
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert this transform assuming that the 3x3 part is
+/// orthonormal (a rotation with no scale). The inverse rotation is the
+/// transpose, so no determinant or division is needed.
+///
+/// @return     the updated transform
+///
+affine3x4& affine3x4::invert_rigid() {
+    auto a01 = m_aff[1], a02 = m_aff[2], a12 = m_aff[5],
+         tx = m_aff[9], ty = m_aff[10], tz = m_aff[11];
+
+    m_aff[1] = m_aff[3];
+    m_aff[2] = m_aff[6];
+    m_aff[3] = a01;
+    m_aff[5] = m_aff[7];
+    m_aff[6] = a02;
+    m_aff[7] = a12;
+
+    m_aff[9] = -(tx * m_aff[0] + ty * m_aff[3] + tz * m_aff[6]);
+    m_aff[10] = -(tx * m_aff[1] + ty * m_aff[4] + tz * m_aff[7]);
+    m_aff[11] = -(tx * m_aff[2] + ty * m_aff[5] + tz * m_aff[8]);
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the translation part of this transform
+///
+/// @return     the translation
+///
+vector3 affine3x4::translation() const {
+    return {m_aff[9], m_aff[10], m_aff[11]};
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return a point transformed by this transform
+///
+/// @param[in]  p     The point
+///
+/// @return     the transformed point
+///
+vector3 affine3x4::transform_point(const vector3& p) const {
+    return {
+        p.x() * m_aff[0] + p.y() * m_aff[3] + p.z() * m_aff[6] + m_aff[9],
+        p.x() * m_aff[1] + p.y() * m_aff[4] + p.z() * m_aff[7] + m_aff[10],
+        p.x() * m_aff[2] + p.y() * m_aff[5] + p.z() * m_aff[8] + m_aff[11]
+    };
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return a direction transformed by this transform (the
+/// translation is ignored)
+///
+/// @param[in]  v     The direction
+///
+/// @return     the transformed direction
+///
+vector3 affine3x4::transform_vector(const vector3& v) const {
+    return {
+        v.x() * m_aff[0] + v.y() * m_aff[3] + v.z() * m_aff[6],
+        v.x() * m_aff[1] + v.y() * m_aff[4] + v.z() * m_aff[7],
+        v.x() * m_aff[2] + v.y() * m_aff[5] + v.z() * m_aff[8]
+    };
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the full matrix4 (e.g. to upload as a uniform)
+///
+/// @return     the matrix4 with the constant column restored
+///
+matrix4 affine3x4::to_matrix4() const {
+    return {mat_array{{
+        m_aff[0], m_aff[1], m_aff[2], 0,
+        m_aff[3], m_aff[4], m_aff[5], 0,
+        m_aff[6], m_aff[7], m_aff[8], 0,
+        m_aff[9], m_aff[10], m_aff[11], 1 }}};
+}
+
+// Insertion operator for the affine3x4 class
+std::ostream& operator<<(std::ostream& out, const affine3x4& a) {
+    out << "[ ";
+    for (auto i = 0u; i < 12; i += 3) {
+        out << ScalarFmt() << a.m_aff[i] << "  "
+            << ScalarFmt() << a.m_aff[i + 1] << "  "
+            << ScalarFmt() << a.m_aff[i + 2] << (i < 9 ? "\n  " : " ]");
+    }
+    return out;
+}
+
+// (Approximately) Compare two transforms for equality
+bool operator==(const affine3x4& lhs, const affine3x4& rhs) {
+    for (auto i = 0u; i < 12; ++i) {
+        if (!nearly_equal(lhs.m_aff[i], rhs.m_aff[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+bool operator!=(const affine3x4& lhs, const affine3x4& rhs) { return !operator==(lhs,rhs); }
+
+// Compose two transforms
+affine3x4 operator*(const affine3x4& lhs, const affine3x4& rhs) {
+    return lhs.clone().mul(rhs);
+}
@@ -0,0 +1,90 @@
+
+#ifndef _AFFINE3X4_H_
+#define _AFFINE3X4_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "matrix4.h"
+
+#include <iosfwd>
+#include <array>
+
+using aff_array = std::array<scalar, 12>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines an affine transform (rotation, scale and
+/// translation) with the same conventions as matrix4, but without the
+/// constant (0, 0, 0, 1) column. Each group of three values is the first
+/// three values of the matching matrix4 row, so the last group is the
+/// translation.
+///
+class affine3x4
+{
+public:
+    aff_array m_aff;
+
+public: // Constructors ---------------------------------------------
+
+    affine3x4()
+        : m_aff {{
+            1, 0, 0,
+            0, 1, 0,
+            0, 0, 1,
+            0, 0, 0 }}
+    {}
+
+    affine3x4(const aff_array& aff)
+        : m_aff(aff)
+    {}
+
+    // Drop the constant column of an affine matrix4
+    explicit affine3x4(const matrix4& m)
+        : m_aff {{
+            m.m_mat[0], m.m_mat[1], m.m_mat[2],
+            m.m_mat[4], m.m_mat[5], m.m_mat[6],
+            m.m_mat[8], m.m_mat[9], m.m_mat[10],
+            m.m_mat[12], m.m_mat[13], m.m_mat[14] }}
+    {}
+
+    affine3x4 clone() const {
+        return {*this};
+    }
+
+public: // Interface methods ----------------------------------------
+
+    // Set to the identity transform
+    affine3x4& id();
+
+    // Multiply this transform (this is applied first, then other)
+    affine3x4& mul(const affine3x4& other);
+    affine3x4& operator*=(const affine3x4& other);
+
+    // Invert this transform
+    affine3x4& invert();
+
+    // Invert this transform assuming it is a rotation and translation
+    affine3x4& invert_rigid();
+
+public: // Information interface mthods -----------------------------
+
+    // Return the translation part of this transform
+    vector3 translation() const;
+
+    // Return a point transformed by this transform
+    vector3 transform_point(const vector3& p) const;
+
+    // Return a direction transformed by this transform (no translation)
+    vector3 transform_vector(const vector3& v) const;
+
+    // Return the full matrix4 (e.g. to upload as a uniform)
+    matrix4 to_matrix4() const;
+
+};
+
+// Perform typical algebraic operations on transforms
+std::ostream& operator<<(std::ostream& out, const affine3x4& a);
+bool operator==(const affine3x4& lhs, const affine3x4& rhs);
+bool operator!=(const affine3x4& lhs, const affine3x4& rhs);
+affine3x4 operator*(const affine3x4& lhs, const affine3x4& rhs);
+
+#endif
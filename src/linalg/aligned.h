@@ -0,0 +1,74 @@
+
+#ifndef _ALIGNED_H_
+#define _ALIGNED_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+//------------------------------------------------------------------------------
+/// @brief      A standard allocator that returns memory aligned to Align
+/// bytes (a power of two). Before C++17 std::allocator ignores alignments
+/// larger than that of std::max_align_t, so containers feeding SIMD kernels
+/// or GPU uploads use this allocator instead.
+///
+template <typename T, std::size_t Align>
+class aligned_allocator
+{
+    static_assert(Align >= alignof(void*) && (Align & (Align - 1)) == 0,
+        "The alignment must be a power of two of at least pointer size");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    aligned_allocator() = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) {}
+
+    // Over-allocate, align, and keep the original pointer just before the
+    // aligned block so it can be freed
+    T* allocate(std::size_t n) {
+        static_assert(Align >= alignof(T), "The alignment is less than that of the type");
+        auto bytes = n * sizeof(T) + Align + sizeof(void*);
+        auto raw = std::malloc(bytes);
+        if (raw == nullptr) {
+            throw std::bad_alloc();
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        addr = (addr + Align - 1) & ~static_cast<std::uintptr_t>(Align - 1);
+        reinterpret_cast<void**>(addr)[-1] = raw;
+        return reinterpret_cast<T*>(addr);
+    }
+
+    void deallocate(T* p, std::size_t) {
+        if (p != nullptr) {
+            std::free(reinterpret_cast<void**>(p)[-1]);
+        }
+    }
+};
+
+template <typename T, typename U, std::size_t Align>
+bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) {
+    return true;
+}
+
+template <typename T, typename U, std::size_t Align>
+bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) {
+    return false;
+}
+
+// A vector whose storage starts on an Align-byte boundary (by default a
+// cache line, so an aligned_vector<matrix4> has one matrix per line)
+template <typename T, std::size_t Align = 64>
+using aligned_vector = std::vector<T, aligned_allocator<T, Align>>;
+
+#endif
@@ -0,0 +1,123 @@
+
+#include "cached_matrix4.h"
+
+
+//------------------------------------------------------------------------------
+/// @brief      Replace the transform
+///
+/// @param[in]  mat   The new transform
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::set(const matrix4& mat) {
+    m_mat = mat;
+    m_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set to the identity matrix
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::id() {
+    m_mat.id();
+    m_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply the transform (see matrix4::mul)
+///
+/// @param[in]  other  The other matrix
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::mul(const matrix4& other) {
+    m_mat.mul(other);
+    m_dirty = true;
+    return *this;
+}
+cached_matrix4& cached_matrix4::operator*=(const matrix4& other) {
+    return mul(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Scale the transform (see matrix4::scale)
+///
+/// @param[in]  s     The scaling factor
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::scale(scalar s) {
+    m_mat.scale(s);
+    m_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Rotate the transform (see matrix4::rotate)
+///
+/// @param[in]  rads  The angle to rotate by (in radians)
+/// @param[in]  axis  The axis to rotate around
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::rotate(scalar rads, vector3 axis) {
+    m_mat.rotate(rads, axis);
+    m_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reset the hit and miss counts
+///
+/// @return     the updated transform
+///
+cached_matrix4& cached_matrix4::reset_stats() {
+    m_stats = cache_stats();
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the inverse of the transform. As with matrix4::invert,
+/// a singular transform is returned unchanged.
+///
+/// @return     the (cached) inverse
+///
+const matrix4& cached_matrix4::inverse() const {
+    update();
+    return m_inverse;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the 3x3 normal matrix of the transform (the same values
+/// as matrix4::set_as_normal)
+///
+/// @return     the (cached) normal matrix
+///
+const normal_array& cached_matrix4::normal() const {
+    update();
+    return m_normal;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Recompute the inverse and normal matrix if the transform has
+/// changed. The normal matrix is the transposed upper 3x3 of the inverse,
+/// so both come from a single inversion.
+///
+void cached_matrix4::update() const {
+    if (!m_dirty) {
+        ++m_stats.m_hits;
+        return;
+    }
+    ++m_stats.m_misses;
+
+    m_inverse = m_mat.clone().invert();
+    for (auto i = 0u; i < 3; ++i) {
+        for (auto j = 0u; j < 3; ++j) {
+            m_normal[3 * i + j] = m_inverse.m_mat[4 * j + i];
+        }
+    }
+    m_dirty = false;
+}
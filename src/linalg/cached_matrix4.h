@@ -0,0 +1,113 @@
+
+#ifndef _CACHED_MATRIX4_H_
+#define _CACHED_MATRIX4_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "matrix4.h"
+
+#include <array>
+#include <cstddef>
+
+using normal_array = std::array<scalar, 9>;
+
+//------------------------------------------------------------------------------
+/// @brief      Cache hit and miss counts (a hit is a request answered without
+/// recomputing anything)
+///
+struct cache_stats
+{
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+
+    // Return the fraction of requests that were hits (0 with no requests)
+    double hit_rate() const {
+        auto total = m_hits + m_misses;
+        return total == 0 ? 0 : static_cast<double>(m_hits) / static_cast<double>(total);
+    }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      This class wraps a matrix4 transform and caches its inverse and
+/// its 3x3 normal matrix (see matrix4::set_as_normal). Both are computed on
+/// first use and kept until the transform is changed through one of the
+/// mutating methods, so static objects pay for one inversion instead of one
+/// per frame. The matrix itself is only reachable as a const reference so
+/// that every change goes through this class.
+///
+class cached_matrix4
+{
+    matrix4 m_mat;
+
+    // The cached values (valid while m_dirty is false)
+    mutable matrix4 m_inverse;
+    mutable normal_array m_normal;
+    mutable bool m_dirty;
+    mutable cache_stats m_stats;
+
+public: // Constructors ---------------------------------------------
+
+    cached_matrix4()
+        : m_mat()
+        , m_inverse()
+        , m_normal{{1, 0, 0, 0, 1, 0, 0, 0, 1}}
+        , m_dirty(false)
+        , m_stats()
+    {}
+
+    cached_matrix4(const matrix4& mat)
+        : m_mat(mat)
+        , m_inverse()
+        , m_normal()
+        , m_dirty(true)
+        , m_stats()
+    {}
+
+    cached_matrix4 clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    const matrix4& matrix() const { return m_mat; }
+
+public: // Mutating interface methods -------------------------------
+
+    // Replace the transform
+    cached_matrix4& set(const matrix4& mat);
+
+    // Set to the identiy matrix
+    cached_matrix4& id();
+
+    // Multiply the transform
+    cached_matrix4& mul(const matrix4& other);
+    cached_matrix4& operator*=(const matrix4& other);
+
+    // Scale the transform
+    cached_matrix4& scale(scalar s);
+
+    // Rotate the transform
+    cached_matrix4& rotate(scalar rads, vector3 axis);
+
+    // Reset the hit and miss counts
+    cached_matrix4& reset_stats();
+
+public: // Information interface mthods -----------------------------
+
+    // Return the inverse of the transform (cached)
+    const matrix4& inverse() const;
+
+    // Return the 3x3 normal matrix of the transform (cached)
+    const normal_array& normal() const;
+
+    // Return the hit and miss counts of the cache
+    const cache_stats& stats() const { return m_stats; }
+
+private:
+
+    // Recompute the cached values if needed and count the request
+    void update() const;
+
+};
+
+#endif
@@ -0,0 +1,204 @@
+
+#ifndef _CX_H_
+#define _CX_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "matrix4.h"
+
+#include <cstddef>
+#include <utility>
+
+//------------------------------------------------------------------------------
+/// @brief      Compile-time (constexpr) versions of the linalg operations.
+///
+/// The member functions of vector3 and matrix4 mutate their std::array
+/// storage, which C++14 does not allow in a constant expression, and they use
+/// the SIMD backend at runtime. These free functions build new values
+/// instead so fixed transforms can be baked into the binary:
+///
+///     constexpr auto proj = cx::perspective(0.785f, 4.f / 3, 0.1f, 100);
+///     constexpr auto view = cx::look_at({0, 0, 5}, {0, 0, 0}, {0, 1, 0});
+///     constexpr auto view_proj = cx::mul(view, proj);
+///
+/// They give the same results as the member functions up to rounding, and
+/// they can also be called at runtime.
+///
+namespace cx
+{
+
+constexpr double pi = 3.14159265358979323846;
+
+
+//------------------------------------------------------------------------------
+/// @brief      A square root that can be evaluated at compile time (Newton's
+/// method started above the root, so it decreases until it converges)
+///
+/// @param[in]  x     The value (non-positive values return 0)
+///
+/// @return     the square root of x
+///
+constexpr double sqrt(double x) {
+    if (!(x > 0)) {
+        return 0;
+    }
+    auto r = x > 1 ? x : 1.0;
+    while (true) {
+        auto next = 0.5 * (r + x / r);
+        if (!(next < r)) {
+            return r;
+        }
+        r = next;
+    }
+}
+
+// Reduce an angle to [-pi, pi]
+constexpr double reduce_angle(double rads) {
+    auto turns = rads / (2 * pi);
+    auto k = static_cast<long long>(turns >= 0 ? turns + 0.5 : turns - 0.5);
+    return rads - static_cast<double>(k) * 2 * pi;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      A sine that can be evaluated at compile time (Taylor series
+/// on the reduced angle, accurate to about 1e-12 for |rads| < 1e6)
+///
+constexpr double sin(double rads) {
+    auto x = reduce_angle(rads);
+    auto term = x, sum = x;
+    for (auto n = 1; n < 16; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      A cosine that can be evaluated at compile time (Taylor series
+/// on the reduced angle, accurate to about 1e-12 for |rads| < 1e6)
+///
+constexpr double cos(double rads) {
+    auto x = reduce_angle(rads);
+    auto term = 1.0, sum = 1.0;
+    for (auto n = 1; n < 16; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// A tangent that can be evaluated at compile time
+constexpr double tan(double rads) {
+    return sin(rads) / cos(rads);
+}
+
+
+// Return the dot product of two vectors
+constexpr scalar dot(const vector3& a, const vector3& b) {
+    return a.x() * b.x() + a.y() * b.y() + a.z() * b.z();
+}
+
+// Return the cross product of two vectors
+constexpr vector3 cross(const vector3& a, const vector3& b) {
+    return {a.y() * b.z() - a.z() * b.y(),
+            a.z() * b.x() - a.x() * b.z(),
+            a.x() * b.y() - a.y() * b.x()};
+}
+
+// Return the length of a vector
+constexpr scalar len(const vector3& v) {
+    return static_cast<scalar>(sqrt(dot(v, v)));
+}
+
+// Return a normalized copy of a vector (zero vectors are returned as is)
+constexpr vector3 normalize(const vector3& v) {
+    auto len_squared = dot(v, v);
+    return len_squared > 0
+        ? vector3(v * static_cast<scalar>(1 / sqrt(len_squared)))
+        : v;
+}
+
+
+// Copy 16 values into a mat_array
+template <std::size_t... I>
+constexpr mat_array to_mat_array(const scalar (&vals)[16], std::index_sequence<I...>) {
+    return {{vals[I]...}};
+}
+
+// Return the identity matrix
+constexpr matrix4 id() {
+    return {};
+}
+
+// Return the product of two matrices (the same as a.clone().mul(b))
+constexpr matrix4 mul(const matrix4& a, const matrix4& b) {
+    scalar vals[16] = {};
+    for (auto r = 0u; r < 4; ++r) {
+        for (auto c = 0u; c < 4; ++c) {
+            for (auto k = 0u; k < 4; ++k) {
+                vals[4 * r + c] += a.m_mat[4 * r + k] * b.m_mat[4 * k + c];
+            }
+        }
+    }
+    return {to_mat_array(vals, std::make_index_sequence<16>{})};
+}
+
+// Return the transpose of a matrix
+constexpr matrix4 transpose(const matrix4& m) {
+    scalar vals[16] = {};
+    for (auto r = 0u; r < 4; ++r) {
+        for (auto c = 0u; c < 4; ++c) {
+            vals[4 * c + r] = m.m_mat[4 * r + c];
+        }
+    }
+    return {to_mat_array(vals, std::make_index_sequence<16>{})};
+}
+
+// Return the matrix m rotated about an axis (the same as m.clone().rotate())
+constexpr matrix4 rotate(const matrix4& m, scalar rads, const vector3& axis) {
+    if (!(dot(axis, axis) > 0)) {
+        return m;
+    }
+    const auto n = normalize(axis);
+    auto x = n.x(), y = n.y(), z = n.z();
+    auto c = static_cast<scalar>(cos(rads)),
+         s = static_cast<scalar>(sin(rads)),
+         t = 1 - c;
+
+    // The rotation applied to the first three rows of m
+    matrix4 rot(mat_array{{
+        x * x * t + c,     y * x * t + z * s, z * x * t - y * s, 0,
+        x * y * t - z * s, y * y * t + c,     z * y * t + x * s, 0,
+        x * z * t + y * s, y * z * t - x * s, z * z * t + c,     0,
+        0,                 0,                 0,                 1 }});
+    return mul(rot, m);
+}
+
+// Return a "look at" matrix (the same as matrix4().look_at())
+constexpr matrix4 look_at(const vector3& eye, const vector3& target, const vector3& up) {
+    const auto zaxis = normalize(target - eye),
+               xaxis = normalize(cross(up, zaxis)),
+               yaxis = normalize(cross(zaxis, xaxis));
+
+    return {mat_array{{
+        xaxis.x(), yaxis.x(), zaxis.x(), 0,
+        xaxis.y(), yaxis.y(), zaxis.y(), 0,
+        xaxis.z(), yaxis.z(), zaxis.z(), 0,
+        -dot(xaxis, eye), -dot(yaxis, eye), -dot(zaxis, eye), 1 }}};
+}
+
+// Return a perspective matrix (the same as matrix4().perspective())
+constexpr matrix4 perspective(scalar fovy, scalar aspect, scalar near, scalar far) {
+    auto f = static_cast<scalar>(1 / tan(fovy / 2.0)),
+         depth_inv = 1 / (near - far);
+
+    return {mat_array{{
+        f / aspect, 0, 0,                          0,
+        0,          f, 0,                          0,
+        0,          0, (near + far) * depth_inv,   -1,
+        0,          0, near * far * depth_inv * 2, 0 }}};
+}
+
+} // namespace cx
+
+#endif
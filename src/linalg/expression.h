@@ -0,0 +1,147 @@
+
+#ifndef _EXPRESSION_H_
+#define _EXPRESSION_H_
+
+#include "linalg.h"
+
+#include <cstddef>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+//------------------------------------------------------------------------------
+/// @brief      The base of all lazily evaluated element-wise expressions. E is
+/// the concrete expression type and N is the number of elements, so vector
+/// and matrix expressions can never be mixed.
+///
+/// The element-wise operators (+, - and scaling) build a tree of these
+/// expressions instead of a temporary for every sub-expression. The tree is
+/// evaluated in a single loop when it is assigned to a vector3 or matrix4.
+///
+/// Expressions are constexpr, so constant vectors and matrices can be built
+/// from them at compile time. Every expression has the value_type of its
+/// leaves, and the leaves of one expression must share it (convert between
+/// float and double explicitly).
+///
+/// As with any expression template, do not keep an expression (e.g. with
+/// auto) that refers to a temporary vector3 or matrix4.
+///
+template <typename E, std::size_t N>
+class linalg_expr
+{
+public:
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief      How an expression stores its operands. Expressions are held by
+/// value (they are small and often temporaries), while the leaf types
+/// specialize this to be held by reference.
+///
+template <typename E>
+struct expr_traits
+{
+    using operand = E;
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief      The element-wise sum of two expressions
+///
+template <typename L, typename R, std::size_t N>
+class expr_sum : public linalg_expr<expr_sum<L, R, N>, N>
+{
+    typename expr_traits<L>::operand m_lhs;
+    typename expr_traits<R>::operand m_rhs;
+
+public:
+    using value_type = typename L::value_type;
+    static_assert(std::is_same<value_type, typename R::value_type>::value,
+        "Both sides of an expression must have the same precision");
+
+    constexpr expr_sum(const L& lhs, const R& rhs)
+        : m_lhs(lhs)
+        , m_rhs(rhs)
+    {}
+
+    constexpr value_type operator[](std::size_t i) const { return m_lhs[i] + m_rhs[i]; }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The element-wise difference of two expressions
+///
+template <typename L, typename R, std::size_t N>
+class expr_diff : public linalg_expr<expr_diff<L, R, N>, N>
+{
+    typename expr_traits<L>::operand m_lhs;
+    typename expr_traits<R>::operand m_rhs;
+
+public:
+    using value_type = typename L::value_type;
+    static_assert(std::is_same<value_type, typename R::value_type>::value,
+        "Both sides of an expression must have the same precision");
+
+    constexpr expr_diff(const L& lhs, const R& rhs)
+        : m_lhs(lhs)
+        , m_rhs(rhs)
+    {}
+
+    constexpr value_type operator[](std::size_t i) const { return m_lhs[i] - m_rhs[i]; }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      An expression scaled by a value of the same precision
+///
+template <typename E, std::size_t N>
+class expr_scale : public linalg_expr<expr_scale<E, N>, N>
+{
+public:
+    using value_type = typename E::value_type;
+
+private:
+    typename expr_traits<E>::operand m_expr;
+    value_type m_s;
+
+public:
+    constexpr expr_scale(const E& e, value_type s)
+        : m_expr(e)
+        , m_s(s)
+    {}
+
+    constexpr value_type operator[](std::size_t i) const { return m_expr[i] * m_s; }
+};
+
+
+// Evaluate every element of an expression into an array
+template <typename E, std::size_t... I>
+constexpr std::array<typename E::value_type, sizeof...(I)> expr_eval(const E& e,
+    std::index_sequence<I...>)
+{
+    return {{e[I]...}};
+}
+
+
+// Build expressions from the typical algebraic operators
+template <typename L, typename R, std::size_t N>
+constexpr expr_sum<L, R, N> operator+(const linalg_expr<L, N>& lhs, const linalg_expr<R, N>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+template <typename L, typename R, std::size_t N>
+constexpr expr_diff<L, R, N> operator-(const linalg_expr<L, N>& lhs, const linalg_expr<R, N>& rhs) {
+    return {lhs.self(), rhs.self()};
+}
+
+// (the scale factor is converted to the precision of the expression)
+template <typename E, std::size_t N>
+constexpr expr_scale<E, N> operator*(const linalg_expr<E, N>& lhs, typename E::value_type rhs) {
+    return {lhs.self(), rhs};
+}
+
+template <typename E, std::size_t N>
+constexpr expr_scale<E, N> operator*(typename E::value_type lhs, const linalg_expr<E, N>& rhs) {
+    return {rhs.self(), lhs};
+}
+
+#endif
@@ -0,0 +1,108 @@
+
+#ifndef _FAST_MATH_H_
+#define _FAST_MATH_H_
+
+#include "linalg.h"
+#include "simd.h"
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Approximations of the libm functions used by the linalg classes. They are
+// inline, compute sine and cosine together, and only branch to fall back on
+// libm for large angles. The float versions have these maximum errors
+// (checked by the unit tests):
+//
+//   fast_rsqrt   relative error < 5e-7 with SSE, < 5e-6 otherwise (for any
+//                positive normal float)
+//   fast_sincos  absolute error < 2e-7 (angles past 8192 radians, where the
+//                range reduction would lose accuracy, and NaNs use libm)
+//   fast_tan     relative error < 1e-6 for |x| <= 1.5
+//
+// The double versions call libm, so matrix4d and vector3d stay exact.
+//
+// The methods that use these take the fast_math tag, e.g.
+// v.normalize(fast_math). Configure with -DLINALG_FAST_MATH=ON to make the
+// fast versions the default.
+//
+
+// Tag selecting the approximate version of a method
+struct fast_math_t {};
+constexpr fast_math_t fast_math {};
+
+//------------------------------------------------------------------------------
+/// @brief      Return an approximation of 1 / sqrt(x) for x > 0. The SSE
+/// estimate is refined with one Newton step; other targets start from the
+/// bit-level estimate and take two.
+///
+inline float fast_rsqrt(float x)
+{
+#if defined(LINALG_SIMD_SSE)
+    auto y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    std::uint32_t i;
+    std::memcpy(&i, &x, sizeof(i));
+    i = 0x5f375a86u - (i >> 1);
+    float y;
+    std::memcpy(&y, &i, sizeof(y));
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y * (1.5f - 0.5f * x * y * y);
+#endif
+}
+
+inline double fast_rsqrt(double x) {
+    return 1 / std::sqrt(x);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set s and c to approximations of sin(x) and cos(x). The angle
+/// is reduced to [-pi/4, pi/4] around the nearest multiple of pi/2 (with a
+/// three-part pi/2 so the reduction is exact for moderate angles), and both
+/// are evaluated with minimax polynomials. Angles past 8192 radians and NaNs
+/// use libm, which also keeps the conversion to an integer quadrant defined.
+///
+inline void fast_sincos(float x, float& s, float& c)
+{
+    if (!(std::abs(x) <= 8192)) {
+        s = std::sin(x);
+        c = std::cos(x);
+        return;
+    }
+
+    auto q = static_cast<std::int32_t>(x * 0.636619772f + (x < 0 ? -0.5f : 0.5f));
+    auto k = static_cast<float>(q);
+    auto r = ((x - k * 1.5703125f) - k * 4.83751297e-4f) - k * 7.54978995e-8f;
+    auto r2 = r * r;
+
+    auto ps = r + r * r2 * (-1.66666546e-1f + r2 * (8.33216087e-3f + r2 * -1.95152959e-4f));
+    auto pc = 1 - 0.5f * r2
+        + r2 * r2 * (4.16666457e-2f + r2 * (-1.38873163e-3f + r2 * 2.44331571e-5f));
+
+    // Rotate the result into the quadrant of x
+    auto swap = (q & 1) != 0;
+    auto sin_r = swap ? pc : ps,
+         cos_r = swap ? ps : pc;
+    s = (q & 2) != 0 ? -sin_r : sin_r;
+    c = ((q + 1) & 2) != 0 ? -cos_r : cos_r;
+}
+
+inline void fast_sincos(double x, double& s, double& c) {
+    s = std::sin(x);
+    c = std::cos(x);
+}
+
+// Return an approximation of tan(x) (from fast_sincos)
+inline float fast_tan(float x) {
+    float s, c;
+    fast_sincos(x, s, c);
+    return s / c;
+}
+
+inline double fast_tan(double x) {
+    return std::tan(x);
+}
+
+#endif
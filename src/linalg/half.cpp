@@ -0,0 +1,167 @@
+
+#include "half.h"
+
+#include <cstring>
+
+#if defined(__F16C__) && !defined(LINALG_NO_SIMD)
+#   include <immintrin.h>
+#   define LINALG_F16C
+#endif
+
+static_assert(sizeof(half) == 2 && sizeof(vector3h) == 6,
+    "Arrays of half and vector3h are packed 16-bit values");
+
+static_assert(sizeof(vector3) == 3 * sizeof(float),
+    "Arrays of vector3 are packed floats");
+
+
+//------------------------------------------------------------------------------
+/// @brief      Convert a float to the bits of the nearest half (ties go to
+/// the even half). Values too large for a half become infinities, and
+/// values too small become denormals or zero.
+///
+/// @param[in]  f     The value to convert
+///
+/// @return     the bits of the half
+///
+std::uint16_t float_to_half(float f)
+{
+    std::uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+
+    auto sign = static_cast<std::uint16_t>((x >> 16) & 0x8000u);
+    auto mag = x & 0x7fffffffu;
+
+    // Infinity and NaN (NaNs stay quiet NaNs)
+    if (mag >= 0x7f800000u) {
+        auto nan = mag > 0x7f800000u ? 0x0200u | ((mag >> 13) & 0x03ffu) : 0u;
+        return static_cast<std::uint16_t>(sign | 0x7c00u | nan);
+    }
+
+    // Rounds to 65520 or more, which is past the largest half
+    if (mag >= 0x477ff000u) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+
+    // Normal halves: rebias the exponent and round away the low 13 bits
+    if (mag >= 0x38800000u) {
+        mag += 0x0fffu + ((mag >> 13) & 1u);
+        return static_cast<std::uint16_t>(sign | ((mag - 0x38000000u) >> 13));
+    }
+
+    // Half denormals (2^-25 and smaller round to zero)
+    if (mag <= 0x33000000u) {
+        return sign;
+    }
+    auto mantissa = (mag & 0x007fffffu) | 0x00800000u;
+    auto shift = 126u - (mag >> 23);
+    auto bits = mantissa >> shift,
+         rest = mantissa & ((1u << shift) - 1u),
+         halfway = 1u << (shift - 1u);
+    if (rest > halfway || (rest == halfway && (bits & 1u))) {
+        ++bits;
+    }
+    return static_cast<std::uint16_t>(sign | bits);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert the bits of a half to a float (this is exact)
+///
+/// @param[in]  h     The bits of the half
+///
+/// @return     the value of the half
+///
+float half_to_float(std::uint16_t h)
+{
+    auto sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+    auto exponent = (h >> 10) & 0x1fu;
+    auto mantissa = static_cast<std::uint32_t>(h & 0x03ffu);
+
+    std::uint32_t x;
+    if (exponent == 0x1fu) {
+        x = sign | 0x7f800000u | (mantissa << 13);
+    }
+    else if (exponent != 0) {
+        x = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0) {
+        x = sign;
+    }
+    else {
+        // Normalize the denormal
+        auto e = 113u;
+        while ((mantissa & 0x0400u) == 0) {
+            mantissa <<= 1;
+            --e;
+        }
+        x = sign | (e << 23) | ((mantissa & 0x03ffu) << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert an array of floats to halves
+///
+/// @param[in]  in     The values
+/// @param[out] out    The halves
+/// @param[in]  count  The number of values
+///
+void to_half(const float* in, half* out, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(LINALG_F16C)
+    for (; i + 4 <= count; i += 4) {
+        auto h = _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), h);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = half(in[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert an array of halves to floats
+///
+/// @param[in]  in     The halves
+/// @param[out] out    The values
+/// @param[in]  count  The number of values
+///
+void from_half(const half* in, float* out, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(LINALG_F16C)
+    for (; i + 4 <= count; i += 4) {
+        auto h = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, _mm_cvtph_ps(h));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = in[i].to_float();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert an array of vectors to half precision
+///
+/// @param[in]  in     The vectors
+/// @param[out] out    The half vectors
+/// @param[in]  count  The number of vectors
+///
+void to_half(const vector3* in, vector3h* out, std::size_t count) {
+    to_half(reinterpret_cast<const float*>(in), reinterpret_cast<half*>(out), 3 * count);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert an array of half vectors to full precision
+///
+/// @param[in]  in     The half vectors
+/// @param[out] out    The vectors
+/// @param[in]  count  The number of vectors
+///
+void from_half(const vector3h* in, vector3* out, std::size_t count) {
+    from_half(reinterpret_cast<const half*>(in), reinterpret_cast<float*>(out), 3 * count);
+}
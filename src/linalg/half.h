@@ -0,0 +1,87 @@
+
+#ifndef _HALF_H_
+#define _HALF_H_
+
+#include "linalg.h"
+#include "vector3.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Convert between float values and the bits of an IEEE 754 half (rounding
+// to the nearest even half; infinities, NaNs and denormals are kept)
+std::uint16_t float_to_half(float f);
+float half_to_float(std::uint16_t h);
+
+//------------------------------------------------------------------------------
+/// @brief      A 16-bit floating-point value. This is a storage type only
+/// (e.g. for vertex data and animation tracks sent to the GPU as half
+/// floats): there is no arithmetic, values are converted to float to be
+/// used. It has about three decimal digits and a range of +-65504.
+///
+class half
+{
+public:
+    std::uint16_t m_bits;
+
+public: // Constructors ---------------------------------------------
+
+    constexpr half()
+        : m_bits(0)
+    {}
+
+    explicit half(float f)
+        : m_bits(float_to_half(f))
+    {}
+
+    // Wrap the bits of a half
+    static constexpr half from_bits(std::uint16_t bits) {
+        return half(bits, 0);
+    }
+
+public: // Information interface mthods -----------------------------
+
+    float to_float() const { return half_to_float(m_bits); }
+
+private:
+
+    constexpr half(std::uint16_t bits, int)
+        : m_bits(bits)
+    {}
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A three dimensional vector stored as half floats (6 bytes
+/// instead of 12). Convert it to a vector3 to do any linear algebra.
+///
+class vector3h
+{
+public:
+    std::array<half, 3> m_vec;
+
+public: // Constructors ---------------------------------------------
+
+    vector3h() = default;
+
+    explicit vector3h(const vector3& v)
+        : m_vec{{half(v.x()), half(v.y()), half(v.z())}}
+    {}
+
+public: // Information interface mthods -----------------------------
+
+    // Return the vector at full precision
+    vector3 to_vector3() const {
+        return {m_vec[0].to_float(), m_vec[1].to_float(), m_vec[2].to_float()};
+    }
+};
+
+// Convert contiguous arrays between float and half (with F16C when the
+// compiler targets it, otherwise with float_to_half and half_to_float)
+void to_half(const float* in, half* out, std::size_t count);
+void from_half(const half* in, float* out, std::size_t count);
+
+void to_half(const vector3* in, vector3h* out, std::size_t count);
+void from_half(const vector3h* in, vector3* out, std::size_t count);
+
+#endif
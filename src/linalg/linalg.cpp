@@ -10,6 +10,9 @@
 bool s_equal(scalar a, scalar b) {
     return a >= b && a <= b;
 }
+static bool s_equal(double a, double b) {
+    return a >= b && a <= b;
+}
 
 //------------------------------------------------------------------------------
 /// @brief      Floating-point comparison from:
@@ -21,11 +24,12 @@ bool s_equal(scalar a, scalar b) {
 ///
 /// @return     true is they are close enough
 ///
-bool nearly_equal(scalar a, scalar b, scalar epsilon)
+template <typename T>
+static bool nearly_equal_impl(T a, T b, T epsilon)
 {
-    scalar abs_a = std::abs(a);
-    scalar abs_b = std::abs(b);
-    scalar diff  = std::abs(a - b);
+    T abs_a = std::abs(a);
+    T abs_b = std::abs(b);
+    T diff  = std::abs(a - b);
 
     // shortcut, handles infinities
     if (s_equal(a, b)) {
@@ -35,17 +39,30 @@ bool nearly_equal(scalar a, scalar b, scalar epsilon)
     // if a or b is zero (or if both are extremely close to it)
     // relative error is less meaningful
     // --> std::numeric_limits<float>::min() <==> Float.MIN_NORMAL
-    else if (s_equal(a, 0) || s_equal(b, 0) || diff < std::numeric_limits<scalar>::min()) {
-        return diff < (epsilon * std::numeric_limits<scalar>::min());
+    // --> the product is a denormal, which is very slow to compute on most
+    //     CPUs, so it is skipped when diff is too large for it to matter
+    else if (s_equal(a, T(0)) || s_equal(b, T(0)) || diff < std::numeric_limits<T>::min()) {
+        if (diff >= std::numeric_limits<T>::min() && epsilon <= 1) {
+            return false;
+        }
+        return diff < (epsilon * std::numeric_limits<T>::min());
     }
 
     // use relative error
     // --> std::numeric_limits<float>::max() <==> Float.MAX_VALUE
     else {
-        return diff / std::min((abs_a+abs_b), std::numeric_limits<scalar>::max()) < epsilon;
+        return diff / std::min((abs_a+abs_b), std::numeric_limits<T>::max()) < epsilon;
     }
 }
 
+bool nearly_equal(scalar a, scalar b, scalar epsilon) {
+    return nearly_equal_impl(a, b, epsilon);
+}
+
+bool nearly_equal(double a, double b, double epsilon) {
+    return nearly_equal_impl(a, b, epsilon);
+}
+
 // Insertion operator for the helper formatting class
 std::ostream& operator<<(std::ostream& dest, ScalarFmt const& fmt) {
     dest.setf(std::ios_base::fixed, std::ios_base::floatfield);
@@ -32,4 +32,15 @@ bool s_equal(scalar a, scalar b);
 // Floating-point comparison from:
 bool nearly_equal(scalar a, scalar b, scalar epsilon=0.00001f);
 
+// The same comparison for double precision (the tolerance is required so
+// that calls with float values never pick this overload by accident)
+bool nearly_equal(double a, double b, double epsilon);
+
+// The default comparison tolerance of each precision
+template <typename T>
+constexpr T default_epsilon() { return static_cast<T>(0.00001); }
+
+template <>
+constexpr double default_epsilon<double>() { return 1e-12; }
+
 #endif
@@ -1,8 +1,445 @@
 
 #include "matrix4.h"
+#include "simd.h"
+#include "parallel.h"
 
 #include <iostream>
 #include <cmath>
+#include <limits>
+#include <utility>
+
+
+// The arithmetic of the matrix class is written as kernels over the 16
+// values. The templates below work at any precision, and when SIMD is
+// enabled there are float overloads of the same kernels, which overload
+// resolution picks over the templates (so matrix4 gets the SIMD code and
+// matrix4d the portable code, chosen at compile time).
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply the matrix a by the matrix b. The values of b are
+/// copied before any are written, so out may alias a or b.
+///
+template <typename T>
+static inline void mul_values(const T* a, const T* b, T* out)
+{
+    auto m00 = b[0], m01 = b[1], m02 = b[2], m03 = b[3],
+         m10 = b[4], m11 = b[5], m12 = b[6], m13 = b[7],
+         m20 = b[8], m21 = b[9], m22 = b[10], m23 = b[11],
+         m30 = b[12], m31 = b[13], m32 = b[14], m33 = b[15];
+
+    for (auto i = 0u; i < 16; i += 4) {
+        auto b0 = a[i], b1 = a[i + 1], b2 = a[i + 2], b3 = a[i + 3];
+        out[i] = b0 * m00 + b1 * m10 + b2 * m20 + b3 * m30;
+        out[i + 1] = b0 * m01 + b1 * m11 + b2 * m21 + b3 * m31;
+        out[i + 2] = b0 * m02 + b1 * m12 + b2 * m22 + b3 * m32;
+        out[i + 3] = b0 * m03 + b1 * m13 + b2 * m23 + b3 * m33;
+    }
+}
+
+// Element-wise a += b, a -= b and a *= s
+template <typename T>
+static inline void add_values(T* a, const T* b) {
+    for (auto i = 0u; i < 16; ++i) {
+        a[i] += b[i];
+    }
+}
+
+template <typename T>
+static inline void sub_values(T* a, const T* b) {
+    for (auto i = 0u; i < 16; ++i) {
+        a[i] -= b[i];
+    }
+}
+
+template <typename T>
+static inline void scale_values(T* a, T s) {
+    for (auto i = 0u; i < 16; ++i) {
+        a[i] *= s;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply the upper three rows of a by the 3x3 rotation b
+/// (b[3 * i + j] is row i, column j)
+///
+template <typename T>
+static inline void rotate_values(T* a, const T* b)
+{
+    auto a00 = a[0], a01 = a[1], a02 = a[2], a03 = a[3],
+         a10 = a[4], a11 = a[5], a12 = a[6], a13 = a[7],
+         a20 = a[8], a21 = a[9], a22 = a[10], a23 = a[11];
+
+    a[0] = a00 * b[0] + a10 * b[1] + a20 * b[2];
+    a[1] = a01 * b[0] + a11 * b[1] + a21 * b[2];
+    a[2] = a02 * b[0] + a12 * b[1] + a22 * b[2];
+    a[3] = a03 * b[0] + a13 * b[1] + a23 * b[2];
+    a[4] = a00 * b[3] + a10 * b[4] + a20 * b[5];
+    a[5] = a01 * b[3] + a11 * b[4] + a21 * b[5];
+    a[6] = a02 * b[3] + a12 * b[4] + a22 * b[5];
+    a[7] = a03 * b[3] + a13 * b[4] + a23 * b[5];
+    a[8] = a00 * b[6] + a10 * b[7] + a20 * b[8];
+    a[9] = a01 * b[6] + a11 * b[7] + a21 * b[8];
+    a[10] = a02 * b[6] + a12 * b[7] + a22 * b[8];
+    a[11] = a03 * b[6] + a13 * b[7] + a23 * b[8];
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert the matrix m with the 2x2 determinants of its rows
+///
+/// @param[in]  m     The 16 values of the matrix to invert (may alias out)
+/// @param[out] out   The inverse (unchanged if m is singular)
+///
+/// @return     false if the matrix is singular
+///
+template <typename T>
+static bool invert_values(const T* m, T* out)
+{
+    auto a00 = m[0], a01 = m[1], a02 = m[2], a03 = m[3],
+         a10 = m[4], a11 = m[5], a12 = m[6], a13 = m[7],
+         a20 = m[8], a21 = m[9], a22 = m[10], a23 = m[11],
+         a30 = m[12], a31 = m[13], a32 = m[14], a33 = m[15];
+
+    auto b00 = a00 * a11 - a01 * a10,
+         b01 = a00 * a12 - a02 * a10,
+         b02 = a00 * a13 - a03 * a10,
+         b03 = a01 * a12 - a02 * a11,
+         b04 = a01 * a13 - a03 * a11,
+         b05 = a02 * a13 - a03 * a12,
+         b06 = a20 * a31 - a21 * a30,
+         b07 = a20 * a32 - a22 * a30,
+         b08 = a20 * a33 - a23 * a30,
+         b09 = a21 * a32 - a22 * a31,
+         b10 = a21 * a33 - a23 * a31,
+         b11 = a22 * a33 - a23 * a32;
+
+    // Calculate the determinant
+    auto det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
+    if (nearly_equal(det, T(0), default_epsilon<T>())) {
+        return false;
+    }
+    det = static_cast<T>(1.0) / det;
+
+    out[0] = (a11 * b11 - a12 * b10 + a13 * b09) * det;
+    out[1] = (a02 * b10 - a01 * b11 - a03 * b09) * det;
+    out[2] = (a31 * b05 - a32 * b04 + a33 * b03) * det;
+    out[3] = (a22 * b04 - a21 * b05 - a23 * b03) * det;
+    out[4] = (a12 * b08 - a10 * b11 - a13 * b07) * det;
+    out[5] = (a00 * b11 - a02 * b08 + a03 * b07) * det;
+    out[6] = (a32 * b02 - a30 * b05 - a33 * b01) * det;
+    out[7] = (a20 * b05 - a22 * b02 + a23 * b01) * det;
+    out[8] = (a10 * b10 - a11 * b08 + a13 * b06) * det;
+    out[9] = (a01 * b08 - a00 * b10 - a03 * b06) * det;
+    out[10] = (a30 * b04 - a31 * b02 + a33 * b00) * det;
+    out[11] = (a21 * b02 - a20 * b04 - a23 * b00) * det;
+    out[12] = (a11 * b07 - a10 * b09 - a12 * b06) * det;
+    out[13] = (a00 * b09 - a01 * b07 + a02 * b06) * det;
+    out[14] = (a31 * b01 - a30 * b03 - a32 * b00) * det;
+    out[15] = (a20 * b03 - a21 * b01 + a22 * b00) * det;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set out to the normal matrix of m (the upper 3x3 of the
+/// inverse, transposed). As with invert, a singular m is used unchanged.
+///
+template <typename T>
+static void normal_values(const T* m, T* out)
+{
+    T inv[16];
+    const T* src = invert_values(m, inv) ? inv : m;
+    for (auto i = 0u; i < 3; ++i) {
+        out[3 * i + 0] = src[i];
+        out[3 * i + 1] = src[4 + i];
+        out[3 * i + 2] = src[8 + i];
+    }
+}
+
+// Swap the values of m across its diagonal
+template <typename T>
+static inline void transpose_values(T* m) {
+    using std::swap;
+    swap(m[1], m[4]);
+    swap(m[2], m[8]);
+    swap(m[3], m[12]);
+    swap(m[6], m[9]);
+    swap(m[7], m[13]);
+    swap(m[11], m[14]);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply an array of matrices by the matrix b (out[i] = a[i] *
+/// b). The values of b must not be part of out.
+///
+template <typename T>
+static void mul_broadcast(const basic_matrix4<T>* a, const T* b,
+    basic_matrix4<T>* out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        mul_values(a[i].m_mat.data(), b, out[i].m_mat.data());
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Transform in[begin, end) into out[begin, end) as the row
+/// vectors [v w]. With project set the results are divided by their w.
+///
+template <bool project, typename T>
+static void transform_range(const basic_matrix4<T>& m, const basic_vector3<T>* in,
+    basic_vector3<T>* out, std::size_t begin, std::size_t end, T w)
+{
+    const auto& a = m.m_mat;
+    for (auto i = begin; i < end; ++i) {
+        auto& v = in[i];
+        auto x = v.x() * a[0] + v.y() * a[4] + v.z() * a[8] + w * a[12],
+             y = v.x() * a[1] + v.y() * a[5] + v.z() * a[9] + w * a[13],
+             z = v.x() * a[2] + v.y() * a[6] + v.z() * a[10] + w * a[14];
+        if (project) {
+            auto vw = v.x() * a[3] + v.y() * a[7] + v.z() * a[11] + w * a[15];
+            auto s = nearly_equal(vw, T(0), default_epsilon<T>()) ? T(1) : 1 / vw;
+            x *= s;
+            y *= s;
+            z *= s;
+        }
+        out[i] = basic_vector3<T>(x, y, z);
+    }
+}
+
+
+#if defined(LINALG_SIMD)
+//------------------------------------------------------------------------------
+/// @brief      Multiply the rows of a by the matrix b (as rows b0-b3). Each
+/// row of a is read before the matching row of out is written, so out may
+/// alias a.
+///
+static inline void mul_rows(const float* a, simd::f32x4 b0, simd::f32x4 b1,
+    simd::f32x4 b2, simd::f32x4 b3, float* out)
+{
+    for (auto i = 0u; i < 16; i += 4) {
+        auto row = simd::load(a + i);
+        auto r = simd::mul(simd::lane<0>(row), b0);
+        r = simd::madd(simd::lane<1>(row), b1, r);
+        r = simd::madd(simd::lane<2>(row), b2, r);
+        r = simd::madd(simd::lane<3>(row), b3, r);
+        simd::store(out + i, r);
+    }
+}
+
+static inline void mul_values(const float* a, const float* b, float* out) {
+    mul_rows(a, simd::load(b), simd::load(b + 4), simd::load(b + 8), simd::load(b + 12), out);
+}
+
+static inline void add_values(float* a, const float* b) {
+    for (auto i = 0u; i < 16; i += 4) {
+        simd::store(a + i, simd::add(simd::load(a + i), simd::load(b + i)));
+    }
+}
+
+static inline void sub_values(float* a, const float* b) {
+    for (auto i = 0u; i < 16; i += 4) {
+        simd::store(a + i, simd::sub(simd::load(a + i), simd::load(b + i)));
+    }
+}
+
+static inline void scale_values(float* a, float s) {
+    auto sv = simd::splat(s);
+    for (auto i = 0u; i < 16; i += 4) {
+        simd::store(a + i, simd::mul(simd::load(a + i), sv));
+    }
+}
+
+static inline void rotate_values(float* a, const float* b) {
+    using namespace simd;
+    auto a0 = load(a), a1 = load(a + 4), a2 = load(a + 8);
+    store(a, madd(splat(b[2]), a2, madd(splat(b[1]), a1, mul(splat(b[0]), a0))));
+    store(a + 4, madd(splat(b[5]), a2, madd(splat(b[4]), a1, mul(splat(b[3]), a0))));
+    store(a + 8, madd(splat(b[8]), a2, madd(splat(b[7]), a1, mul(splat(b[6]), a0))));
+}
+
+// 2x2 matrix products on (m00, m01, m10, m11) packed vectors: a * b
+static inline simd::f32x4 mat2_mul(simd::f32x4 a, simd::f32x4 b) {
+    using namespace simd;
+    return add(mul(a, swizzle<0, 3, 0, 3>(b)),
+               mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// adj(a) * b
+static inline simd::f32x4 mat2_adj_mul(simd::f32x4 a, simd::f32x4 b) {
+    using namespace simd;
+    return sub(mul(swizzle<3, 3, 0, 0>(a), b),
+               mul(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
+
+// a * adj(b)
+static inline simd::f32x4 mat2_mul_adj(simd::f32x4 a, simd::f32x4 b) {
+    using namespace simd;
+    return sub(mul(a, swizzle<3, 0, 3, 0>(b)),
+               mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert the matrix m using 2x2 block cofactors
+/// https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+///
+/// @param[in]  m     The 16 values of the matrix to invert
+/// @param[out] out   The rows of the inverse (unchanged if m is singular)
+///
+/// @return     false if the matrix is singular
+///
+static bool invert_rows(const float* m, simd::f32x4 out[4])
+{
+    using namespace simd;
+    auto r0 = load(m), r1 = load(m + 4), r2 = load(m + 8), r3 = load(m + 12);
+
+    // The four 2x2 sub-matrices
+    auto A = shuffle<0, 1, 0, 1>(r0, r1),
+         B = shuffle<2, 3, 2, 3>(r0, r1),
+         C = shuffle<0, 1, 0, 1>(r2, r3),
+         D = shuffle<2, 3, 2, 3>(r2, r3);
+
+    // Determinants of the sub-matrices as (|A|, |B|, |C|, |D|)
+    auto det_sub = sub(
+        mul(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+        mul(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3)));
+    auto det_a = lane<0>(det_sub), det_b = lane<1>(det_sub),
+         det_c = lane<2>(det_sub), det_d = lane<3>(det_sub);
+
+    auto d_c = mat2_adj_mul(D, C),
+         a_b = mat2_adj_mul(A, B);
+
+    auto x = sub(mul(det_d, A), mat2_mul(B, d_c)),
+         w = sub(mul(det_a, D), mat2_mul(C, a_b)),
+         y = sub(mul(det_b, C), mat2_mul_adj(D, a_b)),
+         z = sub(mul(det_c, B), mat2_mul_adj(A, d_c));
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    auto det = add(mul(det_a, det_d), mul(det_b, det_c));
+    det = sub(det, hsum(mul(a_b, swizzle<0, 2, 1, 3>(d_c))));
+    if (nearly_equal(first(det), 0)) {
+        return false;
+    }
+    auto det_inv = div(set(1, -1, -1, 1), det);
+
+    x = mul(x, det_inv);
+    y = mul(y, det_inv);
+    z = mul(z, det_inv);
+    w = mul(w, det_inv);
+
+    // Apply the adjugate shuffle while recombining the blocks into rows
+    out[0] = shuffle<3, 1, 3, 1>(x, y);
+    out[1] = shuffle<2, 0, 2, 0>(x, y);
+    out[2] = shuffle<3, 1, 3, 1>(z, w);
+    out[3] = shuffle<2, 0, 2, 0>(z, w);
+    return true;
+}
+
+static bool invert_values(const float* m, float* out) {
+    simd::f32x4 rows[4];
+    if (!invert_rows(m, rows)) {
+        return false;
+    }
+    for (auto i = 0u; i < 4; ++i) {
+        simd::store(out + 4 * i, rows[i]);
+    }
+    return true;
+}
+
+static void normal_values(const float* m, float* out) {
+    simd::f32x4 rows[4];
+    if (!invert_rows(m, rows)) {
+        for (auto i = 0u; i < 4; ++i) {
+            rows[i] = simd::load(m + 4 * i);
+        }
+    }
+    simd::transpose(rows[0], rows[1], rows[2], rows[3]);
+
+    float inv_t[12];
+    simd::store(inv_t + 0, rows[0]);
+    simd::store(inv_t + 4, rows[1]);
+    simd::store(inv_t + 8, rows[2]);
+    for (auto i = 0u; i < 3; ++i) {
+        out[3 * i + 0] = inv_t[4 * i + 0];
+        out[3 * i + 1] = inv_t[4 * i + 1];
+        out[3 * i + 2] = inv_t[4 * i + 2];
+    }
+}
+
+static inline void transpose_values(float* m) {
+    auto r0 = simd::load(m), r1 = simd::load(m + 4),
+         r2 = simd::load(m + 8), r3 = simd::load(m + 12);
+    simd::transpose(r0, r1, r2, r3);
+    simd::store(m, r0);
+    simd::store(m + 4, r1);
+    simd::store(m + 8, r2);
+    simd::store(m + 12, r3);
+}
+
+// The rows of b are loaded once for the whole array
+static void mul_broadcast(const basic_matrix4<float>* a, const float* b,
+    basic_matrix4<float>* out, std::size_t count)
+{
+    auto b0 = simd::load(b), b1 = simd::load(b + 4),
+         b2 = simd::load(b + 8), b3 = simd::load(b + 12);
+    for (std::size_t i = 0; i < count; ++i) {
+        mul_rows(a[i].m_mat.data(), b0, b1, b2, b3, out[i].m_mat.data());
+    }
+}
+
+static_assert(sizeof(basic_vector3<float>) == 3 * sizeof(float),
+    "The batch transforms treat arrays of vector3 as packed scalars");
+
+//------------------------------------------------------------------------------
+/// @brief      Transform in[begin, end) into out[begin, end) four vectors at
+/// a time (the rest use the portable version). Each block of four vectors
+/// is read before it is written, so out may alias in.
+///
+template <bool project>
+static void transform_range(const basic_matrix4<float>& m, const basic_vector3<float>* in,
+    basic_vector3<float>* out, std::size_t begin, std::size_t end, float w)
+{
+    using namespace simd;
+    auto i = begin;
+
+    // Splat the matrix so four vectors are transformed as x, y and z lanes
+    const auto& a = m.m_mat;
+    auto m0 = splat(a[0]), m1 = splat(a[1]), m2 = splat(a[2]), m3 = splat(a[3]),
+         m4 = splat(a[4]), m5 = splat(a[5]), m6 = splat(a[6]), m7 = splat(a[7]),
+         m8 = splat(a[8]), m9 = splat(a[9]), m10 = splat(a[10]), m11 = splat(a[11]),
+         m12 = splat(a[12] * w), m13 = splat(a[13] * w),
+         m14 = splat(a[14] * w), m15 = splat(a[15] * w);
+    auto zero_w = splat(default_epsilon<float>() * std::numeric_limits<float>::min());
+
+    // Four vectors are twelve packed scalars (three SIMD registers)
+    for (; i + 4 <= end; i += 4) {
+        auto src = reinterpret_cast<const float*>(in + i);
+        auto i0 = load(src), i1 = load(src + 4), i2 = load(src + 8);
+
+        auto xs = shuffle<0, 2, 0, 2>(shuffle<0, 0, 3, 3>(i0, i0), shuffle<2, 2, 1, 1>(i1, i2)),
+             ys = shuffle<0, 2, 0, 2>(shuffle<1, 1, 0, 0>(i0, i1), shuffle<3, 3, 2, 2>(i1, i2)),
+             zs = shuffle<0, 2, 0, 2>(shuffle<2, 2, 1, 1>(i0, i1), shuffle<0, 0, 3, 3>(i2, i2));
+
+        auto ox = madd(xs, m0, madd(ys, m4, madd(zs, m8, m12))),
+             oy = madd(xs, m1, madd(ys, m5, madd(zs, m9, m13))),
+             oz = madd(xs, m2, madd(ys, m6, madd(zs, m10, m14)));
+
+        if (project) {
+            // A w that nearly_equal takes for zero (within epsilon of the
+            // smallest normal float, as in the scalar code) is not divided by
+            auto ow = madd(xs, m3, madd(ys, m7, madd(zs, m11, m15)));
+            auto abs_w = max(ow, sub(splat(0), ow));
+            auto s = div(splat(1), select(lt(abs_w, zero_w), splat(1), ow));
+            ox = mul(ox, s);
+            oy = mul(oy, s);
+            oz = mul(oz, s);
+        }
+
+        auto dst = reinterpret_cast<float*>(out + i);
+        store(dst, shuffle<0, 2, 0, 2>(shuffle<0, 0, 0, 0>(ox, oy), shuffle<0, 0, 1, 1>(oz, ox)));
+        store(dst + 4, shuffle<0, 2, 0, 2>(shuffle<1, 1, 1, 1>(oy, oz), shuffle<2, 2, 2, 2>(ox, oy)));
+        store(dst + 8, shuffle<0, 2, 0, 2>(shuffle<2, 2, 3, 3>(oz, ox), shuffle<3, 3, 3, 3>(oy, oz)));
+    }
+    transform_range<project, float>(m, in, out, i, end, w);
+}
+#endif
 
 
 //------------------------------------------------------------------------------
@@ -10,7 +447,8 @@
 ///
 /// @return     the updated matrix
 ///
-matrix4& matrix4::id() {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::id() {
     m_mat = {{
         1, 0, 0, 0,
         0, 1, 0, 0,
@@ -27,26 +465,13 @@ matrix4& matrix4::id() {
 ///
 /// @return     the updated matrix
 ///
-matrix4& matrix4::add(const matrix4& other) {
-    m_mat[0] += other.m_mat[0];
-    m_mat[1] += other.m_mat[1];
-    m_mat[2] += other.m_mat[2];
-    m_mat[3] += other.m_mat[3];
-    m_mat[4] += other.m_mat[4];
-    m_mat[5] += other.m_mat[5];
-    m_mat[6] += other.m_mat[6];
-    m_mat[7] += other.m_mat[7];
-    m_mat[8] += other.m_mat[8];
-    m_mat[9] += other.m_mat[9];
-    m_mat[10] += other.m_mat[10];
-    m_mat[11] += other.m_mat[11];
-    m_mat[12] += other.m_mat[12];
-    m_mat[13] += other.m_mat[13];
-    m_mat[14] += other.m_mat[14];
-    m_mat[15] += other.m_mat[15];
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::add(const basic_matrix4& other) {
+    add_values(m_mat.data(), other.m_mat.data());
     return *this;
 }
-matrix4& matrix4::operator+=(const matrix4& other) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::operator+=(const basic_matrix4& other) {
     return add(other);
 }
 
@@ -57,26 +482,13 @@ matrix4& matrix4::operator+=(const matrix4& other) {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::sub(const matrix4& other) {
-    m_mat[0] -= other.m_mat[0];
-    m_mat[1] -= other.m_mat[1];
-    m_mat[2] -= other.m_mat[2];
-    m_mat[3] -= other.m_mat[3];
-    m_mat[4] -= other.m_mat[4];
-    m_mat[5] -= other.m_mat[5];
-    m_mat[6] -= other.m_mat[6];
-    m_mat[7] -= other.m_mat[7];
-    m_mat[8] -= other.m_mat[8];
-    m_mat[9] -= other.m_mat[9];
-    m_mat[10] -= other.m_mat[10];
-    m_mat[11] -= other.m_mat[11];
-    m_mat[12] -= other.m_mat[12];
-    m_mat[13] -= other.m_mat[13];
-    m_mat[14] -= other.m_mat[14];
-    m_mat[15] -= other.m_mat[15];
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::sub(const basic_matrix4& other) {
+    sub_values(m_mat.data(), other.m_mat.data());
     return *this;
 }
-matrix4& matrix4::operator-=(const matrix4& other) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::operator-=(const basic_matrix4& other) {
     return sub(other);
 }
 
@@ -87,26 +499,13 @@ matrix4& matrix4::operator-=(const matrix4& other) {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::scale(scalar s) {
-    m_mat[0] *= s;
-    m_mat[1] *= s;
-    m_mat[2] *= s;
-    m_mat[3] *= s;
-    m_mat[4] *= s;
-    m_mat[5] *= s;
-    m_mat[6] *= s;
-    m_mat[7] *= s;
-    m_mat[8] *= s;
-    m_mat[9] *= s;
-    m_mat[10] *= s;
-    m_mat[11] *= s;
-    m_mat[12] *= s;
-    m_mat[13] *= s;
-    m_mat[14] *= s;
-    m_mat[15] *= s;
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::scale(T s) {
+    scale_values(m_mat.data(), s);
     return *this;
 }
-matrix4& matrix4::operator*=(scalar s) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::operator*=(T s) {
     return scale(s);
 }
 
@@ -117,97 +516,83 @@ matrix4& matrix4::operator*=(scalar s) {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::mul(const matrix4& other) {
-    auto &m00 = other.m_mat[0], &m01 = other.m_mat[1],
-         &m02 = other.m_mat[2], &m03 = other.m_mat[3],
-
-         &m10 = other.m_mat[4], &m11 = other.m_mat[5],
-         &m12 = other.m_mat[6], &m13 = other.m_mat[7],
-
-         &m20 = other.m_mat[8], &m21 = other.m_mat[9],
-         &m22 = other.m_mat[10], &m23 = other.m_mat[11],
-
-         &m30 = other.m_mat[12], &m31 = other.m_mat[13],
-         &m32 = other.m_mat[14], &m33 = other.m_mat[15];
-
-    auto b0  = m_mat[0], b1 = m_mat[1], b2 = m_mat[2], b3 = m_mat[3];
-    m_mat[0] = b0 * m00 + b1 * m10 + b2 * m20 + b3 * m30;
-    m_mat[1] = b0 * m01 + b1 * m11 + b2 * m21 + b3 * m31;
-    m_mat[2] = b0 * m02 + b1 * m12 + b2 * m22 + b3 * m32;
-    m_mat[3] = b0 * m03 + b1 * m13 + b2 * m23 + b3 * m33;
-
-    b0 = m_mat[4]; b1 = m_mat[5]; b2 = m_mat[6]; b3 = m_mat[7];
-    m_mat[4] = b0 * m00 + b1 * m10 + b2 * m20 + b3 * m30;
-    m_mat[5] = b0 * m01 + b1 * m11 + b2 * m21 + b3 * m31;
-    m_mat[6] = b0 * m02 + b1 * m12 + b2 * m22 + b3 * m32;
-    m_mat[7] = b0 * m03 + b1 * m13 + b2 * m23 + b3 * m33;
-
-    b0 = m_mat[8]; b1 = m_mat[9]; b2 = m_mat[10]; b3 = m_mat[11];
-    m_mat[8] = b0 * m00 + b1 * m10 + b2 * m20 + b3 * m30;
-    m_mat[9] = b0 * m01 + b1 * m11 + b2 * m21 + b3 * m31;
-    m_mat[10] = b0 * m02 + b1 * m12 + b2 * m22 + b3 * m32;
-    m_mat[11] = b0 * m03 + b1 * m13 + b2 * m23 + b3 * m33;
-
-    b0 = m_mat[12]; b1 = m_mat[13]; b2 = m_mat[14]; b3 = m_mat[15];
-    m_mat[12] = b0 * m00 + b1 * m10 + b2 * m20 + b3 * m30;
-    m_mat[13] = b0 * m01 + b1 * m11 + b2 * m21 + b3 * m31;
-    m_mat[14] = b0 * m02 + b1 * m12 + b2 * m22 + b3 * m32;
-    m_mat[15] = b0 * m03 + b1 * m13 + b2 * m23 + b3 * m33;
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::mul(const basic_matrix4& other) {
+    mul_values(m_mat.data(), other.m_mat.data(), m_mat.data());
     return *this;
 }
-matrix4& matrix4::operator*=(const matrix4& other) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::operator*=(const basic_matrix4& other) {
     return mul(other);
 }
 
 //------------------------------------------------------------------------------
-/// @brief      Rotate this matrix
+/// @brief      Rotate the matrix a around the unit vector n by the angle with
+/// the cosine c and sine s
 /// http://www.euclideanspace.com/maths/geometry/rotations/conversions/angleToMatrix/
 ///
+template <typename T>
+static void rotate_axis(T* a, const basic_vector3<T>& n, T c, T s)
+{
+    auto x = n.x(), y = n.y(), z = n.z(), t = 1 - c;
+
+    // Construct the elements of the rotation matrix
+    const T b[9] = {
+        x * x * t + c,
+        y * x * t + z * s,
+        z * x * t - y * s,
+        x * y * t - z * s,
+        y * y * t + c,
+        z * y * t + x * s,
+        x * z * t + y * s,
+        y * z * t - x * s,
+        z * z * t + c
+    };
+
+    // Perform rotation-specific matrix multiplication
+    rotate_values(a, b);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Rotate this matrix
+///
 /// @param[in]  rads  The angle to rotate by (in radians)
 /// @param[in]  axis  The axis to rotate around
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::rotate(scalar rads, vector3 axis) {
-    auto &x = axis.x(), &y = axis.y(), &z = axis.z(), len = axis.len();
-
-    if (nearly_equal(len, 0)) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::rotate(T rads, vector_type axis) {
+#if defined(LINALG_FAST_MATH)
+    return rotate(rads, axis, fast_math);
+#else
+    if (nearly_equal(axis.len(), T(0), default_epsilon<T>())) {
         return *this;
     }
     axis.normalize();
+    rotate_axis(m_mat.data(), axis, std::cos(rads), std::sin(rads));
+    return *this;
+#endif
+}
 
-    auto c = std::cos(rads);
-    auto s = std::sin(rads);
-    auto t = 1 - c;
-
-    auto a00 = m_mat[0], a01 = m_mat[1], a02 = m_mat[2], a03 = m_mat[3],
-         a10 = m_mat[4], a11 = m_mat[5], a12 = m_mat[6], a13 = m_mat[7],
-         a20 = m_mat[8], a21 = m_mat[9], a22 = m_mat[10], a23 = m_mat[11];
-
-    // Construct the elements of the rotation matrix
-    auto b00 = x * x * t + c,
-         b01 = y * x * t + z * s,
-         b02 = z * x * t - y * s,
-         b10 = x * y * t - z * s,
-         b11 = y * y * t + c,
-         b12 = z * y * t + x * s,
-         b20 = x * z * t + y * s,
-         b21 = y * z * t - x * s,
-         b22 = z * z * t + c;
-
-    // Perform rotation-specific matrix multiplication
-    m_mat[0] = a00 * b00 + a10 * b01 + a20 * b02;
-    m_mat[1] = a01 * b00 + a11 * b01 + a21 * b02;
-    m_mat[2] = a02 * b00 + a12 * b01 + a22 * b02;
-    m_mat[3] = a03 * b00 + a13 * b01 + a23 * b02;
-    m_mat[4] = a00 * b10 + a10 * b11 + a20 * b12;
-    m_mat[5] = a01 * b10 + a11 * b11 + a21 * b12;
-    m_mat[6] = a02 * b10 + a12 * b11 + a22 * b12;
-    m_mat[7] = a03 * b10 + a13 * b11 + a23 * b12;
-    m_mat[8] = a00 * b20 + a10 * b21 + a20 * b22;
-    m_mat[9] = a01 * b20 + a11 * b21 + a21 * b22;
-    m_mat[10] = a02 * b20 + a12 * b21 + a22 * b22;
-    m_mat[11] = a03 * b20 + a13 * b21 + a23 * b22;
+//------------------------------------------------------------------------------
+/// @brief      Rotate this matrix using the approximate sine, cosine and
+/// normalize (see fast_math.h for the error)
+///
+/// @param[in]  rads  The angle to rotate by (in radians)
+/// @param[in]  axis  The axis to rotate around
+///
+/// @return     the updated matrix
+///
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::rotate(T rads, vector_type axis, fast_math_t) {
+    if (nearly_equal(axis.len2(), T(0), default_epsilon<T>())) {
+        return *this;
+    }
+    axis.normalize(fast_math);
+    T s, c;
+    fast_sincos(rads, s, c);
+    rotate_axis(m_mat.data(), axis, c, s);
     return *this;
 }
 
@@ -216,48 +601,9 @@ matrix4& matrix4::rotate(scalar rads, vector3 axis) {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::invert() {
-    auto a00 = m_mat[0], a01 = m_mat[1], a02 = m_mat[2], a03 = m_mat[3],
-         a10 = m_mat[4], a11 = m_mat[5], a12 = m_mat[6], a13 = m_mat[7],
-         a20 = m_mat[8], a21 = m_mat[9], a22 = m_mat[10], a23 = m_mat[11],
-         a30 = m_mat[12], a31 = m_mat[13], a32 = m_mat[14], a33 = m_mat[15];
-
-    auto b00 = a00 * a11 - a01 * a10,
-         b01 = a00 * a12 - a02 * a10,
-         b02 = a00 * a13 - a03 * a10,
-         b03 = a01 * a12 - a02 * a11,
-         b04 = a01 * a13 - a03 * a11,
-         b05 = a02 * a13 - a03 * a12,
-         b06 = a20 * a31 - a21 * a30,
-         b07 = a20 * a32 - a22 * a30,
-         b08 = a20 * a33 - a23 * a30,
-         b09 = a21 * a32 - a22 * a31,
-         b10 = a21 * a33 - a23 * a31,
-         b11 = a22 * a33 - a23 * a32;
-
-    // Calculate the determinant
-    auto det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
-    if (nearly_equal(det, 0)) {
-        return *this;
-    }
-    det = static_cast<scalar>(1.0) / det;
-
-    m_mat[0] = (a11 * b11 - a12 * b10 + a13 * b09) * det;
-    m_mat[1] = (a02 * b10 - a01 * b11 - a03 * b09) * det;
-    m_mat[2] = (a31 * b05 - a32 * b04 + a33 * b03) * det;
-    m_mat[3] = (a22 * b04 - a21 * b05 - a23 * b03) * det;
-    m_mat[4] = (a12 * b08 - a10 * b11 - a13 * b07) * det;
-    m_mat[5] = (a00 * b11 - a02 * b08 + a03 * b07) * det;
-    m_mat[6] = (a32 * b02 - a30 * b05 - a33 * b01) * det;
-    m_mat[7] = (a20 * b05 - a22 * b02 + a23 * b01) * det;
-    m_mat[8] = (a10 * b10 - a11 * b08 + a13 * b06) * det;
-    m_mat[9] = (a01 * b08 - a00 * b10 - a03 * b06) * det;
-    m_mat[10] = (a30 * b04 - a31 * b02 + a33 * b00) * det;
-    m_mat[11] = (a21 * b02 - a20 * b04 - a23 * b00) * det;
-    m_mat[12] = (a11 * b07 - a10 * b09 - a12 * b06) * det;
-    m_mat[13] = (a00 * b09 - a01 * b07 + a02 * b06) * det;
-    m_mat[14] = (a31 * b01 - a30 * b03 - a32 * b00) * det;
-    m_mat[15] = (a20 * b03 - a21 * b01 + a22 * b00) * det;
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::invert() {
+    invert_values(m_mat.data(), m_mat.data());
     return *this;
 }
 
@@ -266,23 +612,9 @@ matrix4& matrix4::invert() {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::transpose() {
-    auto a01 = m_mat[1], a02 = m_mat[2], a03 = m_mat[3],
-         a12 = m_mat[6], a13 = m_mat[7],
-         a23 = m_mat[11];
-
-    m_mat[1] = m_mat[4];
-    m_mat[2] = m_mat[8];
-    m_mat[3] = m_mat[12];
-    m_mat[4] = a01;
-    m_mat[6] = m_mat[9];
-    m_mat[7] = m_mat[13];
-    m_mat[8] = a02;
-    m_mat[9] = a12;
-    m_mat[11] = m_mat[14];
-    m_mat[12] = a03;
-    m_mat[13] = a13;
-    m_mat[14] = a23;
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::transpose() {
+    transpose_values(m_mat.data());
     return *this;
 }
 
@@ -295,7 +627,10 @@ matrix4& matrix4::transpose() {
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::look_at(const vector3& eye, const vector3& target, const vector3& up) {
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::look_at(const vector_type& eye,
+    const vector_type& target, const vector_type& up)
+{
     auto zaxis = target.clone().sub(eye).normalize(),
          xaxis = up.clone().cross(zaxis).normalize(),
          yaxis = zaxis.clone().cross(xaxis).normalize();
@@ -326,6 +661,36 @@ matrix4& matrix4::look_at(const vector3& eye, const vector3& target, const vecto
     return *this;
 }
 
+//------------------------------------------------------------------------------
+/// @brief      Set the matrix m to a perspective with the focal length f
+/// (the cotangent of half the vertical field of view)
+///
+template <typename T>
+static void set_perspective(T* m, T f, T aspect, T near, T far)
+{
+    auto depth_inv = 1 / (near - far);
+
+    m[0] = f / aspect;
+    m[1] = 0;
+    m[2] = 0;
+    m[3] = 0;
+
+    m[4] = 0;
+    m[5] = f;
+    m[6] = 0;
+    m[7] = 0;
+
+    m[8] = 0;
+    m[9] = 0;
+    m[10] = (near + far) * depth_inv;
+    m[11] = -1;
+
+    m[12] = 0;
+    m[13] = 0;
+    m[14] = near * far * depth_inv * 2;
+    m[15] = 0;
+}
+
 //------------------------------------------------------------------------------
 /// @brief      Set this matrix as a specified perspective
 /// https://developer.mozilla.org/en-US/docs/Web/API/WebGL_API/WebGL_model_view_projection
@@ -337,78 +702,188 @@ matrix4& matrix4::look_at(const vector3& eye, const vector3& target, const vecto
 ///
 /// @return     { description_of_the_return_value }
 ///
-matrix4& matrix4::perspective(scalar fovy, scalar aspect, scalar near, scalar far) {
-    auto f = 1 / std::tan(fovy / 2),
-         depth_inv = 1 / (near - far);
-
-    m_mat[0] = f / aspect;
-    m_mat[1] = 0;
-    m_mat[2] = 0;
-    m_mat[3] = 0;
-
-    m_mat[4] = 0;
-    m_mat[5] = f;
-    m_mat[6] = 0;
-    m_mat[7] = 0;
-
-    m_mat[8] = 0;
-    m_mat[9] = 0;
-    m_mat[10] = (near + far) * depth_inv;
-    m_mat[11] = -1;
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::perspective(T fovy, T aspect, T near, T far) {
+#if defined(LINALG_FAST_MATH)
+    return perspective(fovy, aspect, near, far, fast_math);
+#else
+    set_perspective(m_mat.data(), 1 / std::tan(fovy / 2), aspect, near, far);
+    return *this;
+#endif
+}
 
-    m_mat[12] = 0;
-    m_mat[13] = 0;
-    m_mat[14] = near * far * depth_inv * 2;
-    m_mat[15] = 0;
+//------------------------------------------------------------------------------
+/// @brief      Set this matrix as a specified perspective using the
+/// approximate sine and cosine (see fast_math.h for the error)
+///
+/// @param[in]  fovy    The filed of view (based on y-axis)
+/// @param[in]  aspect  The aspect ratio
+/// @param[in]  near    The distance to the near plane
+/// @param[in]  far     The distance to the far plane
+///
+/// @return     the updated matrix
+///
+template <typename T>
+basic_matrix4<T>& basic_matrix4<T>::perspective(T fovy, T aspect, T near, T far,
+    fast_math_t)
+{
+    T s, c;
+    fast_sincos(fovy / 2, s, c);
+    set_perspective(m_mat.data(), c / s, aspect, near, far);
     return *this;
 }
 
 //------------------------------------------------------------------------------
-/// @brief      Set the values of a 3x3 matrix to the normal of this matrix
+/// @brief      Set the values of a 3x3 matrix to the normal of this matrix.
+/// As with invert, a singular matrix is used unchanged (so the result is
+/// its upper 3x3 transposed, the same as cached_matrix4::normal).
 ///
 /// @param      out   The output 3x3 matrix
 ///
-void matrix4::set_as_normal(scalar out[9]) const {
-    auto &a00 = m_mat[0], &a01 = m_mat[1], &a02 = m_mat[2], &a03 = m_mat[3],
-         &a10 = m_mat[4], &a11 = m_mat[5], &a12 = m_mat[6], &a13 = m_mat[7],
-         &a20 = m_mat[8], &a21 = m_mat[9], &a22 = m_mat[10], &a23 = m_mat[11],
-         &a30 = m_mat[12], &a31 = m_mat[13], &a32 = m_mat[14], &a33 = m_mat[15];
+template <typename T>
+void basic_matrix4<T>::set_as_normal(T out[9]) const {
+    normal_values(m_mat.data(), out);
+}
 
-    auto b00 = a00 * a11 - a01 * a10,
-         b01 = a00 * a12 - a02 * a10,
-         b02 = a00 * a13 - a03 * a10,
-         b03 = a01 * a12 - a02 * a11,
-         b04 = a01 * a13 - a03 * a11,
-         b05 = a02 * a13 - a03 * a12,
-         b06 = a20 * a31 - a21 * a30,
-         b07 = a20 * a32 - a22 * a30,
-         b08 = a20 * a33 - a23 * a30,
-         b09 = a21 * a32 - a22 * a31,
-         b10 = a21 * a33 - a23 * a31,
-         b11 = a22 * a33 - a23 * a32;
+//------------------------------------------------------------------------------
+/// @brief      Multiply two arrays of matrices element by element
+/// (out[i] = a[i] * b[i]). Each out[i] may alias a[i] or b[i].
+///
+/// @param[in]  a      The left-hand matrices
+/// @param[in]  b      The right-hand matrices
+/// @param[out] out    The products
+/// @param[in]  count  The number of matrices in each array
+///
+template <typename T>
+void mul_batch(const basic_matrix4<T>* a, const basic_matrix4<T>* b,
+    basic_matrix4<T>* out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        mul_values(a[i].m_mat.data(), b[i].m_mat.data(), out[i].m_mat.data());
+    }
+}
 
-    // Calculate the determinant
-    auto det = b00 * b11 - b01 * b10 + b02 * b09 + b03 * b08 - b04 * b07 + b05 * b06;
-    if (nearly_equal(det, 0)) {
-        return;
+//------------------------------------------------------------------------------
+/// @brief      Multiply an array of matrices by a single matrix
+/// (out[i] = a[i] * b). This is the form used to move children into the
+/// space of their parent. The array b must not be part of out.
+///
+/// @param[in]  a      The left-hand matrices
+/// @param[in]  b      The right-hand matrix (e.g. the parent transform)
+/// @param[out] out    The products
+/// @param[in]  count  The number of matrices in a and out
+///
+template <typename T>
+void mul_batch(const basic_matrix4<T>* a, const basic_matrix4<T>& b,
+    basic_matrix4<T>* out, std::size_t count)
+{
+    mul_broadcast(a, b.m_mat.data(), out, count);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply a single matrix by an array of matrices
+/// (out[i] = a * b[i]). The matrix a must not be part of out.
+///
+/// @param[in]  a      The left-hand matrix
+/// @param[in]  b      The right-hand matrices
+/// @param[out] out    The products
+/// @param[in]  count  The number of matrices in b and out
+///
+template <typename T>
+void mul_batch(const basic_matrix4<T>& a, const basic_matrix4<T>* b,
+    basic_matrix4<T>* out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        mul_values(a.m_mat.data(), b[i].m_mat.data(), out[i].m_mat.data());
     }
-    det = static_cast<scalar>(1.0) / det;
+}
 
-    out[0] = (a11 * b11 - a12 * b10 + a13 * b09) * det;
-    out[1] = (a12 * b08 - a10 * b11 - a13 * b07) * det;
-    out[2] = (a10 * b10 - a11 * b08 + a13 * b06) * det;
+//------------------------------------------------------------------------------
+/// @brief      Return a point transformed by this matrix (as the row vector
+/// [p 1] times the matrix) followed by the perspective divide
+///
+/// @param[in]  p     The point
+///
+/// @return     the transformed point
+///
+template <typename T>
+auto basic_matrix4<T>::transform_point(const vector_type& p) const -> vector_type {
+    auto w = p.x() * m_mat[3] + p.y() * m_mat[7] + p.z() * m_mat[11] + m_mat[15];
+    auto s = nearly_equal(w, T(0), default_epsilon<T>()) ? T(1) : 1 / w;
+    return {
+        (p.x() * m_mat[0] + p.y() * m_mat[4] + p.z() * m_mat[8] + m_mat[12]) * s,
+        (p.x() * m_mat[1] + p.y() * m_mat[5] + p.z() * m_mat[9] + m_mat[13]) * s,
+        (p.x() * m_mat[2] + p.y() * m_mat[6] + p.z() * m_mat[10] + m_mat[14]) * s
+    };
+}
 
-    out[3] = (a02 * b10 - a01 * b11 - a03 * b09) * det;
-    out[4] = (a00 * b11 - a02 * b08 + a03 * b07) * det;
-    out[5] = (a01 * b08 - a00 * b10 - a03 * b06) * det;
+//------------------------------------------------------------------------------
+/// @brief      Return a direction transformed by this matrix (as the row
+/// vector [v 0] times the matrix, so the translation is ignored)
+///
+/// @param[in]  v     The direction
+///
+/// @return     the transformed direction
+///
+template <typename T>
+auto basic_matrix4<T>::transform_vector(const vector_type& v) const -> vector_type {
+    return {
+        v.x() * m_mat[0] + v.y() * m_mat[4] + v.z() * m_mat[8],
+        v.x() * m_mat[1] + v.y() * m_mat[5] + v.z() * m_mat[9],
+        v.x() * m_mat[2] + v.y() * m_mat[6] + v.z() * m_mat[10]
+    };
+}
+
+// Arrays shorter than this (per thread) are transformed on the calling thread
+static const std::size_t transform_min_per_thread = 1 << 15;
+
+//------------------------------------------------------------------------------
+/// @brief      Transform an array of points by a matrix (out[i] = [in[i] 1] *
+/// m). Large arrays are split across threads. The output may alias the
+/// input.
+///
+/// @param[in]  m        The transform
+/// @param[in]  in       The points
+/// @param[out] out      The transformed points
+/// @param[in]  count    The number of points
+/// @param[in]  project  Divide the results by w (for projection matrices)
+///
+template <typename T>
+void transform_points(const basic_matrix4<T>& m, const basic_vector3<T>* in,
+    basic_vector3<T>* out, std::size_t count, bool project)
+{
+    parallel_for(count, transform_min_per_thread, [&](std::size_t begin, std::size_t end) {
+        if (project) {
+            transform_range<true>(m, in, out, begin, end, T(1));
+        }
+        else {
+            transform_range<false>(m, in, out, begin, end, T(1));
+        }
+    });
+}
 
-    out[6] = (a31 * b05 - a32 * b04 + a33 * b03) * det;
-    out[7] = (a32 * b02 - a30 * b05 - a33 * b01) * det;
-    out[8] = (a30 * b04 - a31 * b02 + a33 * b00) * det;
+//------------------------------------------------------------------------------
+/// @brief      Transform an array of directions by a matrix (out[i] =
+/// [in[i] 0] * m, so the translation is ignored). Large arrays are split
+/// across threads. The output may alias the input.
+///
+/// @param[in]  m      The transform
+/// @param[in]  in     The directions
+/// @param[out] out    The transformed directions
+/// @param[in]  count  The number of directions
+///
+template <typename T>
+void transform_directions(const basic_matrix4<T>& m, const basic_vector3<T>* in,
+    basic_vector3<T>* out, std::size_t count)
+{
+    parallel_for(count, transform_min_per_thread, [&](std::size_t begin, std::size_t end) {
+        transform_range<false>(m, in, out, begin, end, T(0));
+    });
 }
 
 // Insertion operator for the matrix4 class
-std::ostream& operator<<(std::ostream& out, const matrix4& v) {
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const basic_matrix4<T>& v) {
     out << "[ "
         << ScalarFmt() << v.m_mat[0] << "  "
         << ScalarFmt() << v.m_mat[1] << "  "
@@ -432,31 +907,28 @@ std::ostream& operator<<(std::ostream& out, const matrix4& v) {
     return out;
 }
 
-// (Approximately) Compare two vectors for equality
-bool operator==(const matrix4& lhs, const matrix4& rhs) {
-    return nearly_equal(lhs.m_mat[0], rhs.m_mat[0])
-        && nearly_equal(lhs.m_mat[1], rhs.m_mat[1])
-        && nearly_equal(lhs.m_mat[2], rhs.m_mat[2])
-        && nearly_equal(lhs.m_mat[3], rhs.m_mat[3])
-        && nearly_equal(lhs.m_mat[4], rhs.m_mat[4])
-        && nearly_equal(lhs.m_mat[5], rhs.m_mat[5])
-        && nearly_equal(lhs.m_mat[6], rhs.m_mat[6])
-        && nearly_equal(lhs.m_mat[7], rhs.m_mat[7])
-        && nearly_equal(lhs.m_mat[8], rhs.m_mat[8])
-        && nearly_equal(lhs.m_mat[9], rhs.m_mat[9])
-        && nearly_equal(lhs.m_mat[10], rhs.m_mat[10])
-        && nearly_equal(lhs.m_mat[11], rhs.m_mat[11])
-        && nearly_equal(lhs.m_mat[12], rhs.m_mat[12])
-        && nearly_equal(lhs.m_mat[13], rhs.m_mat[13])
-        && nearly_equal(lhs.m_mat[14], rhs.m_mat[14])
-        && nearly_equal(lhs.m_mat[15], rhs.m_mat[15]);
-
-}
-bool operator!=(const matrix4& lhs, const matrix4& rhs) { return !operator==(lhs,rhs); }
-
-// Perform typical algebraic operations on vectors
-matrix4 operator+(matrix4 lhs, const matrix4& rhs) { return lhs += rhs; }
-matrix4 operator-(matrix4 lhs, const matrix4& rhs) { return lhs -= rhs; }
-matrix4 operator*(matrix4 lhs, const matrix4& rhs) { return lhs *= rhs; }
-matrix4 operator*(matrix4 lhs, scalar rhs) { return lhs *= rhs; }
-matrix4 operator*(scalar lhs, matrix4 rhs) { return rhs *= lhs; }
+template class basic_matrix4<float>;
+template std::ostream& operator<<(std::ostream&, const basic_matrix4<float>&);
+template void mul_batch(const basic_matrix4<float>*, const basic_matrix4<float>*,
+    basic_matrix4<float>*, std::size_t);
+template void mul_batch(const basic_matrix4<float>*, const basic_matrix4<float>&,
+    basic_matrix4<float>*, std::size_t);
+template void mul_batch(const basic_matrix4<float>&, const basic_matrix4<float>*,
+    basic_matrix4<float>*, std::size_t);
+template void transform_points(const basic_matrix4<float>&, const basic_vector3<float>*,
+    basic_vector3<float>*, std::size_t, bool);
+template void transform_directions(const basic_matrix4<float>&, const basic_vector3<float>*,
+    basic_vector3<float>*, std::size_t);
+
+template class basic_matrix4<double>;
+template std::ostream& operator<<(std::ostream&, const basic_matrix4<double>&);
+template void mul_batch(const basic_matrix4<double>*, const basic_matrix4<double>*,
+    basic_matrix4<double>*, std::size_t);
+template void mul_batch(const basic_matrix4<double>*, const basic_matrix4<double>&,
+    basic_matrix4<double>*, std::size_t);
+template void mul_batch(const basic_matrix4<double>&, const basic_matrix4<double>*,
+    basic_matrix4<double>*, std::size_t);
+template void transform_points(const basic_matrix4<double>&, const basic_vector3<double>*,
+    basic_vector3<double>*, std::size_t, bool);
+template void transform_directions(const basic_matrix4<double>&, const basic_vector3<double>*,
+    basic_vector3<double>*, std::size_t);
@@ -4,24 +4,35 @@
 
 #include "linalg.h"
 #include "vector3.h"
+#include "expression.h"
 
 #include <iosfwd>
 #include <array>
+#include <cstddef>
+#include <type_traits>
 
 using mat_array = std::array<scalar, 16>;
 
 //------------------------------------------------------------------------------
 /// @brief      This class defines a 4x4 matrix that can be
-/// used to perform linear algebra operations.
+/// used to perform linear algebra operations. Like basic_vector3 it is
+/// templated on the precision: matrix4 is the float matrix (with SIMD
+/// kernels when they are enabled) and matrix4d is the double precision
+/// version.
 ///
-class matrix4
+template <typename T>
+class basic_matrix4 : public linalg_expr<basic_matrix4<T>, 16>
 {
 public:
-    mat_array m_mat;
+    using value_type = T;
+    using array_type = std::array<T, 16>;
+    using vector_type = basic_vector3<T>;
+
+    array_type m_mat;
 
 public: // Constructors ---------------------------------------------
 
-    matrix4()
+    constexpr basic_matrix4()
         : m_mat {{
             1, 0, 0, 0,
             0, 1, 0, 0,
@@ -29,66 +40,177 @@ public: // Constructors ---------------------------------------------
             0, 0, 0, 1 }}
     {}
 
-    matrix4(const mat_array& mat)
+    constexpr basic_matrix4(const array_type& mat)
         : m_mat(mat)
     {}
 
-    matrix4 clone() const {
+    // Convert from another precision (explicit, since it may lose precision)
+    template <typename U>
+    explicit basic_matrix4(const basic_matrix4<U>& mat) {
+        for (auto i = 0u; i < 16; ++i) {
+            m_mat[i] = static_cast<T>(mat.m_mat[i]);
+        }
+    }
+
+    // Evaluate an element-wise expression (e.g. a + b * s) in a single pass
+    // (only expressions of the same precision convert implicitly)
+    template <typename E, typename = std::enable_if_t<
+        std::is_same<typename E::value_type, T>::value>>
+    constexpr basic_matrix4(const linalg_expr<E, 16>& e)
+        : m_mat(expr_eval(e.self(), std::make_index_sequence<16>{}))
+    {}
+
+    template <typename E>
+    basic_matrix4& operator=(const linalg_expr<E, 16>& e) {
+        static_assert(std::is_same<typename E::value_type, T>::value,
+            "The expression has a different precision");
+        const auto& ex = e.self();
+        for (auto i = 0u; i < 16; ++i) {
+            m_mat[i] = ex[i];
+        }
+        return *this;
+    }
+
+    constexpr basic_matrix4 clone() const {
         return {*this};
     }
 
+public: // Accessor methods -----------------------------------------
+
+    constexpr T operator[](std::size_t i) const { return m_mat[i]; }
+
 public: // Interface methods ----------------------------------------
 
     // Set to the identiy matrix
-    matrix4& id();
+    basic_matrix4& id();
 
     // Add another matrix4 to this vector
-    matrix4& add(const matrix4& other);
-    matrix4& operator+=(const matrix4& other);
+    basic_matrix4& add(const basic_matrix4& other);
+    basic_matrix4& operator+=(const basic_matrix4& other);
+
+    template <typename E>
+    basic_matrix4& operator+=(const linalg_expr<E, 16>& e) {
+        const auto& ex = e.self();
+        for (auto i = 0u; i < 16; ++i) {
+            m_mat[i] += ex[i];
+        }
+        return *this;
+    }
 
     // Subtract another matrix4 from this vector
-    matrix4& sub(const matrix4& other);
-    matrix4& operator-=(const matrix4& other);
+    basic_matrix4& sub(const basic_matrix4& other);
+    basic_matrix4& operator-=(const basic_matrix4& other);
+
+    template <typename E>
+    basic_matrix4& operator-=(const linalg_expr<E, 16>& e) {
+        const auto& ex = e.self();
+        for (auto i = 0u; i < 16; ++i) {
+            m_mat[i] -= ex[i];
+        }
+        return *this;
+    }
 
     // Scale this matrix
-    matrix4& scale(scalar s);
-    matrix4& operator*=(scalar s);
+    basic_matrix4& scale(T s);
+    basic_matrix4& operator*=(T s);
 
     // Multiply this matrix
-    matrix4& mul(const matrix4& other);
-    matrix4& operator*=(const matrix4& other);
+    basic_matrix4& mul(const basic_matrix4& other);
+    basic_matrix4& operator*=(const basic_matrix4& other);
 
-    // Rotate this matrix
-    matrix4& rotate(scalar rads, vector3 axis);
+    // Rotate this matrix (approximately with fast_math)
+    basic_matrix4& rotate(T rads, vector_type axis);
+    basic_matrix4& rotate(T rads, vector_type axis, fast_math_t);
 
     // Invert this matrix
-    matrix4& invert();
+    basic_matrix4& invert();
 
     // Transpose this matrix
-    matrix4& transpose();
+    basic_matrix4& transpose();
 
     // Set this matrix to "look at" the target from the "eye" position
-    matrix4& look_at(const vector3& eye, const vector3& target, const vector3& up);
+    basic_matrix4& look_at(const vector_type& eye, const vector_type& target,
+        const vector_type& up);
 
-    // Set this matrix as a specified perspective
-    matrix4& perspective(scalar fovy, scalar aspect, scalar near, scalar far);
+    // Set this matrix as a specified perspective (approximately with fast_math)
+    basic_matrix4& perspective(T fovy, T aspect, T near, T far);
+    basic_matrix4& perspective(T fovy, T aspect, T near, T far, fast_math_t);
 
 public: // Information interface mthods -----------------------------
 
     // Set the values of a 3x3 matrix to the normal of this matrix
-    void set_as_normal(scalar out[9]) const;
+    void set_as_normal(T out[9]) const;
+
+    // Return a point transformed by this matrix (with the perspective divide)
+    vector_type transform_point(const vector_type& p) const;
+
+    // Return a direction transformed by this matrix (ignoring translation)
+    vector_type transform_vector(const vector_type& v) const;
+
+    // (Approximately) Compare two matrices for equality (these operators are
+    // friends, so that either side may be an expression)
+    friend bool operator==(const basic_matrix4& lhs, const basic_matrix4& rhs) {
+        for (auto i = 0u; i < 16; ++i) {
+            if (!nearly_equal(lhs.m_mat[i], rhs.m_mat[i], default_epsilon<T>())) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const basic_matrix4& lhs, const basic_matrix4& rhs) {
+        return !(lhs == rhs);
+    }
 
+    // The matrix product is written straight into the result
+    friend basic_matrix4 operator*(const basic_matrix4& lhs, const basic_matrix4& rhs) {
+        basic_matrix4 out;
+        mul_batch(&lhs, &rhs, &out, 1);
+        return out;
+    }
+
+};
+
+// A matrix is the leaf of an expression, so it is held by reference
+template <typename T>
+struct expr_traits<basic_matrix4<T>>
+{
+    using operand = const basic_matrix4<T>&;
 };
 
-// Perform typical algebraic operations on vectors
-std::ostream& operator<<(std::ostream& out, const matrix4& v);
-bool operator==(const matrix4& lhs, const matrix4& rhs);
-bool operator!=(const matrix4& lhs, const matrix4& rhs);
-matrix4 operator+(matrix4 lhs, const matrix4& rhs);
-matrix4 operator-(matrix4 lhs, const matrix4& rhs);
-matrix4 operator*(matrix4 lhs, const matrix4& rhs);
-matrix4 operator*(matrix4 lhs, scalar rhs);
-matrix4 operator*(scalar lhs, matrix4 rhs);
+// Perform typical algebraic operations on vectors (+, - and scaling are the
+// expression operators from expression.h, ==, != and the product are above)
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const basic_matrix4<T>& v);
+
+// Multiply contiguous arrays of matrices without temporaries
+template <typename T>
+void mul_batch(const basic_matrix4<T>* a, const basic_matrix4<T>* b,
+    basic_matrix4<T>* out, std::size_t count);
+
+template <typename T>
+void mul_batch(const basic_matrix4<T>* a, const basic_matrix4<T>& b,
+    basic_matrix4<T>* out, std::size_t count);
+
+template <typename T>
+void mul_batch(const basic_matrix4<T>& a, const basic_matrix4<T>* b,
+    basic_matrix4<T>* out, std::size_t count);
+
+// Transform contiguous arrays of points and directions by a matrix
+template <typename T>
+void transform_points(const basic_matrix4<T>& m, const basic_vector3<T>* in,
+    basic_vector3<T>* out, std::size_t count, bool project=false);
+
+template <typename T>
+void transform_directions(const basic_matrix4<T>& m, const basic_vector3<T>* in,
+    basic_vector3<T>* out, std::size_t count);
+
+// Both precisions are compiled once in matrix4.cpp (along with the free
+// functions above)
+extern template class basic_matrix4<float>;
+extern template class basic_matrix4<double>;
+
+using matrix4 = basic_matrix4<scalar>;
+using matrix4d = basic_matrix4<double>;
 
 
 #endif
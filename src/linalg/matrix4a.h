@@ -0,0 +1,47 @@
+
+#ifndef _MATRIX4A_H_
+#define _MATRIX4A_H_
+
+#include "linalg.h"
+#include "matrix4.h"
+#include "aligned.h"
+
+//------------------------------------------------------------------------------
+/// @brief      A matrix4 aligned to a 64-byte cache line, so a matrix is
+/// never split across two lines and each row is an aligned SIMD load. It is
+/// a matrix4 in every other way (all methods and operators apply, and the
+/// results convert back). For arrays of transforms use matrix4_array,
+/// which aligns plain matrix4 values the same way.
+///
+class alignas(64) matrix4a : public matrix4
+{
+public: // Constructors ---------------------------------------------
+
+    matrix4a() = default;
+
+    matrix4a(const matrix4& mat)
+        : matrix4(mat)
+    {}
+
+    matrix4a(const mat_array& mat)
+        : matrix4(mat)
+    {}
+
+    template <typename E>
+    matrix4a(const linalg_expr<E, 16>& e)
+        : matrix4(e)
+    {}
+
+    matrix4a clone() const {
+        return {*this};
+    }
+};
+
+static_assert(sizeof(matrix4) == 64 && sizeof(matrix4a) == 64,
+    "A matrix4 fills exactly one cache line");
+
+// Contiguous transforms with each matrix on its own cache line (this works
+// with mul_batch and the other batch kernels as is)
+using matrix4_array = aligned_vector<matrix4, 64>;
+
+#endif
@@ -0,0 +1,78 @@
+
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <algorithm>
+#include <cstddef>
+
+// Emscripten only has threads when built with -pthread
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#   define LINALG_NO_THREADS
+#endif
+
+#if !defined(LINALG_NO_THREADS)
+#   include <system_error>
+#   include <thread>
+#   include <vector>
+
+// Joins its threads when it goes out of scope, so an exception on the
+// calling thread never destroys a thread that is still joinable
+struct thread_joiner
+{
+    std::vector<std::thread> m_threads;
+
+    ~thread_joiner() {
+        for (auto& t : m_threads) {
+            t.join();
+        }
+    }
+};
+#endif
+
+//------------------------------------------------------------------------------
+/// @brief      Split [0, count) into contiguous ranges and call f(begin, end)
+/// for each one on its own thread. Work smaller than min_per_thread items
+/// per thread is not worth a thread, so small counts (and builds without
+/// threads) simply call f(0, count) on the calling thread. If a thread cannot
+/// be started, the rest of the range runs on the calling thread, and the
+/// started threads are joined even if f throws there.
+///
+/// @param[in]  count           The number of items
+/// @param[in]  min_per_thread  The smallest number of items given to a thread
+/// @param[in]  f               The function called with each range
+///
+template <typename F>
+void parallel_for(std::size_t count, std::size_t min_per_thread, F f)
+{
+#if !defined(LINALG_NO_THREADS)
+    // Querying the core count is a system call, so only do it once
+    static const std::size_t hw = std::max(std::thread::hardware_concurrency(), 1u);
+    std::size_t threads = count / std::max(min_per_thread, std::size_t{1});
+    threads = (threads > 1) ? std::min(hw, threads) : threads;
+
+    if (threads > 1) {
+        // Keep ranges a multiple of four so the SIMD kernels have no tails
+        auto per_thread = ((count + threads - 1) / threads + 3) & ~std::size_t{3};
+
+        thread_joiner workers;
+        workers.m_threads.reserve(threads - 1);
+        std::size_t begin = 0;
+        while (begin + per_thread < count) {
+            try {
+                workers.m_threads.emplace_back(f, begin, begin + per_thread);
+            }
+            catch (const std::system_error&) {
+                break;
+            }
+            begin += per_thread;
+        }
+        f(begin, count);
+        return;
+    }
+#else
+    (void)min_per_thread;
+#endif
+    f(std::size_t{0}, count);
+}
+
+#endif
@@ -0,0 +1,260 @@
+
+#include "quat.h"
+
+#include <iostream>
+#include <cmath>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Set to the identity rotation
+///
+/// @return     the updated quaternion
+///
+quat& quat::id() {
+    m_quat = {{0, 0, 0, 1}};
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set to a rotation of rads around axis (counter-clockwise when
+/// looking down the axis, as with matrix4::rotate)
+///
+/// @param[in]  rads  The angle to rotate by (in radians)
+/// @param[in]  axis  The axis to rotate around
+///
+/// @return     the updated quaternion
+///
+quat& quat::axis_angle(scalar rads, vector3 axis) {
+    if (nearly_equal(axis.len(), 0)) {
+        return id();
+    }
+    axis.normalize();
+
+    auto s = std::sin(rads / 2);
+    m_quat = {{axis.x() * s, axis.y() * s, axis.z() * s, std::cos(rads / 2)}};
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply this rotation by another. As with matrix4::mul, this
+/// rotation is applied first and then the other one (so this is the
+/// Hamilton product other * this).
+///
+/// @param[in]  other  The other rotation
+///
+/// @return     the updated quaternion
+///
+quat& quat::mul(const quat& other) {
+    auto ax = m_quat[0], ay = m_quat[1], az = m_quat[2], aw = m_quat[3],
+         bx = other.m_quat[0], by = other.m_quat[1],
+         bz = other.m_quat[2], bw = other.m_quat[3];
+
+    m_quat[0] = bw * ax + bx * aw + by * az - bz * ay;
+    m_quat[1] = bw * ay - bx * az + by * aw + bz * ax;
+    m_quat[2] = bw * az + bx * ay - by * ax + bz * aw;
+    m_quat[3] = bw * aw - bx * ax - by * ay - bz * az;
+    return *this;
+}
+quat& quat::operator*=(const quat& other) {
+    return mul(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Normalize this quaternion
+///
+/// @return     the updated quaternion
+///
+quat& quat::normalize() {
+    auto len_squared = len2();
+    if (len_squared > 0) {
+        auto s = 1 / std::sqrt(len_squared);
+        m_quat[0] *= s;
+        m_quat[1] *= s;
+        m_quat[2] *= s;
+        m_quat[3] *= s;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Conjugate this quaternion (the inverse of a unit quaternion)
+///
+/// @return     the updated quaternion
+///
+quat& quat::conjugate() {
+    m_quat[0] = -m_quat[0];
+    m_quat[1] = -m_quat[1];
+    m_quat[2] = -m_quat[2];
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert this quaternion
+///
+/// @return     the updated quaternion (unchanged if it has zero length)
+///
+quat& quat::invert() {
+    auto len_squared = len2();
+    if (nearly_equal(len_squared, 0)) {
+        return *this;
+    }
+    conjugate();
+
+    auto s = 1 / len_squared;
+    m_quat[0] *= s;
+    m_quat[1] *= s;
+    m_quat[2] *= s;
+    m_quat[3] *= s;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Normalized linear interpolation between this and another
+/// rotation (along the shorter path). This is much cheaper than slerp and
+/// close to it for small angles.
+///
+/// @param[in]  other  The other rotation
+/// @param[in]  alpha  The interpolation ratio [0, 1]
+///
+/// @return     the updated quaternion
+///
+quat& quat::nlerp(const quat& other, scalar alpha) {
+    auto b = dot(other) < 0 ? -alpha : alpha;
+    auto a = 1 - alpha;
+    m_quat[0] = m_quat[0] * a + other.m_quat[0] * b;
+    m_quat[1] = m_quat[1] * a + other.m_quat[1] * b;
+    m_quat[2] = m_quat[2] * a + other.m_quat[2] * b;
+    m_quat[3] = m_quat[3] * a + other.m_quat[3] * b;
+    return normalize();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Spherical linear interpolation between this and another
+/// rotation (along the shorter path)
+///
+/// @param[in]  other  The other rotation
+/// @param[in]  alpha  The interpolation ratio [0, 1]
+///
+/// @return     the updated quaternion
+///
+quat& quat::slerp(const quat& other, scalar alpha) {
+    auto cos_theta = dot(other);
+    scalar sign = 1;
+    if (cos_theta < 0) {
+        cos_theta = -cos_theta;
+        sign = -1;
+    }
+
+    // Nearly parallel, so sin(theta) is too small to divide by
+    if (cos_theta > static_cast<scalar>(0.9995)) {
+        return nlerp(other, alpha);
+    }
+
+    auto theta = std::acos(cos_theta);
+    auto sin_inv = 1 / std::sin(theta);
+    auto a = std::sin((1 - alpha) * theta) * sin_inv,
+         b = std::sin(alpha * theta) * sin_inv * sign;
+
+    m_quat[0] = m_quat[0] * a + other.m_quat[0] * b;
+    m_quat[1] = m_quat[1] * a + other.m_quat[1] * b;
+    m_quat[2] = m_quat[2] * a + other.m_quat[2] * b;
+    m_quat[3] = m_quat[3] * a + other.m_quat[3] * b;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the magnitude/length of this quaternion
+///
+/// @return     the length of this quaternion
+///
+scalar quat::len() const {
+    return std::sqrt(len2());
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the squared magnitude/length of this quaternion
+///
+/// @return     the squared length of this quaternion
+///
+scalar quat::len2() const {
+    return dot(*this);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the dot product of this quaternion with another
+///
+/// @param[in]  other  The other quaternion
+///
+/// @return     the dot product between two quaternions
+///
+scalar quat::dot(const quat& other) const {
+    return m_quat[0] * other.m_quat[0]
+         + m_quat[1] * other.m_quat[1]
+         + m_quat[2] * other.m_quat[2]
+         + m_quat[3] * other.m_quat[3];
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return a vector rotated by this (unit) quaternion, using
+/// v + w * t + u x t with t = 2 * (u x v) (15 multiplies, no matrix)
+///
+/// @param[in]  v     The vector to rotate
+///
+/// @return     the rotated vector
+///
+vector3 quat::rotate_vector(const vector3& v) const {
+    auto qx = m_quat[0], qy = m_quat[1], qz = m_quat[2], qw = m_quat[3];
+
+    auto tx = 2 * (qy * v.z() - qz * v.y()),
+         ty = 2 * (qz * v.x() - qx * v.z()),
+         tz = 2 * (qx * v.y() - qy * v.x());
+
+    return {
+        v.x() + qw * tx + (qy * tz - qz * ty),
+        v.y() + qw * ty + (qz * tx - qx * tz),
+        v.z() + qw * tz + (qx * ty - qy * tx)
+    };
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the rotation matrix of this (unit) quaternion
+///
+/// @return     the rotation matrix
+///
+matrix4 quat::to_matrix4() const {
+    auto x = m_quat[0], y = m_quat[1], z = m_quat[2], w = m_quat[3];
+    auto x2 = x + x, y2 = y + y, z2 = z + z,
+         xx = x * x2, xy = x * y2, xz = x * z2,
+         yy = y * y2, yz = y * z2, zz = z * z2,
+         wx = w * x2, wy = w * y2, wz = w * z2;
+
+    return {mat_array{{
+        1 - (yy + zz), xy + wz,       xz - wy,       0,
+        xy - wz,       1 - (xx + zz), yz + wx,       0,
+        xz + wy,       yz - wx,       1 - (xx + yy), 0,
+        0,             0,             0,             1 }}};
+}
+
+// Insertion operator for the quat class
+std::ostream& operator<<(std::ostream& out, const quat& q) {
+    out << "[ "
+        << ScalarFmt() << q.m_quat[0] << "  "
+        << ScalarFmt() << q.m_quat[1] << "  "
+        << ScalarFmt() << q.m_quat[2] << "  "
+        << ScalarFmt() << q.m_quat[3] << " ]";
+    return out;
+}
+
+// (Approximately) Compare two quaternions for equality
+bool operator==(const quat& lhs, const quat& rhs) {
+    return nearly_equal(lhs.m_quat[0], rhs.m_quat[0])
+        && nearly_equal(lhs.m_quat[1], rhs.m_quat[1])
+        && nearly_equal(lhs.m_quat[2], rhs.m_quat[2])
+        && nearly_equal(lhs.m_quat[3], rhs.m_quat[3]);
+}
+bool operator!=(const quat& lhs, const quat& rhs) { return !operator==(lhs,rhs); }
+
+// Compose two rotations (lhs is applied first)
+quat operator*(const quat& lhs, const quat& rhs) {
+    return lhs.clone().mul(rhs);
+}
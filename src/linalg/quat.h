@@ -0,0 +1,106 @@
+
+#ifndef _QUAT_H_
+#define _QUAT_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "matrix4.h"
+
+#include <iosfwd>
+#include <array>
+
+using quat_array = std::array<scalar, 4>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines a quaternion (x, y, z, w) that is used to
+/// represent rotations. The conventions match matrix4::rotate, so
+/// quat().axis_angle(rads, axis).to_matrix4() equals matrix4().rotate(rads, axis).
+///
+class quat
+{
+public:
+    quat_array m_quat;
+
+public: // Constructors ---------------------------------------------
+
+    quat()
+        : m_quat{{0, 0, 0, 1}}
+    {}
+
+    quat(const quat_array& q)
+        : m_quat(q)
+    {}
+
+    quat(scalar x, scalar y, scalar z, scalar w)
+        : m_quat{{x, y, z, w}}
+    {}
+
+    quat clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    scalar& x() { return m_quat[0]; };
+    scalar& y() { return m_quat[1]; };
+    scalar& z() { return m_quat[2]; };
+    scalar& w() { return m_quat[3]; };
+
+    scalar x() const { return m_quat[0]; };
+    scalar y() const { return m_quat[1]; };
+    scalar z() const { return m_quat[2]; };
+    scalar w() const { return m_quat[3]; };
+
+public: // Mutating interface methods -------------------------------
+
+    // Set to the identity rotation
+    quat& id();
+
+    // Set to a rotation of rads around axis
+    quat& axis_angle(scalar rads, vector3 axis);
+
+    // Multiply this rotation (this is applied first, then other)
+    quat& mul(const quat& other);
+    quat& operator*=(const quat& other);
+
+    // Normalize this quaternion
+    quat& normalize();
+
+    // Conjugate this quaternion (the inverse of a unit quaternion)
+    quat& conjugate();
+
+    // Invert this quaternion
+    quat& invert();
+
+    // Normalized linear interpolation between this and another rotation
+    quat& nlerp(const quat& other, scalar alpha=0.5);
+
+    // Spherical linear interpolation between this and another rotation
+    quat& slerp(const quat& other, scalar alpha=0.5);
+
+public: // Information interface mthods -----------------------------
+
+    // Return the magnitude/length of this quaternion
+    scalar len() const;
+
+    // Return the squared magnitude/length of this quaternion
+    scalar len2() const;
+
+    // Return the dot product of this quaternion with another
+    scalar dot(const quat& other) const;
+
+    // Return a vector rotated by this (unit) quaternion
+    vector3 rotate_vector(const vector3& v) const;
+
+    // Return the rotation matrix of this (unit) quaternion
+    matrix4 to_matrix4() const;
+
+};
+
+// Perform typical algebraic operations on quaternions
+std::ostream& operator<<(std::ostream& out, const quat& q);
+bool operator==(const quat& lhs, const quat& rhs);
+bool operator!=(const quat& lhs, const quat& rhs);
+quat operator*(const quat& lhs, const quat& rhs);
+
+#endif
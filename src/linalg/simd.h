@@ -0,0 +1,171 @@
+
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#include "linalg.h"
+
+#include <type_traits>
+
+//------------------------------------------------------------------------------
+// Select a 4-wide SIMD backend at build time. Emscripten builds get wasm
+// simd128 when compiled with -msimd128, native builds get SSE. Defining
+// LINALG_NO_SIMD (the LINALG_SIMD=OFF cmake option) forces the scalar code.
+//
+#if !defined(LINALG_NO_SIMD)
+#   if defined(__wasm_simd128__)
+#       include <wasm_simd128.h>
+#       define LINALG_SIMD_WASM
+#   elif defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+#       include <xmmintrin.h>
+#       if defined(__FMA__)
+#           include <immintrin.h>
+#       endif
+#       define LINALG_SIMD_SSE
+#   endif
+#endif
+
+#if defined(LINALG_SIMD_WASM) || defined(LINALG_SIMD_SSE)
+#   define LINALG_SIMD
+
+static_assert(std::is_same<scalar, float>::value,
+    "The linalg SIMD backend requires scalar = float (define LINALG_NO_SIMD)");
+
+
+//------------------------------------------------------------------------------
+/// @brief      A thin layer over the 4-wide float intrinsics so that the
+/// linalg code is written once for both SSE and wasm simd128. The plain
+/// loads and stores are unaligned since mat_array and vec_array are only
+/// 4-byte aligned; the _aligned versions need 16-byte aligned pointers.
+///
+namespace simd
+{
+
+#if defined(LINALG_SIMD_SSE)
+
+using f32x4 = __m128;
+
+inline f32x4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, f32x4 v) { _mm_storeu_ps(p, v); }
+inline f32x4 load_aligned(const float* p) { return _mm_load_ps(p); }
+inline void store_aligned(float* p, f32x4 v) { _mm_store_ps(p, v); }
+inline f32x4 splat(float s) { return _mm_set1_ps(s); }
+inline f32x4 set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+inline float first(f32x4 v) { return _mm_cvtss_f32(v); }
+
+inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+inline f32x4 div(f32x4 a, f32x4 b) { return _mm_div_ps(a, b); }
+inline f32x4 sqrt(f32x4 a) { return _mm_sqrt_ps(a); }
+inline f32x4 min(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+
+// Comparisons give a mask of all ones (true) or zeros (false) per lane
+inline f32x4 gt(f32x4 a, f32x4 b) { return _mm_cmpgt_ps(a, b); }
+inline f32x4 lt(f32x4 a, f32x4 b) { return _mm_cmplt_ps(a, b); }
+inline f32x4 neq(f32x4 a, f32x4 b) { return _mm_cmpneq_ps(a, b); }
+
+// mask ? a : b (per lane)
+inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// One bit per lane of a mask (lane 0 is the lowest bit)
+inline int bitmask(f32x4 mask) { return _mm_movemask_ps(mask); }
+
+// a * b + c
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) {
+#if defined(__FMA__)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// (x[a], x[b], y[c], y[d])
+template <int a, int b, int c, int d>
+inline f32x4 shuffle(f32x4 x, f32x4 y) {
+    return _mm_shuffle_ps(x, y, _MM_SHUFFLE(d, c, b, a));
+}
+
+#elif defined(LINALG_SIMD_WASM)
+
+using f32x4 = v128_t;
+
+inline f32x4 load(const float* p) { return wasm_v128_load(p); }
+inline void store(float* p, f32x4 v) { wasm_v128_store(p, v); }
+inline f32x4 load_aligned(const float* p) { return wasm_v128_load(p); }
+inline void store_aligned(float* p, f32x4 v) { wasm_v128_store(p, v); }
+inline f32x4 splat(float s) { return wasm_f32x4_splat(s); }
+inline f32x4 set(float a, float b, float c, float d) { return wasm_f32x4_make(a, b, c, d); }
+inline float first(f32x4 v) { return wasm_f32x4_extract_lane(v, 0); }
+
+inline f32x4 add(f32x4 a, f32x4 b) { return wasm_f32x4_add(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return wasm_f32x4_sub(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return wasm_f32x4_mul(a, b); }
+inline f32x4 div(f32x4 a, f32x4 b) { return wasm_f32x4_div(a, b); }
+inline f32x4 sqrt(f32x4 a) { return wasm_f32x4_sqrt(a); }
+inline f32x4 min(f32x4 a, f32x4 b) { return wasm_f32x4_pmin(a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return wasm_f32x4_pmax(a, b); }
+
+// Comparisons give a mask of all ones (true) or zeros (false) per lane
+inline f32x4 gt(f32x4 a, f32x4 b) { return wasm_f32x4_gt(a, b); }
+inline f32x4 lt(f32x4 a, f32x4 b) { return wasm_f32x4_lt(a, b); }
+inline f32x4 neq(f32x4 a, f32x4 b) { return wasm_f32x4_ne(a, b); }
+
+// mask ? a : b (per lane)
+inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) {
+    return wasm_v128_bitselect(a, b, mask);
+}
+
+// One bit per lane of a mask (lane 0 is the lowest bit)
+inline int bitmask(f32x4 mask) { return static_cast<int>(wasm_i32x4_bitmask(mask)); }
+
+// a * b + c
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) {
+    return wasm_f32x4_add(wasm_f32x4_mul(a, b), c);
+}
+
+// (x[a], x[b], y[c], y[d])
+template <int a, int b, int c, int d>
+inline f32x4 shuffle(f32x4 x, f32x4 y) {
+    return wasm_i32x4_shuffle(x, y, a, b, c + 4, d + 4);
+}
+
+#endif
+
+// (v[a], v[b], v[c], v[d])
+template <int a, int b, int c, int d>
+inline f32x4 swizzle(f32x4 v) {
+    return shuffle<a, b, c, d>(v, v);
+}
+
+// Broadcast a single lane
+template <int i>
+inline f32x4 lane(f32x4 v) {
+    return shuffle<i, i, i, i>(v, v);
+}
+
+// Broadcast the sum of all four lanes
+inline f32x4 hsum(f32x4 v) {
+    v = add(v, swizzle<2, 3, 0, 1>(v));
+    return add(v, swizzle<1, 0, 3, 2>(v));
+}
+
+// Transpose four rows in place
+inline void transpose(f32x4& r0, f32x4& r1, f32x4& r2, f32x4& r3) {
+    auto t0 = shuffle<0, 1, 0, 1>(r0, r1),
+         t1 = shuffle<2, 3, 2, 3>(r0, r1),
+         t2 = shuffle<0, 1, 0, 1>(r2, r3),
+         t3 = shuffle<2, 3, 2, 3>(r2, r3);
+    r0 = shuffle<0, 2, 0, 2>(t0, t2);
+    r1 = shuffle<1, 3, 1, 3>(t0, t2);
+    r2 = shuffle<0, 2, 0, 2>(t1, t3);
+    r3 = shuffle<1, 3, 1, 3>(t1, t3);
+}
+
+} // namespace simd
+
+#endif // LINALG_SIMD_WASM || LINALG_SIMD_SSE
+
+#endif
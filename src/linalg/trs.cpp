@@ -0,0 +1,127 @@
+
+#include "trs.h"
+
+#include <iostream>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Set to the identity transform
+///
+/// @return     the updated transform
+///
+trs& trs::id() {
+    m_rot.id();
+    m_pos.zero();
+    m_scale = 1;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply this transform by another. As with matrix4::mul,
+/// this transform is applied first and then the other one, so
+/// a.mul(b).to_matrix4() equals a.to_matrix4().mul(b.to_matrix4()). The
+/// rotation is renormalized so that it does not drift over many products.
+///
+/// @param[in]  other  The other transform
+///
+/// @return     the updated transform
+///
+trs& trs::mul(const trs& other) {
+    m_pos = other.m_rot.rotate_vector(m_pos * other.m_scale) + other.m_pos;
+    m_rot.mul(other.m_rot).normalize();
+    m_scale *= other.m_scale;
+    return *this;
+}
+trs& trs::operator*=(const trs& other) {
+    return mul(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Invert this transform
+///
+/// @return     the updated transform (unchanged if the scale is zero)
+///
+trs& trs::invert() {
+    if (nearly_equal(m_scale, 0)) {
+        return *this;
+    }
+    m_scale = 1 / m_scale;
+    m_rot.conjugate();
+    m_pos = m_rot.rotate_vector(m_pos) * -m_scale;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Interpolate between this and another transform. The
+/// translation and scale are interpolated linearly and the rotation with
+/// nlerp (use quat::slerp directly for constant angular velocity).
+///
+/// @param[in]  other  The other transform
+/// @param[in]  alpha  The interpolation ratio [0, 1]
+///
+/// @return     the updated transform
+///
+trs& trs::lerp(const trs& other, scalar alpha) {
+    m_pos.lerp(other.m_pos, alpha);
+    m_rot.nlerp(other.m_rot, alpha);
+    m_scale += (other.m_scale - m_scale) * alpha;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return a point transformed by this transform
+///
+/// @param[in]  p     The point
+///
+/// @return     the transformed point
+///
+vector3 trs::transform_point(const vector3& p) const {
+    return m_rot.rotate_vector(p * m_scale) + m_pos;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return a direction transformed by this transform (the
+/// translation is ignored)
+///
+/// @param[in]  v     The direction
+///
+/// @return     the transformed direction
+///
+vector3 trs::transform_vector(const vector3& v) const {
+    return m_rot.rotate_vector(v * m_scale);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the equivalent matrix4 (e.g. to upload as a uniform)
+///
+/// @return     the scaled rotation matrix with the translation in the last row
+///
+matrix4 trs::to_matrix4() const {
+    auto m = m_rot.to_matrix4();
+    for (auto i = 0u; i < 12; ++i) {
+        m.m_mat[i] *= m_scale;
+    }
+    m.m_mat[12] = m_pos.x();
+    m.m_mat[13] = m_pos.y();
+    m.m_mat[14] = m_pos.z();
+    return m;
+}
+
+// Insertion operator for the trs class
+std::ostream& operator<<(std::ostream& out, const trs& t) {
+    out << "[ " << t.m_rot << "  " << t.m_pos << "  " << ScalarFmt() << t.m_scale << " ]";
+    return out;
+}
+
+// (Approximately) Compare two transforms for equality
+bool operator==(const trs& lhs, const trs& rhs) {
+    return lhs.m_rot == rhs.m_rot
+        && lhs.m_pos == rhs.m_pos
+        && nearly_equal(lhs.m_scale, rhs.m_scale);
+}
+bool operator!=(const trs& lhs, const trs& rhs) { return !operator==(lhs,rhs); }
+
+// Compose two transforms (lhs is applied first)
+trs operator*(const trs& lhs, const trs& rhs) {
+    return lhs.clone().mul(rhs);
+}
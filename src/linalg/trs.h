@@ -0,0 +1,77 @@
+
+#ifndef _TRS_H_
+#define _TRS_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "matrix4.h"
+#include "quat.h"
+
+#include <iosfwd>
+
+//------------------------------------------------------------------------------
+/// @brief      A compact transform made of a uniform scale, a rotation and a
+/// translation (applied in that order). It is cheaper to compose and
+/// interpolate than a matrix4, and is only converted to a matrix4 when it
+/// is uploaded.
+///
+class trs
+{
+public:
+    quat m_rot;
+    vector3 m_pos;
+    scalar m_scale;
+
+public: // Constructors ---------------------------------------------
+
+    trs()
+        : m_rot()
+        , m_pos()
+        , m_scale(1)
+    {}
+
+    trs(const quat& rot, const vector3& pos, scalar scale=1)
+        : m_rot(rot)
+        , m_pos(pos)
+        , m_scale(scale)
+    {}
+
+    trs clone() const {
+        return {*this};
+    }
+
+public: // Interface methods ----------------------------------------
+
+    // Set to the identity transform
+    trs& id();
+
+    // Multiply this transform (this is applied first, then other)
+    trs& mul(const trs& other);
+    trs& operator*=(const trs& other);
+
+    // Invert this transform
+    trs& invert();
+
+    // Interpolate between this and another transform
+    trs& lerp(const trs& other, scalar alpha=0.5);
+
+public: // Information interface mthods -----------------------------
+
+    // Return a point transformed by this transform
+    vector3 transform_point(const vector3& p) const;
+
+    // Return a direction transformed by this transform (no translation)
+    vector3 transform_vector(const vector3& v) const;
+
+    // Return the equivalent matrix4 (e.g. to upload as a uniform)
+    matrix4 to_matrix4() const;
+
+};
+
+// Perform typical algebraic operations on transforms
+std::ostream& operator<<(std::ostream& out, const trs& t);
+bool operator==(const trs& lhs, const trs& rhs);
+bool operator!=(const trs& lhs, const trs& rhs);
+trs operator*(const trs& lhs, const trs& rhs);
+
+#endif
@@ -10,7 +10,8 @@
 ///
 /// @return     return the updated vector3
 ///
-vector3& vector3::zero() {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::zero() {
     m_vec = {{0, 0, 0}};
     return *this;
 }
@@ -24,7 +25,8 @@ vector3& vector3::zero() {
 ///
 /// @return     return the updated vector
 ///
-vector3& vector3::set(scalar x, scalar y, scalar z) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::set(T x, T y, T z) {
     m_vec = {{x, y, z}};
     return *this;
 }
@@ -36,13 +38,15 @@ vector3& vector3::set(scalar x, scalar y, scalar z) {
 ///
 /// @return     return the updated vector
 ///
-vector3& vector3::add(const vector3& other) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::add(const basic_vector3& other) {
     m_vec[0] += other.m_vec[0];
     m_vec[1] += other.m_vec[1];
     m_vec[2] += other.m_vec[2];
     return *this;
 }
-vector3& vector3::operator+=(const vector3& other) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::operator+=(const basic_vector3& other) {
     return add(other);
 }
 
@@ -53,13 +57,15 @@ vector3& vector3::operator+=(const vector3& other) {
 ///
 /// @return     return the updated vector
 ///
-vector3& vector3::sub(const vector3& other) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::sub(const basic_vector3& other) {
     m_vec[0] -= other.m_vec[0];
     m_vec[1] -= other.m_vec[1];
     m_vec[2] -= other.m_vec[2];
     return *this;
 }
-vector3& vector3::operator-=(const vector3& other) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::operator-=(const basic_vector3& other) {
     return sub(other);
 }
 
@@ -70,13 +76,15 @@ vector3& vector3::operator-=(const vector3& other) {
 ///
 /// @return     return the updated vector
 ///
-vector3& vector3::scale(scalar s) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::scale(T s) {
     m_vec[0] *= s;
     m_vec[1] *= s;
     m_vec[2] *= s;
     return *this;
 }
-vector3& vector3::operator*=(scalar s) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::operator*=(T s) {
     return scale(s);
 }
 
@@ -85,12 +93,32 @@ vector3& vector3::operator*=(scalar s) {
 ///
 /// @return     the updated vector
 ///
-vector3& vector3::normalize() {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::normalize() {
+#if defined(LINALG_FAST_MATH)
+    return normalize(fast_math);
+#else
     auto len_squared = len2();
     if (len_squared > 0) {
         scale(1 / std::sqrt(len_squared));
     }
     return *this;
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Normalize this vector with an approximate reciprocal square
+/// root (see fast_math.h for the error)
+///
+/// @return     the updated vector
+///
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::normalize(fast_math_t) {
+    auto len_squared = len2();
+    if (len_squared > 0) {
+        scale(fast_rsqrt(len_squared));
+    }
+    return *this;
 }
 
 //------------------------------------------------------------------------------
@@ -100,7 +128,8 @@ vector3& vector3::normalize() {
 ///
 /// @return     the updated vector
 ///
-vector3& vector3::cross(const vector3& other) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::cross(const basic_vector3& other) {
     auto ax = m_vec[0], ay = m_vec[1], az = m_vec[2],
          bx = other.m_vec[0], by = other.m_vec[1], bz = other.m_vec[2];
     m_vec[0] = ay * bz - az * by;
@@ -117,7 +146,8 @@ vector3& vector3::cross(const vector3& other) {
 ///
 /// @return     the updated vector3
 ///
-vector3& vector3::lerp(const vector3& other, scalar alpha) {
+template <typename T>
+basic_vector3<T>& basic_vector3<T>::lerp(const basic_vector3& other, T alpha) {
     m_vec[0] += (other.m_vec[0] - m_vec[0]) * alpha;
     m_vec[1] += (other.m_vec[1] - m_vec[1]) * alpha;
     m_vec[2] += (other.m_vec[2] - m_vec[2]) * alpha;
@@ -129,8 +159,25 @@ vector3& vector3::lerp(const vector3& other, scalar alpha) {
 ///
 /// @return     the length of this vector
 ///
-scalar vector3::len() const {
+template <typename T>
+T basic_vector3<T>::len() const {
+#if defined(LINALG_FAST_MATH)
+    return len(fast_math);
+#else
     return std::sqrt(len2());
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the approximate magnitude/length of this vector (see
+/// fast_math.h for the error)
+///
+/// @return     the length of this vector
+///
+template <typename T>
+T basic_vector3<T>::len(fast_math_t) const {
+    auto len_squared = len2();
+    return len_squared > 0 ? len_squared * fast_rsqrt(len_squared) : T(0);
 }
 
 //------------------------------------------------------------------------------
@@ -138,7 +185,8 @@ scalar vector3::len() const {
 ///
 /// @return     the squared length of this vector
 ///
-scalar vector3::len2() const {
+template <typename T>
+T basic_vector3<T>::len2() const {
     return dot(*this);
 }
 
@@ -149,14 +197,16 @@ scalar vector3::len2() const {
 ///
 /// @return     the dot product between two vectors
 ///
-scalar vector3::dot(const vector3& other) const {
+template <typename T>
+T basic_vector3<T>::dot(const basic_vector3& other) const {
     return m_vec[0] * other.m_vec[0]
          + m_vec[1] * other.m_vec[1]
          + m_vec[2] * other.m_vec[2];
 }
 
 // Insertion operator for the vector3 class
-std::ostream& operator<<(std::ostream& out, const vector3& v) {
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const basic_vector3<T>& v) {
     out << "[ "
         << ScalarFmt() << v.m_vec[0] << "  "
         << ScalarFmt() << v.m_vec[1] << "  "
@@ -164,16 +214,7 @@ std::ostream& operator<<(std::ostream& out, const vector3& v) {
     return out;
 }
 
-// (Approximately) Compare two vectors for equality
-bool operator==(const vector3& lhs, const vector3& rhs) {
-    return nearly_equal(lhs.m_vec[0], rhs.m_vec[0])
-        && nearly_equal(lhs.m_vec[1], rhs.m_vec[1])
-        && nearly_equal(lhs.m_vec[2], rhs.m_vec[2]);
-}
-bool operator!=(const vector3& lhs, const vector3& rhs) { return !operator==(lhs,rhs); }
-
-// Perform typical algebraic operations on vectors
-vector3 operator+(vector3 lhs, const vector3& rhs) { return lhs += rhs; }
-vector3 operator-(vector3 lhs, const vector3& rhs) { return lhs -= rhs; }
-vector3 operator*(vector3 lhs, scalar rhs) { return lhs *= rhs; }
-vector3 operator*(scalar lhs, vector3 rhs) { return rhs *= lhs; }
+template class basic_vector3<float>;
+template class basic_vector3<double>;
+template std::ostream& operator<<(std::ostream&, const basic_vector3<float>&);
+template std::ostream& operator<<(std::ostream&, const basic_vector3<double>&);
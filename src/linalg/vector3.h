@@ -3,98 +3,169 @@
 #define _VECTOR3_H_
 
 #include "linalg.h"
+#include "expression.h"
+#include "fast_math.h"
 
 #include <iosfwd>
 #include <array>
+#include <cstddef>
+#include <type_traits>
 
 using vec_array = std::array<scalar, 3>;
 
 //------------------------------------------------------------------------------
 /// @brief      This class defines a three dimentional vector that can be
-/// used to perform linear algebra operations.
+/// used to perform linear algebra operations. It is templated on the
+/// precision, which is fixed at compile time: vector3 is the float vector
+/// used everywhere else and vector3d is the double precision version (for
+/// example for world-space positions far from the origin).
 ///
-class vector3
+template <typename T>
+class basic_vector3 : public linalg_expr<basic_vector3<T>, 3>
 {
 public:
-    vec_array m_vec;
+    using value_type = T;
+    using array_type = std::array<T, 3>;
+
+    array_type m_vec;
 
 public: // Constructors ---------------------------------------------
 
-    vector3()
+    constexpr basic_vector3()
         : m_vec{{0, 0, 0}}
     {}
 
-    vector3(const vec_array& vec)
+    constexpr basic_vector3(const array_type& vec)
         : m_vec(vec)
     {}
 
-    vector3(scalar x, scalar y, scalar z)
+    constexpr basic_vector3(T x, T y, T z)
         : m_vec{{x, y, z}}
     {}
 
-    vector3 clone() const {
+    // Convert from another precision (explicit, since it may lose precision)
+    template <typename U>
+    constexpr explicit basic_vector3(const basic_vector3<U>& v)
+        : m_vec{{static_cast<T>(v.m_vec[0]), static_cast<T>(v.m_vec[1]),
+                 static_cast<T>(v.m_vec[2])}}
+    {}
+
+    // Evaluate an expression (e.g. a + b * s - c) in a single pass
+    // (only expressions of the same precision convert implicitly)
+    template <typename E, typename = std::enable_if_t<
+        std::is_same<typename E::value_type, T>::value>>
+    constexpr basic_vector3(const linalg_expr<E, 3>& e)
+        : m_vec{{e.self()[0], e.self()[1], e.self()[2]}}
+    {}
+
+    template <typename E>
+    basic_vector3& operator=(const linalg_expr<E, 3>& e) {
+        static_assert(std::is_same<typename E::value_type, T>::value,
+            "The expression has a different precision");
+        return set(e.self()[0], e.self()[1], e.self()[2]);
+    }
+
+    constexpr basic_vector3 clone() const {
         return {*this};
     }
 
 public: // Accessor methods -----------------------------------------
 
-    scalar& x() { return m_vec[0]; };
-    scalar& y() { return m_vec[1]; };
-    scalar& z() { return m_vec[2]; };
+    T& x() { return m_vec[0]; };
+    T& y() { return m_vec[1]; };
+    T& z() { return m_vec[2]; };
+
+    constexpr T x() const { return m_vec[0]; };
+    constexpr T y() const { return m_vec[1]; };
+    constexpr T z() const { return m_vec[2]; };
 
-    scalar x() const { return m_vec[0]; };
-    scalar y() const { return m_vec[1]; };
-    scalar z() const { return m_vec[2]; };
+    constexpr T operator[](std::size_t i) const { return m_vec[i]; }
 
 public: // Mutating interface methods -------------------------------
 
     // Set all values to zero
-    vector3& zero();
+    basic_vector3& zero();
 
     // Set all values to the given values
-    vector3& set(scalar x, scalar y, scalar z);
+    basic_vector3& set(T x, T y, T z);
 
     // Add another vector3 to this vector
-    vector3& add(const vector3& other);
-    vector3& operator+=(const vector3& other);
+    basic_vector3& add(const basic_vector3& other);
+    basic_vector3& operator+=(const basic_vector3& other);
+
+    template <typename E>
+    basic_vector3& operator+=(const linalg_expr<E, 3>& e) {
+        const auto& ex = e.self();
+        return set(m_vec[0] + ex[0], m_vec[1] + ex[1], m_vec[2] + ex[2]);
+    }
 
     // Subtract another vector3 from this vector
-    vector3& sub(const vector3& other);
-    vector3& operator-=(const vector3& other);
+    basic_vector3& sub(const basic_vector3& other);
+    basic_vector3& operator-=(const basic_vector3& other);
+
+    template <typename E>
+    basic_vector3& operator-=(const linalg_expr<E, 3>& e) {
+        const auto& ex = e.self();
+        return set(m_vec[0] - ex[0], m_vec[1] - ex[1], m_vec[2] - ex[2]);
+    }
 
     // Scale this vector
-    vector3& scale(scalar s);
-    vector3& operator*=(scalar s);
+    basic_vector3& scale(T s);
+    basic_vector3& operator*=(T s);
 
-    // Normalize this vector
-    vector3& normalize();
+    // Normalize this vector (approximately with fast_math)
+    basic_vector3& normalize();
+    basic_vector3& normalize(fast_math_t);
 
     // Cross product this vector with another vector
-    vector3& cross(const vector3& other);
+    basic_vector3& cross(const basic_vector3& other);
 
     // Linearly interpolate between this and another vector
-    vector3& lerp(const vector3& other, scalar alpha=0.5);
+    basic_vector3& lerp(const basic_vector3& other, T alpha=0.5);
 
 public: // Information interface mthods -----------------------------
 
-    // Return the magnitude/length of this vector
-    scalar len() const;
+    // Return the magnitude/length of this vector (approximately with fast_math)
+    T len() const;
+    T len(fast_math_t) const;
 
     // Return the squared magnitude/length of this vector
-    scalar len2() const;
+    T len2() const;
 
     // Return the dot product of this vector with another vector
-    scalar dot(const vector3& other) const;
+    T dot(const basic_vector3& other) const;
+
+    // (Approximately) Compare two vectors for equality (friends, so that
+    // either side may be an expression)
+    friend bool operator==(const basic_vector3& lhs, const basic_vector3& rhs) {
+        return nearly_equal(lhs.m_vec[0], rhs.m_vec[0], default_epsilon<T>())
+            && nearly_equal(lhs.m_vec[1], rhs.m_vec[1], default_epsilon<T>())
+            && nearly_equal(lhs.m_vec[2], rhs.m_vec[2], default_epsilon<T>());
+    }
+    friend bool operator!=(const basic_vector3& lhs, const basic_vector3& rhs) {
+        return !(lhs == rhs);
+    }
 
 };
 
-// Perform typical algebraic operations on vectors
-std::ostream& operator<<(std::ostream& out, const vector3& v);
-bool operator==(const vector3& lhs, const vector3& rhs);
-bool operator!=(const vector3& lhs, const vector3& rhs);
-vector3 operator+(vector3 lhs, const vector3& rhs);
-vector3 operator-(vector3 lhs, const vector3& rhs);
-vector3 operator*(vector3 lhs, scalar rhs);
-vector3 operator*(scalar lhs, vector3 rhs);
+// A vector is the leaf of an expression, so it is held by reference
+template <typename T>
+struct expr_traits<basic_vector3<T>>
+{
+    using operand = const basic_vector3<T>&;
+};
+
+// Perform typical algebraic operations on vectors (+, - and * are the
+// expression operators from expression.h, == and != are above)
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const basic_vector3<T>& v);
+
+// Both precisions are compiled once in vector3.cpp (along with the
+// operators above)
+extern template class basic_vector3<float>;
+extern template class basic_vector3<double>;
+
+using vector3 = basic_vector3<scalar>;
+using vector3d = basic_vector3<double>;
 
 #endif
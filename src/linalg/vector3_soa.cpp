@@ -0,0 +1,287 @@
+
+#include "vector3_soa.h"
+#include "simd.h"
+
+#include <cmath>
+
+#if defined(LINALG_SIMD)
+using namespace simd;
+#endif
+
+
+//------------------------------------------------------------------------------
+/// @brief      Construct from an array of vector3
+///
+/// @param[in]  vecs   The vectors
+/// @param[in]  count  The number of vectors
+///
+vector3_soa::vector3_soa(const vector3* vecs, std::size_t count)
+    : m_x(count)
+    , m_y(count)
+    , m_z(count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        m_x[i] = vecs[i].x();
+        m_y[i] = vecs[i].y();
+        m_z[i] = vecs[i].z();
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Resize all lanes (new vectors are zero)
+///
+/// @param[in]  count  The new number of vectors
+///
+void vector3_soa::resize(std::size_t count) {
+    m_x.resize(count, 0);
+    m_y.resize(count, 0);
+    m_z.resize(count, 0);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Get a single vector
+///
+/// @param[in]  i     The index of the vector
+///
+/// @return     the vector at index i
+///
+vector3 vector3_soa::get(std::size_t i) const {
+    return {m_x[i], m_y[i], m_z[i]};
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set a single vector
+///
+/// @param[in]  i     The index of the vector
+/// @param[in]  v     The new value
+///
+void vector3_soa::set(std::size_t i, const vector3& v) {
+    m_x[i] = v.x();
+    m_y[i] = v.y();
+    m_z[i] = v.z();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Convert to an array of vector3
+///
+/// @param      out   The output array (with room for size() vectors)
+///
+void vector3_soa::to_array(vector3* out) const {
+    for (std::size_t i = 0; i < size(); ++i) {
+        out[i] = get(i);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Add the vectors of other to these vectors (both must have the
+/// same size)
+///
+/// @param[in]  other  The other vectors
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::add(const vector3_soa& other) {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    for (; i + 4 <= size(); i += 4) {
+        store_aligned(&m_x[i], simd::add(load_aligned(&m_x[i]), load_aligned(&other.m_x[i])));
+        store_aligned(&m_y[i], simd::add(load_aligned(&m_y[i]), load_aligned(&other.m_y[i])));
+        store_aligned(&m_z[i], simd::add(load_aligned(&m_z[i]), load_aligned(&other.m_z[i])));
+    }
+#endif
+    for (; i < size(); ++i) {
+        m_x[i] += other.m_x[i];
+        m_y[i] += other.m_y[i];
+        m_z[i] += other.m_z[i];
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Subtract the vectors of other from these vectors (both must
+/// have the same size)
+///
+/// @param[in]  other  The other vectors
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::sub(const vector3_soa& other) {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    for (; i + 4 <= size(); i += 4) {
+        store_aligned(&m_x[i], simd::sub(load_aligned(&m_x[i]), load_aligned(&other.m_x[i])));
+        store_aligned(&m_y[i], simd::sub(load_aligned(&m_y[i]), load_aligned(&other.m_y[i])));
+        store_aligned(&m_z[i], simd::sub(load_aligned(&m_z[i]), load_aligned(&other.m_z[i])));
+    }
+#endif
+    for (; i < size(); ++i) {
+        m_x[i] -= other.m_x[i];
+        m_y[i] -= other.m_y[i];
+        m_z[i] -= other.m_z[i];
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Scale all vectors
+///
+/// @param[in]  s     The scaling factor
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::scale(scalar s) {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    auto vs = splat(s);
+    for (; i + 4 <= size(); i += 4) {
+        store_aligned(&m_x[i], mul(load_aligned(&m_x[i]), vs));
+        store_aligned(&m_y[i], mul(load_aligned(&m_y[i]), vs));
+        store_aligned(&m_z[i], mul(load_aligned(&m_z[i]), vs));
+    }
+#endif
+    for (; i < size(); ++i) {
+        m_x[i] *= s;
+        m_y[i] *= s;
+        m_z[i] *= s;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Normalize all vectors (zero vectors are left unchanged, as
+/// with vector3::normalize)
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::normalize() {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    auto zero = splat(0), one = splat(1);
+    for (; i + 4 <= size(); i += 4) {
+        auto x = load_aligned(&m_x[i]), y = load_aligned(&m_y[i]), z = load_aligned(&m_z[i]);
+        auto l2 = madd(x, x, madd(y, y, mul(z, z)));
+        auto nonzero = gt(l2, zero);
+        auto s = select(nonzero, div(one, sqrt(l2)), one);
+        store_aligned(&m_x[i], mul(x, s));
+        store_aligned(&m_y[i], mul(y, s));
+        store_aligned(&m_z[i], mul(z, s));
+    }
+#endif
+    for (; i < size(); ++i) {
+        auto l2 = m_x[i] * m_x[i] + m_y[i] * m_y[i] + m_z[i] * m_z[i];
+        if (l2 > 0) {
+            auto s = 1 / std::sqrt(l2);
+            m_x[i] *= s;
+            m_y[i] *= s;
+            m_z[i] *= s;
+        }
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Cross product these vectors with the vectors of other (this x
+/// other, both must have the same size)
+///
+/// @param[in]  other  The other vectors
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::cross(const vector3_soa& other) {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    for (; i + 4 <= size(); i += 4) {
+        auto ax = load_aligned(&m_x[i]), ay = load_aligned(&m_y[i]), az = load_aligned(&m_z[i]),
+             bx = load_aligned(&other.m_x[i]), by = load_aligned(&other.m_y[i]),
+             bz = load_aligned(&other.m_z[i]);
+        store_aligned(&m_x[i], simd::sub(mul(ay, bz), mul(az, by)));
+        store_aligned(&m_y[i], simd::sub(mul(az, bx), mul(ax, bz)));
+        store_aligned(&m_z[i], simd::sub(mul(ax, by), mul(ay, bx)));
+    }
+#endif
+    for (; i < size(); ++i) {
+        auto ax = m_x[i], ay = m_y[i], az = m_z[i],
+             bx = other.m_x[i], by = other.m_y[i], bz = other.m_z[i];
+        m_x[i] = ay * bz - az * by;
+        m_y[i] = az * bx - ax * bz;
+        m_z[i] = ax * by - ay * bx;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Linearly interpolate between these and the vectors of other
+/// (both must have the same size)
+///
+/// @param[in]  other  The other vectors
+/// @param[in]  alpha  The interpolation ratio [0, 1]
+///
+/// @return     the updated vectors
+///
+vector3_soa& vector3_soa::lerp(const vector3_soa& other, scalar alpha) {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    auto va = splat(alpha);
+    for (; i + 4 <= size(); i += 4) {
+        auto x = load_aligned(&m_x[i]), y = load_aligned(&m_y[i]), z = load_aligned(&m_z[i]);
+        store_aligned(&m_x[i], madd(va, simd::sub(load_aligned(&other.m_x[i]), x), x));
+        store_aligned(&m_y[i], madd(va, simd::sub(load_aligned(&other.m_y[i]), y), y));
+        store_aligned(&m_z[i], madd(va, simd::sub(load_aligned(&other.m_z[i]), z), z));
+    }
+#endif
+    for (; i < size(); ++i) {
+        m_x[i] += alpha * (other.m_x[i] - m_x[i]);
+        m_y[i] += alpha * (other.m_y[i] - m_y[i]);
+        m_z[i] += alpha * (other.m_z[i] - m_z[i]);
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Write the length of every vector
+///
+/// @param      out   The output array (with room for size() values)
+///
+void vector3_soa::len(scalar* out) const {
+    len2(out);
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    for (; i + 4 <= size(); i += 4) {
+        store(&out[i], simd::sqrt(load(&out[i])));
+    }
+#endif
+    for (; i < size(); ++i) {
+        out[i] = std::sqrt(out[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Write the squared length of every vector
+///
+/// @param      out   The output array (with room for size() values)
+///
+void vector3_soa::len2(scalar* out) const {
+    dot(*this, out);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Write the dot product of these vectors with the vectors of
+/// other (both must have the same size)
+///
+/// @param[in]  other  The other vectors
+/// @param      out    The output array (with room for size() values)
+///
+void vector3_soa::dot(const vector3_soa& other, scalar* out) const {
+    std::size_t i = 0;
+#if defined(LINALG_SIMD)
+    for (; i + 4 <= size(); i += 4) {
+        auto d = madd(load_aligned(&m_x[i]), load_aligned(&other.m_x[i]),
+                 madd(load_aligned(&m_y[i]), load_aligned(&other.m_y[i]),
+                      mul(load_aligned(&m_z[i]), load_aligned(&other.m_z[i]))));
+        store(&out[i], d);
+    }
+#endif
+    for (; i < size(); ++i) {
+        out[i] = m_x[i] * other.m_x[i] + m_y[i] * other.m_y[i] + m_z[i] * other.m_z[i];
+    }
+}
@@ -0,0 +1,92 @@
+
+#ifndef _VECTOR3_SOA_H_
+#define _VECTOR3_SOA_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "aligned.h"
+
+#include <cstddef>
+#include <vector>
+
+// A 32-byte aligned array of scalars (one lane of a vector3_soa)
+using scalar_lane = aligned_vector<scalar, 32>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class stores many vectors as a structure of arrays (all
+/// x values, then all y values, then all z values). Each lane is 32-byte
+/// aligned so the batch methods below process four vectors per instruction.
+/// The methods mirror those of vector3 but apply to every vector at once.
+///
+class vector3_soa
+{
+public:
+    scalar_lane m_x;
+    scalar_lane m_y;
+    scalar_lane m_z;
+
+public: // Constructors ---------------------------------------------
+
+    vector3_soa() = default;
+
+    explicit vector3_soa(std::size_t count)
+        : m_x(count, 0)
+        , m_y(count, 0)
+        , m_z(count, 0)
+    {}
+
+    // Convert from an array of vector3
+    vector3_soa(const vector3* vecs, std::size_t count);
+
+    vector3_soa clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    std::size_t size() const { return m_x.size(); }
+
+    // Resize all lanes (new vectors are zero)
+    void resize(std::size_t count);
+
+    // Get or set a single vector
+    vector3 get(std::size_t i) const;
+    void set(std::size_t i, const vector3& v);
+
+    // Convert to an array of vector3 (with room for size() vectors)
+    void to_array(vector3* out) const;
+
+public: // Mutating interface methods -------------------------------
+
+    // Add the vectors of other to these vectors
+    vector3_soa& add(const vector3_soa& other);
+
+    // Subtract the vectors of other from these vectors
+    vector3_soa& sub(const vector3_soa& other);
+
+    // Scale all vectors
+    vector3_soa& scale(scalar s);
+
+    // Normalize all vectors
+    vector3_soa& normalize();
+
+    // Cross product these vectors with the vectors of other
+    vector3_soa& cross(const vector3_soa& other);
+
+    // Linearly interpolate between these and the vectors of other
+    vector3_soa& lerp(const vector3_soa& other, scalar alpha=0.5);
+
+public: // Information interface mthods -----------------------------
+
+    // Write the length of every vector to out (size() values)
+    void len(scalar* out) const;
+
+    // Write the squared length of every vector to out (size() values)
+    void len2(scalar* out) const;
+
+    // Write the dot product with the vectors of other to out (size() values)
+    void dot(const vector3_soa& other, scalar* out) const;
+
+};
+
+#endif
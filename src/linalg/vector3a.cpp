@@ -0,0 +1,189 @@
+
+#include "vector3a.h"
+#include "simd.h"
+
+#include <iostream>
+#include <cmath>
+
+#if defined(LINALG_SIMD)
+using namespace simd;
+#endif
+
+static_assert(sizeof(vector3a) == 16 && alignof(vector3a) == 16,
+    "A vector3a is a single aligned SIMD register");
+
+
+//------------------------------------------------------------------------------
+/// @brief      Add another vector3a to this vector
+///
+/// @param[in]  other  The other vector3a to add
+///
+/// @return     return the updated vector
+///
+vector3a& vector3a::add(const vector3a& other) {
+#if defined(LINALG_SIMD)
+    store_aligned(m_vec.data(),
+        simd::add(load_aligned(m_vec.data()), load_aligned(other.m_vec.data())));
+#else
+    m_vec[0] += other.m_vec[0];
+    m_vec[1] += other.m_vec[1];
+    m_vec[2] += other.m_vec[2];
+#endif
+    return *this;
+}
+vector3a& vector3a::operator+=(const vector3a& other) {
+    return add(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Subtract another vector3a from this vector
+///
+/// @param[in]  other  The other vector3a to subtract from this
+///
+/// @return     return the updated vector
+///
+vector3a& vector3a::sub(const vector3a& other) {
+#if defined(LINALG_SIMD)
+    store_aligned(m_vec.data(),
+        simd::sub(load_aligned(m_vec.data()), load_aligned(other.m_vec.data())));
+#else
+    m_vec[0] -= other.m_vec[0];
+    m_vec[1] -= other.m_vec[1];
+    m_vec[2] -= other.m_vec[2];
+#endif
+    return *this;
+}
+vector3a& vector3a::operator-=(const vector3a& other) {
+    return sub(other);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Scale this vector
+///
+/// @param[in]  s     the scaling value
+///
+/// @return     return the updated vector
+///
+vector3a& vector3a::scale(scalar s) {
+#if defined(LINALG_SIMD)
+    store_aligned(m_vec.data(), mul(load_aligned(m_vec.data()), splat(s)));
+#else
+    m_vec[0] *= s;
+    m_vec[1] *= s;
+    m_vec[2] *= s;
+#endif
+    return *this;
+}
+vector3a& vector3a::operator*=(scalar s) {
+    return scale(s);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Normalize this vector
+///
+/// @return     the updated vector
+///
+vector3a& vector3a::normalize() {
+    auto len_squared = len2();
+    if (len_squared > 0) {
+        scale(1 / std::sqrt(len_squared));
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Cross product this vector with another vector
+///
+/// @param[in]  other  The other vector3a
+///
+/// @return     the updated vector
+///
+vector3a& vector3a::cross(const vector3a& other) {
+#if defined(LINALG_SIMD)
+    // a.yzx * b.zxy - a.zxy * b.yzx (the padding stays zero)
+    auto a = load_aligned(m_vec.data()), b = load_aligned(other.m_vec.data());
+    store_aligned(m_vec.data(), simd::sub(
+        mul(swizzle<1, 2, 0, 3>(a), swizzle<2, 0, 1, 3>(b)),
+        mul(swizzle<2, 0, 1, 3>(a), swizzle<1, 2, 0, 3>(b))));
+#else
+    auto ax = m_vec[0], ay = m_vec[1], az = m_vec[2],
+         bx = other.m_vec[0], by = other.m_vec[1], bz = other.m_vec[2];
+    m_vec[0] = ay * bz - az * by;
+    m_vec[1] = az * bx - ax * bz;
+    m_vec[2] = ax * by - ay * bx;
+#endif
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Linearly interpolate between this and another vector
+///
+/// @param[in]  other  The other vector3a
+/// @param[in]  alpha  The interpolation ratio [0, 1]
+///
+/// @return     the updated vector3a
+///
+vector3a& vector3a::lerp(const vector3a& other, scalar alpha) {
+#if defined(LINALG_SIMD)
+    auto a = load_aligned(m_vec.data());
+    store_aligned(m_vec.data(),
+        madd(simd::sub(load_aligned(other.m_vec.data()), a), splat(alpha), a));
+#else
+    m_vec[0] += (other.m_vec[0] - m_vec[0]) * alpha;
+    m_vec[1] += (other.m_vec[1] - m_vec[1]) * alpha;
+    m_vec[2] += (other.m_vec[2] - m_vec[2]) * alpha;
+#endif
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the magnitude/length of this vector
+///
+/// @return     the length of this vector
+///
+scalar vector3a::len() const {
+    return std::sqrt(len2());
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the squared magnitude/length of this vector
+///
+/// @return     the squared length of this vector
+///
+scalar vector3a::len2() const {
+    return dot(*this);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the dot product of this vector with another vector
+///
+/// @param[in]  other  The other vector3a
+///
+/// @return     the dot product between two vectors
+///
+scalar vector3a::dot(const vector3a& other) const {
+#if defined(LINALG_SIMD)
+    return first(hsum(mul(load_aligned(m_vec.data()), load_aligned(other.m_vec.data()))));
+#else
+    return m_vec[0] * other.m_vec[0]
+         + m_vec[1] * other.m_vec[1]
+         + m_vec[2] * other.m_vec[2];
+#endif
+}
+
+// Insertion operator for the vector3a class
+std::ostream& operator<<(std::ostream& out, const vector3a& v) {
+    out << "[ "
+        << ScalarFmt() << v.m_vec[0] << "  "
+        << ScalarFmt() << v.m_vec[1] << "  "
+        << ScalarFmt() << v.m_vec[2] << " ]";
+    return out;
+}
+
+// (Approximately) Compare two vectors for equality
+bool operator==(const vector3a& lhs, const vector3a& rhs) {
+    return nearly_equal(lhs.m_vec[0], rhs.m_vec[0])
+        && nearly_equal(lhs.m_vec[1], rhs.m_vec[1])
+        && nearly_equal(lhs.m_vec[2], rhs.m_vec[2]);
+}
+bool operator!=(const vector3a& lhs, const vector3a& rhs) { return !operator==(lhs,rhs); }
@@ -0,0 +1,101 @@
+
+#ifndef _VECTOR3A_H_
+#define _VECTOR3A_H_
+
+#include "linalg.h"
+#include "vector3.h"
+#include "aligned.h"
+
+#include <iosfwd>
+#include <array>
+
+using vec4_array = std::array<scalar, 4>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines a three dimensional vector padded to 16
+/// bytes and 16-byte aligned (the fourth value is always zero). Each vector
+/// is a single aligned SIMD load, and arrays of them match the std140
+/// layout of a vec3 array, so they can be uploaded to the GPU as is. Use
+/// vector3 where memory matters more than speed.
+///
+class alignas(16) vector3a
+{
+public:
+    vec4_array m_vec;
+
+public: // Constructors ---------------------------------------------
+
+    vector3a()
+        : m_vec{{0, 0, 0, 0}}
+    {}
+
+    vector3a(scalar x, scalar y, scalar z)
+        : m_vec{{x, y, z, 0}}
+    {}
+
+    explicit vector3a(const vector3& v)
+        : m_vec{{v.x(), v.y(), v.z(), 0}}
+    {}
+
+    vector3a clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    scalar& x() { return m_vec[0]; };
+    scalar& y() { return m_vec[1]; };
+    scalar& z() { return m_vec[2]; };
+
+    scalar x() const { return m_vec[0]; };
+    scalar y() const { return m_vec[1]; };
+    scalar z() const { return m_vec[2]; };
+
+    // Return the unpadded vector
+    vector3 to_vector3() const { return {m_vec[0], m_vec[1], m_vec[2]}; }
+
+public: // Mutating interface methods -------------------------------
+
+    // Add another vector3a to this vector
+    vector3a& add(const vector3a& other);
+    vector3a& operator+=(const vector3a& other);
+
+    // Subtract another vector3a from this vector
+    vector3a& sub(const vector3a& other);
+    vector3a& operator-=(const vector3a& other);
+
+    // Scale this vector
+    vector3a& scale(scalar s);
+    vector3a& operator*=(scalar s);
+
+    // Normalize this vector
+    vector3a& normalize();
+
+    // Cross product this vector with another vector
+    vector3a& cross(const vector3a& other);
+
+    // Linearly interpolate between this and another vector
+    vector3a& lerp(const vector3a& other, scalar alpha=0.5);
+
+public: // Information interface mthods -----------------------------
+
+    // Return the magnitude/length of this vector
+    scalar len() const;
+
+    // Return the squared magnitude/length of this vector
+    scalar len2() const;
+
+    // Return the dot product of this vector with another vector
+    scalar dot(const vector3a& other) const;
+
+};
+
+// Perform typical algebraic operations on vectors
+std::ostream& operator<<(std::ostream& out, const vector3a& v);
+bool operator==(const vector3a& lhs, const vector3a& rhs);
+bool operator!=(const vector3a& lhs, const vector3a& rhs);
+
+// Contiguous padded vectors (e.g. a std140 vec3 array)
+using vector3a_array = aligned_vector<vector3a, 16>;
+
+#endif
@@ -0,0 +1,80 @@
+
+#include "mapped_file.h"
+
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Empty files cannot be mapped, so they all share this
+static const char empty_file[1] = {0};
+
+
+//------------------------------------------------------------------------------
+/// @brief      Map the file at a path. On failure (a missing or unreadable
+/// file) nothing is mapped and is_open returns false.
+///
+/// @param[in]  path  The path of the file
+///
+mapped_file::mapped_file(const std::string& path)
+    : m_data(nullptr)
+    , m_size(0)
+{
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && info.st_size == 0) {
+        m_data = empty_file;
+    }
+    else if (info.st_size > 0) {
+        auto size = static_cast<std::size_t>(info.st_size);
+        auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // The loaders read the file front to back
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(addr);
+            m_size = size;
+        }
+    }
+    ::close(fd);
+}
+
+mapped_file::mapped_file(mapped_file&& other)
+    : m_data(other.m_data)
+    , m_size(other.m_size)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) {
+    if (this != &other) {
+        close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file() {
+    close();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Unmap the file (pointers into it are no longer valid)
+///
+/// @return     the closed file
+///
+mapped_file& mapped_file::close() {
+    if (m_data != nullptr && m_data != empty_file) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    return *this;
+}
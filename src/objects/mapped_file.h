@@ -0,0 +1,58 @@
+
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <string>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+/// @brief      This class maps a whole file read-only into memory, so loaders
+/// parse the file in place instead of reading it into a buffer first. The
+/// mapping is released when the object is destroyed (it can be moved but
+/// not copied).
+///
+class mapped_file
+{
+public:
+    const char* m_data;
+    std::size_t m_size;
+
+public: // Constructors ---------------------------------------------
+
+    mapped_file()
+        : m_data(nullptr)
+        , m_size(0)
+    {}
+
+    // Map the file at path (check is_open for errors)
+    explicit mapped_file(const std::string& path);
+
+    mapped_file(mapped_file&& other);
+    mapped_file& operator=(mapped_file&& other);
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+public: // Accessor methods -----------------------------------------
+
+    const char* data() const { return m_data; }
+
+    const char* end() const { return m_data + m_size; }
+
+    std::size_t size() const { return m_size; }
+
+public: // Mutating interface methods -------------------------------
+
+    // Unmap the file
+    mapped_file& close();
+
+public: // Information interface mthods -----------------------------
+
+    // Return true if a file is mapped
+    bool is_open() const { return m_data != nullptr; }
+
+};
+
+#endif
@@ -0,0 +1,269 @@
+
+#include "mesh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+
+// The alignment of the streams and indices in the allocation of a mesh
+static constexpr std::size_t mesh_alignment = 16;
+
+// Round up to a multiple of the alignment
+static std::uint32_t align_to(std::size_t offset, std::size_t alignment) {
+    return static_cast<std::uint32_t>((offset + alignment - 1) / alignment * alignment);
+}
+
+// Return the bytes of an attribute (rounded up to 4, as GL prefers)
+static std::uint32_t attribute_size(const mesh_attribute& a) {
+    return align_to(a.m_components * gl_type_size(a.m_type), 4);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the bytes between the vertices of a stream
+///
+/// @param[in]  s     The stream
+///
+/// @return     the stride
+///
+std::uint32_t mesh_layout::stream_stride(std::size_t s) const
+{
+    return m_streams == mesh_interleaved ? m_stride : attribute_size(m_attributes[s]);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Lay out attributes in the given order. Interleaved attributes
+/// follow each other in one stream, and split attributes start at offset 0
+/// of their own stream. Each attribute is padded to 4 bytes.
+///
+/// @param[in]  attributes       The attributes (their offsets are ignored)
+/// @param[in]  attribute_count  The number of attributes (at most
+///                              mesh_max_attributes)
+/// @param[in]  streams          How the attributes are stored
+///
+/// @return     the layout
+///
+mesh_layout make_layout(const mesh_attribute* attributes, std::size_t attribute_count,
+    mesh_streams streams)
+{
+    mesh_layout layout {};
+    layout.m_streams = streams;
+    layout.m_attribute_count = static_cast<std::uint32_t>(std::min(attribute_count, mesh_max_attributes));
+    for (std::size_t a = 0; a < layout.m_attribute_count; ++a) {
+        auto& attribute = layout.m_attributes[a] = attributes[a];
+        attribute.m_offset = static_cast<std::uint8_t>(streams == mesh_interleaved ? layout.m_stride : 0);
+        layout.m_stride += attribute_size(attribute);
+    }
+    return layout;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Create an empty mesh
+///
+mesh::mesh()
+    : m_data(nullptr)
+    , m_layout{}
+    , m_vertex_count(0)
+    , m_index_count(0)
+    , m_index_type(gl_unsigned_short)
+    , m_stream_offsets{}
+    , m_index_offset(0)
+    , m_min()
+    , m_max()
+    , m_uv_min{{0, 0}}
+    , m_uv_max{{1, 1}}
+    , m_lods{}
+    , m_lod_count(0)
+{}
+
+//------------------------------------------------------------------------------
+/// @brief      Allocate the vertices and indices of a mesh in one piece from
+/// an arena: each stream and then the indices, 16 byte aligned
+///
+/// @param      arena         The arena
+/// @param[in]  layout        The vertex layout
+/// @param[in]  vertex_count  The number of vertices
+/// @param[in]  index_count   The number of indices
+///
+mesh::mesh(mesh_arena& arena, const mesh_layout& layout, std::uint32_t vertex_count,
+    std::uint32_t index_count)
+    : m_layout(layout)
+    , m_vertex_count(vertex_count)
+    , m_index_count(index_count)
+    , m_index_type(vertex_count <= 0x10000 ? gl_unsigned_short : gl_unsigned_int)
+    , m_stream_offsets{}
+    , m_min()
+    , m_max()
+    , m_uv_min{{0, 0}}
+    , m_uv_max{{1, 1}}
+    , m_lods{}
+    , m_lod_count(0)
+{
+    std::size_t offset = 0;
+    for (std::size_t s = 0; s < m_layout.stream_count(); ++s) {
+        m_stream_offsets[s] = static_cast<std::uint32_t>(offset);
+        offset = align_to(offset + std::size_t{vertex_count} * m_layout.stream_stride(s), mesh_alignment);
+    }
+    m_index_offset = static_cast<std::uint32_t>(offset);
+    offset += std::size_t{index_count} * gl_type_size(m_index_type);
+    m_data = static_cast<std::uint8_t*>(arena.allocate(offset, mesh_alignment));
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Take the view of another mesh (which is left empty)
+///
+/// @param      other  The other mesh
+///
+mesh::mesh(mesh&& other)
+    : mesh()
+{
+    *this = std::move(other);
+}
+
+mesh& mesh::operator=(mesh&& other)
+{
+    if (this != &other) {
+        m_data = other.m_data;
+        m_layout = other.m_layout;
+        m_vertex_count = other.m_vertex_count;
+        m_index_count = other.m_index_count;
+        m_index_type = other.m_index_type;
+        m_stream_offsets = other.m_stream_offsets;
+        m_index_offset = other.m_index_offset;
+        m_min = other.m_min;
+        m_max = other.m_max;
+        m_uv_min = other.m_uv_min;
+        m_uv_max = other.m_uv_max;
+        m_lods = other.m_lods;
+        m_lod_count = other.m_lod_count;
+
+        other.m_data = nullptr;
+        other.m_vertex_count = other.m_index_count = other.m_lod_count = 0;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Copy this mesh into a new allocation from an arena. An invalid
+/// mesh gives an invalid copy and allocates nothing.
+///
+/// @param      arena  The arena
+///
+/// @return     the copy
+///
+mesh mesh::clone(mesh_arena& arena) const
+{
+    if (!is_valid()) {
+        return mesh();
+    }
+    mesh copy(arena, m_layout, m_vertex_count, m_index_count);
+    std::memcpy(copy.m_data, m_data, size());
+    copy.m_min = m_min;
+    copy.m_max = m_max;
+    copy.m_uv_min = m_uv_min;
+    copy.m_uv_max = m_uv_max;
+    copy.m_lods = m_lods;
+    copy.m_lod_count = m_lod_count;
+    return copy;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the offset of an attribute of a vertex in the
+/// allocation
+///
+/// @param[in]  a     The attribute
+/// @param[in]  v     The vertex
+///
+/// @return     the offset in bytes
+///
+std::size_t mesh::attribute_offset(std::size_t a, std::size_t v) const
+{
+    auto s = m_layout.m_streams == mesh_interleaved ? 0 : a;
+    return m_stream_offsets[s] + v * m_layout.stream_stride(s) + m_layout.m_attributes[a].m_offset;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return an index
+///
+/// @param[in]  i     The position in the index buffer
+///
+/// @return     the index
+///
+std::uint32_t mesh::index(std::size_t i) const
+{
+    if (m_index_type == gl_unsigned_short) {
+        return static_cast<const std::uint16_t*>(index_data())[i];
+    }
+    return static_cast<const std::uint32_t*>(index_data())[i];
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set an index
+///
+/// @param[in]  i      The position in the index buffer
+/// @param[in]  value  The index
+///
+/// @return     a reference to this mesh
+///
+mesh& mesh::set_index(std::size_t i, std::uint32_t value)
+{
+    if (m_index_type == gl_unsigned_short) {
+        static_cast<std::uint16_t*>(index_data())[i] = static_cast<std::uint16_t>(value);
+    }
+    else {
+        static_cast<std::uint32_t*>(index_data())[i] = value;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the number of bytes of the allocation of this mesh
+///
+/// @return     the size
+///
+std::size_t mesh::size() const
+{
+    return m_index_offset + std::size_t{m_index_count} * gl_type_size(m_index_type);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Copy mesh buffers into a mesh from an arena. The attributes
+/// are copied one vertex at a time into the new layout, and the indices are
+/// narrowed to 16 bits when they fit. The bounds come along (quantized
+/// attributes need them), and so do the levels of detail, which are ranges
+/// of the indices (the first mesh_max_lods, as in a mesh file).
+///
+/// @param      arena    The arena
+/// @param[in]  buffers  The mesh buffers
+/// @param[in]  streams  How the attributes are stored
+///
+/// @return     the mesh
+///
+mesh make_mesh(mesh_arena& arena, const mesh_buffers& buffers, mesh_streams streams)
+{
+    auto layout = make_layout(buffers.m_attributes.data(), buffers.m_attributes.size(), streams);
+    auto vertex_count = buffers.vertex_count();
+    mesh out(arena, layout, static_cast<std::uint32_t>(vertex_count),
+        static_cast<std::uint32_t>(buffers.m_indices.size()));
+    std::memset(out.m_data, 0, out.m_index_offset);
+
+    for (std::size_t a = 0; a < layout.m_attribute_count; ++a) {
+        auto& attribute = buffers.m_attributes[a];
+        auto bytes = attribute.m_components * gl_type_size(attribute.m_type);
+        auto in = buffers.m_vertices.data() + attribute.m_offset;
+        for (std::size_t v = 0; v < vertex_count; ++v) {
+            std::memcpy(out.attribute(a, v), in + v * buffers.m_stride, bytes);
+        }
+    }
+    for (std::size_t i = 0; i < buffers.m_indices.size(); ++i) {
+        out.set_index(i, buffers.m_indices[i]);
+    }
+
+    out.m_min = buffers.m_min;
+    out.m_max = buffers.m_max;
+    out.m_uv_min = buffers.m_uv_min;
+    out.m_uv_max = buffers.m_uv_max;
+    out.m_lod_count = static_cast<std::uint32_t>(std::min(buffers.m_lods.size(), mesh_max_lods));
+    std::copy_n(buffers.m_lods.begin(), out.m_lod_count, out.m_lods.begin());
+    return out;
+}
@@ -1,10 +1,130 @@
-
 #ifndef _MESH_H_
 #define _MESH_H_
 
+#include "mesh_arena.h"
+#include "mesh_file.h"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// How the attributes of the vertices are stored: all of a vertex together
+// (one stream), or each attribute in a stream of its own (for passes that
+// read only some of them, like depth only passes reading positions)
+enum mesh_streams : std::uint8_t {
+    mesh_interleaved = 0,
+    mesh_split = 1
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The vertex layout of a mesh: its attributes (with their
+/// offsets in their stream) and how they are split into streams
+///
+struct mesh_layout
+{
+    std::array<mesh_attribute, mesh_max_attributes> m_attributes;
+    std::uint32_t m_attribute_count;
+    std::uint32_t m_stride;   // the bytes of a vertex (over all its streams)
+    mesh_streams m_streams;
+
+    // Return the number of streams
+    std::size_t stream_count() const {
+        return m_streams == mesh_interleaved ? std::size_t{m_attribute_count != 0} : m_attribute_count;
+    }
+
+    // Return the bytes between the vertices of a stream
+    std::uint32_t stream_stride(std::size_t s) const;
+};
+
+// Lay out attributes (in the given order, each 4 byte aligned), ignoring
+// their offsets
+mesh_layout make_layout(const mesh_attribute* attributes, std::size_t attribute_count,
+    mesh_streams streams);
+
+//------------------------------------------------------------------------------
+/// @brief      This class is a view of the vertices and indices of a mesh,
+/// which are one contiguous allocation from a mesh_arena (the streams, then
+/// the indices, each 16 byte aligned). Nothing is allocated per vertex, and
+/// the mesh does not free its memory (the arena does, all at once). It can
+/// be moved but not copied, so each allocation has one view.
+///
 class mesh
 {
+public:
+    std::uint8_t* m_data;
+    mesh_layout m_layout;
+    std::uint32_t m_vertex_count;
+    std::uint32_t m_index_count;
+    std::uint32_t m_index_type;
+    std::array<std::uint32_t, mesh_max_attributes> m_stream_offsets;
+    std::uint32_t m_index_offset;
+
+    // The bounds of the positions and uvs (which quantized attributes are
+    // relative to) and the levels of detail as ranges of the indices (when
+    // there are none the whole index buffer is the only level)
+    vector3 m_min;
+    vector3 m_max;
+    std::array<float, 2> m_uv_min;
+    std::array<float, 2> m_uv_max;
+    std::array<mesh_lod, mesh_max_lods> m_lods;
+    std::uint32_t m_lod_count;
+
+public: // Constructors ---------------------------------------------
+
+    // Create an empty mesh
+    mesh();
+
+    // Allocate the (uninitialized) vertices and indices of a mesh from an
+    // arena (16 bit indices when they can address every vertex)
+    mesh(mesh_arena& arena, const mesh_layout& layout, std::uint32_t vertex_count,
+        std::uint32_t index_count);
+
+    mesh(mesh&& other);
+    mesh& operator=(mesh&& other);
+
+    mesh(const mesh&) = delete;
+    mesh& operator=(const mesh&) = delete;
+
+    // Copy this mesh (with its bounds and levels of detail) into another
+    // allocation from an arena
+    mesh clone(mesh_arena& arena) const;
+
+public: // Accessor methods -----------------------------------------
+
+    std::uint8_t* stream(std::size_t s) { return m_data + m_stream_offsets[s]; }
+    const std::uint8_t* stream(std::size_t s) const { return m_data + m_stream_offsets[s]; }
+
+    void* index_data() { return m_data + m_index_offset; }
+    const void* index_data() const { return m_data + m_index_offset; }
+
+    // Return a pointer to attribute a of vertex v
+    std::uint8_t* attribute(std::size_t a, std::size_t v) { return m_data + attribute_offset(a, v); }
+    const std::uint8_t* attribute(std::size_t a, std::size_t v) const { return m_data + attribute_offset(a, v); }
+
+    // Return index i (of either type)
+    std::uint32_t index(std::size_t i) const;
+
+public: // Mutating interface methods -------------------------------
+
+    // Set index i (of either type)
+    mesh& set_index(std::size_t i, std::uint32_t value);
+
+public: // Information interface mthods -----------------------------
+
+    // Return the offset of attribute a of vertex v in the allocation
+    std::size_t attribute_offset(std::size_t a, std::size_t v) const;
+
+    // Return the number of bytes of the allocation
+    std::size_t size() const;
+
+    // Return true if the mesh views an allocation
+    bool is_valid() const { return m_data != nullptr; }
 
 };
 
+// Copy mesh buffers (with their bounds and up to mesh_max_lods levels of
+// detail) into a mesh allocated from an arena, with the attributes
+// interleaved or split into streams
+mesh make_mesh(mesh_arena& arena, const mesh_buffers& buffers, mesh_streams streams);
+
 #endif
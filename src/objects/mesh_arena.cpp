@@ -0,0 +1,96 @@
+
+#include "mesh_arena.h"
+
+
+// Return p rounded up to the alignment
+static std::uint8_t* align_up(std::uint8_t* p, std::size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(p);
+    return p + ((alignment - address % alignment) % alignment);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Take the blocks of another arena (which is left empty)
+///
+/// @param      other  The other arena
+///
+mesh_arena::mesh_arena(mesh_arena&& other)
+    : m_blocks(std::move(other.m_blocks))
+    , m_large_blocks(std::move(other.m_large_blocks))
+    , m_block_size(other.m_block_size)
+    , m_next(other.m_next)
+    , m_end(other.m_end)
+    , m_allocated(other.m_allocated)
+{
+    other.m_blocks.clear();
+    other.m_large_blocks.clear();
+    other.m_next = other.m_end = nullptr;
+    other.m_allocated = 0;
+}
+
+mesh_arena& mesh_arena::operator=(mesh_arena&& other)
+{
+    if (this != &other) {
+        m_blocks = std::move(other.m_blocks);
+        m_large_blocks = std::move(other.m_large_blocks);
+        m_block_size = other.m_block_size;
+        m_next = other.m_next;
+        m_end = other.m_end;
+        m_allocated = other.m_allocated;
+        other.m_blocks.clear();
+        other.m_large_blocks.clear();
+        other.m_next = other.m_end = nullptr;
+        other.m_allocated = 0;
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return memory from the current block, or from a new one if it
+/// does not fit. Allocations larger than a block get a block of their own
+/// (kept apart, so every block in m_blocks has m_block_size bytes), and the
+/// current block stays current.
+///
+/// @param[in]  bytes      The number of bytes
+/// @param[in]  alignment  The alignment (a power of two)
+///
+/// @return     the memory (uninitialized)
+///
+void* mesh_arena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto p = m_next ? align_up(m_next, alignment) : nullptr;
+    if (!p || bytes > static_cast<std::size_t>(m_end - p)) {
+        auto size = bytes + alignment;
+        if (size > m_block_size) {
+            m_large_blocks.emplace_back(new std::uint8_t[size]);
+            m_allocated += bytes;
+            return align_up(m_large_blocks.back().get(), alignment);
+        }
+
+        m_blocks.emplace_back(new std::uint8_t[m_block_size]);
+        m_next = m_blocks.back().get();
+        m_end = m_next + m_block_size;
+        p = align_up(m_next, alignment);
+    }
+
+    m_next = p + bytes;
+    m_allocated += bytes;
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Give back all the memory at once. The first block is kept so
+/// an arena that is refilled every level does not allocate again.
+///
+/// @return     a reference to this arena
+///
+mesh_arena& mesh_arena::reset()
+{
+    m_large_blocks.clear();
+    if (m_blocks.size() > 1) {
+        m_blocks.erase(m_blocks.begin() + 1, m_blocks.end());
+    }
+    m_next = m_blocks.empty() ? nullptr : m_blocks[0].get();
+    m_end = m_next ? m_next + m_block_size : nullptr;
+    m_allocated = 0;
+    return *this;
+}
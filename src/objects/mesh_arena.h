@@ -0,0 +1,62 @@
+#ifndef _MESH_ARENA_H_
+#define _MESH_ARENA_H_
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+/// @brief      This class hands out memory for meshes from large blocks by
+/// bumping a pointer, so loading thousands of meshes makes a few large
+/// allocations instead of thousands of small ones, and nothing fragments.
+/// Memory is only given back all at once (by reset or by destroying the
+/// arena), which invalidates every mesh viewing it. The arena can be moved
+/// but not copied.
+///
+class mesh_arena
+{
+public:
+    std::vector<std::unique_ptr<std::uint8_t[]>> m_blocks;        // m_block_size bytes each
+    std::vector<std::unique_ptr<std::uint8_t[]>> m_large_blocks;  // one allocation each
+    std::size_t m_block_size;
+    std::uint8_t* m_next;
+    std::uint8_t* m_end;
+    std::size_t m_allocated;
+
+public: // Constructors ---------------------------------------------
+
+    // Create an arena that allocates blocks of (at least) block_size bytes
+    explicit mesh_arena(std::size_t block_size=std::size_t{1} << 20)
+        : m_block_size(block_size)
+        , m_next(nullptr)
+        , m_end(nullptr)
+        , m_allocated(0)
+    {}
+
+    mesh_arena(mesh_arena&& other);
+    mesh_arena& operator=(mesh_arena&& other);
+
+    mesh_arena(const mesh_arena&) = delete;
+    mesh_arena& operator=(const mesh_arena&) = delete;
+
+public: // Mutating interface methods -------------------------------
+
+    // Return bytes of memory at the given alignment (a power of two)
+    void* allocate(std::size_t bytes, std::size_t alignment=16);
+
+    // Give back all the memory (keeping the first block of block_size for
+    // reuse)
+    mesh_arena& reset();
+
+public: // Information interface mthods -----------------------------
+
+    // Return the number of bytes handed out
+    std::size_t size() const { return m_allocated; }
+
+    // Return the number of blocks (of either kind)
+    std::size_t block_count() const { return m_blocks.size() + m_large_blocks.size(); }
+
+};
+
+#endif
@@ -0,0 +1,106 @@
+
+#include "mesh_builder.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Return a hash of the indices of a corner (each index is mixed
+/// with a different odd constant, then the bits are folded down)
+///
+static std::uint32_t hash_corner(const obj_corner& c) {
+    auto h = std::uint64_t{c.m_pos} * 0x9e3779b97f4a7c15u
+        ^ std::uint64_t{c.m_uv} * 0xc2b2ae3d27d4eb4fu
+        ^ std::uint64_t{c.m_normal} * 0x165667b19e3779f9u;
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+static bool same_corner(const obj_corner& a, const obj_corner& b) {
+    return a.m_pos == b.m_pos && a.m_uv == b.m_uv && a.m_normal == b.m_normal;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Build GL ready buffers from OBJ geometry. Corners that use the
+/// same position, uv and normal become one interleaved vertex (position,
+/// normal, uv), found with an open addressing hash table, and the indices
+/// refer to these vertices (in the order they are first used). Normals and
+/// uvs are only included when every corner has one.
+///
+/// @param[in]  obj   The geometry
+///
+/// @return     the buffers
+///
+mesh_buffers build_mesh(const obj_data& obj)
+{
+    auto& corners = obj.m_corners;
+    auto normals = !corners.empty() && std::all_of(corners.begin(), corners.end(),
+        [](const obj_corner& c) { return c.m_normal != obj_no_index; });
+    auto uvs = !corners.empty() && std::all_of(corners.begin(), corners.end(),
+        [](const obj_corner& c) { return c.m_uv != obj_no_index; });
+
+    mesh_buffers mesh;
+    mesh.m_stride = 0;
+    mesh.m_attributes.push_back({mesh_position, 3, 0, 0, gl_float});
+    mesh.m_stride += 3 * sizeof(float);
+    if (normals) {
+        mesh.m_attributes.push_back({mesh_normal, 3, 0, static_cast<std::uint8_t>(mesh.m_stride), gl_float});
+        mesh.m_stride += 3 * sizeof(float);
+    }
+    if (uvs) {
+        mesh.m_attributes.push_back({mesh_uv, 2, 0, static_cast<std::uint8_t>(mesh.m_stride), gl_float});
+        mesh.m_stride += 2 * sizeof(float);
+    }
+
+    // The table is at most half full, so probe sequences stay short
+    std::size_t table_size = 16;
+    while (table_size < 2 * corners.size()) {
+        table_size *= 2;
+    }
+    std::vector<std::uint32_t> table(table_size, obj_no_index);
+    std::vector<obj_corner> unique;
+
+    mesh.m_indices.resize(corners.size());
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        // Ignore the attributes that are not stored
+        auto c = corners[i];
+        c.m_normal = normals ? c.m_normal : obj_no_index;
+        c.m_uv = uvs ? c.m_uv : obj_no_index;
+
+        auto slot = hash_corner(c) & (table_size - 1);
+        while (table[slot] != obj_no_index && !same_corner(unique[table[slot]], c)) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        if (table[slot] == obj_no_index) {
+            table[slot] = static_cast<std::uint32_t>(unique.size());
+            unique.push_back(c);
+        }
+        mesh.m_indices[i] = table[slot];
+    }
+
+    mesh.m_vertices.resize(unique.size() * mesh.m_stride);
+    auto out = mesh.m_vertices.data();
+    for (std::size_t i = 0; i < unique.size(); ++i) {
+        auto& c = unique[i];
+        auto& pos = obj.m_positions[c.m_pos];
+        std::memcpy(out, pos.m_vec.data(), 3 * sizeof(float));
+        out += 3 * sizeof(float);
+        if (normals) {
+            std::memcpy(out, obj.m_normals[c.m_normal].m_vec.data(), 3 * sizeof(float));
+            out += 3 * sizeof(float);
+        }
+        if (uvs) {
+            std::memcpy(out, obj.m_uvs[c.m_uv].data(), 2 * sizeof(float));
+            out += 2 * sizeof(float);
+        }
+
+        if (i == 0) {
+            mesh.m_min = mesh.m_max = pos;
+        }
+        for (std::size_t j = 0; j < 3; ++j) {
+            mesh.m_min.m_vec[j] = std::min(mesh.m_min.m_vec[j], pos.m_vec[j]);
+            mesh.m_max.m_vec[j] = std::max(mesh.m_max.m_vec[j], pos.m_vec[j]);
+        }
+    }
+    return mesh;
+}
@@ -0,0 +1,13 @@
+
+#ifndef _MESH_BUILDER_H_
+#define _MESH_BUILDER_H_
+
+#include "obj_loader.h"
+#include "mesh_file.h"
+
+// Build GL ready indexed buffers from OBJ geometry, with one vertex per unique
+// position/uv/normal tuple (positions, then normals and uvs if every corner
+// has them)
+mesh_buffers build_mesh(const obj_data& obj);
+
+#endif
@@ -0,0 +1,151 @@
+
+#include "mesh_file.h"
+
+#include <algorithm>
+#include <fstream>
+
+
+// Round up to the blob alignment
+static std::uint64_t align_offset(std::uint64_t offset) {
+    return (offset + mesh_file_alignment - 1) & ~std::uint64_t{mesh_file_alignment - 1};
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the size in bytes of a GL component type
+///
+/// @param[in]  type  The GL enum of the type
+///
+/// @return     the size (0 if it is not one of the types in mesh_file.h)
+///
+std::uint32_t gl_type_size(std::uint32_t type)
+{
+    switch (type) {
+        case gl_short:
+        case gl_unsigned_short:
+            return 2;
+        case gl_unsigned_int:
+        case gl_float:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Write a mesh file. The indices are stored as 16 bit values
+/// when every vertex can be addressed with them (WebGL 1 needs an extension
+/// for 32 bit indices), and as 32 bit values otherwise.
+///
+/// @param[in]  path  The path of the file
+/// @param[in]  mesh  The mesh
+///
+/// @return     true if the file was written
+///
+bool write_mesh_file(const std::string& path, const mesh_buffers& mesh)
+{
+    if (mesh.m_attributes.size() > mesh_max_attributes || mesh.m_lods.size() > mesh_max_lods) {
+        return false;
+    }
+
+    auto vertex_count = mesh.vertex_count();
+    auto short_indices = vertex_count <= 0x10000;
+
+    mesh_file_header header {};
+    header.m_magic = mesh_file_magic;
+    header.m_version = mesh_file_version;
+    header.m_vertex_count = static_cast<std::uint32_t>(vertex_count);
+    header.m_index_count = static_cast<std::uint32_t>(mesh.m_indices.size());
+    header.m_index_type = short_indices ? gl_unsigned_short : gl_unsigned_int;
+    header.m_vertex_stride = mesh.m_stride;
+    header.m_attribute_count = static_cast<std::uint32_t>(mesh.m_attributes.size());
+    std::copy(mesh.m_attributes.begin(), mesh.m_attributes.end(), header.m_attributes.begin());
+    header.m_min = mesh.m_min.m_vec;
+    header.m_max = mesh.m_max.m_vec;
+    header.m_uv_min = mesh.m_uv_min;
+    header.m_uv_max = mesh.m_uv_max;
+    header.m_lod_count = 1;
+    header.m_lods[0] = {0, header.m_index_count, 0};
+    if (!mesh.m_lods.empty()) {
+        header.m_lod_count = static_cast<std::uint32_t>(mesh.m_lods.size());
+        std::copy(mesh.m_lods.begin(), mesh.m_lods.end(), header.m_lods.begin());
+    }
+    header.m_vertex_offset = align_offset(sizeof(header));
+    header.m_vertex_bytes = vertex_count * mesh.m_stride;
+    header.m_index_offset = align_offset(header.m_vertex_offset + header.m_vertex_bytes);
+    header.m_index_bytes = mesh.m_indices.size() * (short_indices ? 2 : 4);
+
+    std::ofstream out(path, std::ios::binary);
+    const char padding[mesh_file_alignment] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.m_vertex_offset - sizeof(header)));
+    out.write(reinterpret_cast<const char*>(mesh.m_vertices.data()),
+        static_cast<std::streamsize>(header.m_vertex_bytes));
+    out.write(padding, static_cast<std::streamsize>(
+        header.m_index_offset - header.m_vertex_offset - header.m_vertex_bytes));
+    if (short_indices) {
+        std::vector<std::uint16_t> indices(mesh.m_indices.begin(), mesh.m_indices.end());
+        out.write(reinterpret_cast<const char*>(indices.data()),
+            static_cast<std::streamsize>(header.m_index_bytes));
+    }
+    else {
+        out.write(reinterpret_cast<const char*>(mesh.m_indices.data()),
+            static_cast<std::streamsize>(header.m_index_bytes));
+    }
+    return static_cast<bool>(out);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return true if the header describes blobs that are within the
+/// file and consistent with the counts and attributes
+///
+/// @param[in]  h     The header
+/// @param[in]  size  The size of the file
+///
+static bool valid_header(const mesh_file_header& h, std::size_t size)
+{
+    if (h.m_magic != mesh_file_magic || h.m_version != mesh_file_version
+        || h.m_attribute_count > mesh_max_attributes || h.m_vertex_stride == 0
+        || h.m_lod_count == 0 || h.m_lod_count > mesh_max_lods) {
+        return false;
+    }
+    for (std::size_t i = 0; i < h.m_attribute_count; ++i) {
+        auto& a = h.m_attributes[i];
+        if (gl_type_size(a.m_type) == 0
+            || a.m_offset + a.m_components * gl_type_size(a.m_type) > h.m_vertex_stride) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < h.m_lod_count; ++i) {
+        auto& lod = h.m_lods[i];
+        if (std::uint64_t{lod.m_index_offset} + lod.m_index_count > h.m_index_count) {
+            return false;
+        }
+    }
+
+    auto index_size = gl_type_size(h.m_index_type);
+    return (h.m_index_type == gl_unsigned_short || h.m_index_type == gl_unsigned_int)
+        && h.m_vertex_offset % mesh_file_alignment == 0
+        && h.m_index_offset % mesh_file_alignment == 0
+        && h.m_vertex_bytes == std::uint64_t{h.m_vertex_count} * h.m_vertex_stride
+        && h.m_index_bytes == std::uint64_t{h.m_index_count} * index_size
+        && h.m_vertex_offset >= sizeof(h)
+        && h.m_vertex_offset <= size && h.m_vertex_bytes <= size - h.m_vertex_offset
+        && h.m_index_offset >= h.m_vertex_offset + h.m_vertex_bytes
+        && h.m_index_offset <= size && h.m_index_bytes <= size - h.m_index_offset;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Map a mesh file and check its header. The blobs are not read
+/// (so loading costs only what the GL upload reads), and the indices are
+/// not checked against the vertex count.
+///
+/// @param[in]  path  The path of the file
+///
+mesh_file::mesh_file(const std::string& path)
+    : m_file(path)
+{
+    if (m_file.is_open()
+        && (m_file.size() < sizeof(mesh_file_header) || !valid_header(header(), m_file.size()))) {
+        m_file.close();
+    }
+}
@@ -0,0 +1,164 @@
+
+#ifndef _MESH_FILE_H_
+#define _MESH_FILE_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+#include "mapped_file.h"
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+// The binary mesh format (.mesh files, written by spear-meshc). A file is a
+// mesh_file_header followed by the vertex and index blobs, each starting on a
+// mesh_file_alignment boundary. The blobs are exactly what glBufferData
+// takes: interleaved vertices described by the attributes of the header, and
+// 16 or 32 bit indices. The levels of detail of the mesh are ranges of the
+// index buffer, finest first, that share the vertices. Everything is
+// little-endian (as are all the targets).
+//
+// Readers reject files with a different magic or version, so the version
+// must be bumped whenever the layout changes.
+//
+
+// "SPMH" read as a little-endian 32 bit value
+constexpr std::uint32_t mesh_file_magic = 0x484d5053u;
+constexpr std::uint32_t mesh_file_version = 3;
+constexpr std::size_t mesh_file_alignment = 64;
+constexpr std::size_t mesh_max_attributes = 4;
+constexpr std::size_t mesh_max_lods = 8;
+
+// The values of the GL enums used in the files, so they are passed to
+// glVertexAttribPointer and glDrawElements as is
+constexpr std::uint32_t gl_short = 0x1402;
+constexpr std::uint32_t gl_unsigned_short = 0x1403;
+constexpr std::uint32_t gl_unsigned_int = 0x1405;
+constexpr std::uint32_t gl_float = 0x1406;
+
+// Return the size in bytes of a GL component type (0 if it is unknown)
+std::uint32_t gl_type_size(std::uint32_t type);
+
+// What an attribute holds (also its attribute location in the shaders)
+enum mesh_semantic : std::uint8_t {
+    mesh_position = 0,
+    mesh_normal = 1,
+    mesh_uv = 2
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One attribute of the interleaved vertices (the arguments of
+/// glVertexAttribPointer besides the stride)
+///
+struct mesh_attribute
+{
+    std::uint8_t m_semantic;
+    std::uint8_t m_components;
+    std::uint8_t m_normalized;
+    std::uint8_t m_offset;
+    std::uint32_t m_type;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One level of detail: a range of the index buffer (in indices)
+/// that draws the mesh with at most m_error of deviation (in model space)
+///
+struct mesh_lod
+{
+    std::uint32_t m_index_offset;
+    std::uint32_t m_index_count;
+    float m_error;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The header at the start of a mesh file
+///
+struct mesh_file_header
+{
+    std::uint32_t m_magic;
+    std::uint32_t m_version;
+    std::uint32_t m_vertex_count;
+    std::uint32_t m_index_count;
+    std::uint32_t m_index_type;
+    std::uint32_t m_vertex_stride;
+    std::uint32_t m_attribute_count;
+    std::uint32_t m_lod_count;
+    std::array<mesh_attribute, mesh_max_attributes> m_attributes;
+    std::array<float, 3> m_min;
+    std::array<float, 3> m_max;
+    std::array<float, 2> m_uv_min;
+    std::array<float, 2> m_uv_max;
+    std::array<mesh_lod, mesh_max_lods> m_lods;
+    std::uint64_t m_vertex_offset;
+    std::uint64_t m_vertex_bytes;
+    std::uint64_t m_index_offset;
+    std::uint64_t m_index_bytes;
+};
+
+static_assert(sizeof(mesh_file_header) == 232, "The mesh file header has no padding");
+
+//------------------------------------------------------------------------------
+/// @brief      A mesh in memory as it is written to a file: interleaved
+/// vertices (m_stride bytes each), 32 bit indices (narrowed to 16 bits when
+/// the file is written, if they fit), the bounds of the positions and uvs
+/// (which quantized vertices are relative to), and the levels of detail (the
+/// whole index buffer is the only level when there are none).
+///
+struct mesh_buffers
+{
+    std::vector<mesh_attribute> m_attributes;
+    std::uint32_t m_stride;
+    std::vector<std::uint8_t> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+    vector3 m_min;
+    vector3 m_max;
+    std::array<float, 2> m_uv_min {{0, 0}};
+    std::array<float, 2> m_uv_max {{1, 1}};
+    std::vector<mesh_lod> m_lods;
+
+    std::size_t vertex_count() const {
+        return m_stride ? m_vertices.size() / m_stride : 0;
+    }
+};
+
+// Write a mesh file (returns false if the file cannot be written)
+bool write_mesh_file(const std::string& path, const mesh_buffers& mesh);
+
+//------------------------------------------------------------------------------
+/// @brief      This class maps a mesh file and checks its header, so the
+/// blobs can be handed to GL without being read or copied first.
+///
+class mesh_file
+{
+public:
+    mapped_file m_file;
+
+public: // Constructors ---------------------------------------------
+
+    mesh_file() = default;
+
+    // Map the file at path (check is_valid for errors)
+    explicit mesh_file(const std::string& path);
+
+public: // Accessor methods -----------------------------------------
+
+    // The header (only when is_valid)
+    const mesh_file_header& header() const {
+        return *reinterpret_cast<const mesh_file_header*>(m_file.data());
+    }
+
+    const void* vertex_data() const { return m_file.data() + header().m_vertex_offset; }
+
+    const void* index_data() const { return m_file.data() + header().m_index_offset; }
+
+public: // Information interface mthods -----------------------------
+
+    // Return true if a valid mesh file is mapped
+    bool is_valid() const { return m_file.is_open(); }
+
+};
+
+#endif
@@ -0,0 +1,357 @@
+
+#include "mesh_optimizer.h"
+
+#include "../linalg/vector3.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+
+// Marks a vertex that has not been renumbered (or a missing fanning vertex)
+static constexpr std::uint32_t no_vertex = 0xffffffffu;
+
+//------------------------------------------------------------------------------
+/// @brief      A simulated FIFO post-transform cache. Each vertex keeps the
+/// time (the number of misses so far) it entered the cache, so a vertex is
+/// cached while fewer than size misses have happened since.
+///
+struct fifo_cache
+{
+    std::vector<std::size_t> m_stamps;
+    std::size_t m_size;
+    std::size_t m_time;
+
+    fifo_cache(std::size_t vertex_count, std::size_t size)
+        : m_stamps(vertex_count, 0), m_size(size), m_time(size + 1)
+    {}
+
+    // Return true if the vertex missed (and add it to the cache)
+    bool access(std::uint32_t v) {
+        if (m_time - m_stamps[v] > m_size) {
+            m_stamps[v] = m_time++;
+            return true;
+        }
+        return false;
+    }
+
+    // Return the number of the vertices of a triangle that missed
+    std::size_t access(const std::uint32_t* triangle) {
+        return std::size_t{access(triangle[0])} + access(triangle[1]) + access(triangle[2]);
+    }
+
+    // Empty the cache
+    void flush() {
+        m_time += m_size + 1;
+    }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Simulate a FIFO post-transform cache for a triangle list and
+/// count the vertices that are transformed
+///
+/// @param[in]  indices       The triangle list
+/// @param[in]  index_count   The number of indices
+/// @param[in]  vertex_count  The number of vertices (larger than every index)
+/// @param[in]  cache_size    The number of vertices in the cache
+///
+/// @return     the statistics
+///
+vertex_cache_stats analyze_vertex_cache(const std::uint32_t* indices, std::size_t index_count,
+    std::size_t vertex_count, std::size_t cache_size)
+{
+    fifo_cache cache(vertex_count, cache_size);
+    auto triangle_count = index_count / 3;
+    std::size_t transformed = 0;
+    for (std::size_t t = 0; t < triangle_count; ++t) {
+        transformed += cache.access(indices + 3 * t);
+    }
+
+    vertex_cache_stats stats {transformed, 0, 0};
+    if (triangle_count != 0) {
+        stats.m_acmr = static_cast<scalar>(transformed) / static_cast<scalar>(triangle_count);
+    }
+    if (vertex_count != 0) {
+        stats.m_atvr = static_cast<scalar>(transformed) / static_cast<scalar>(vertex_count);
+    }
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reorder the triangles of a list for the post-transform cache
+/// (Tipsify, from Sander et al. "Fast Triangle Reordering for Vertex Locality
+/// and Reduced Overdraw"). The triangles around a fanning vertex are emitted
+/// together, and the next fanning vertex is the oldest vertex of that fan
+/// that will still be cached after its own triangles are emitted. At dead
+/// ends the order goes back to recently used vertices with live triangles,
+/// and then to the next such vertex in index order, which starts a cluster.
+/// This runs in linear time.
+///
+/// @param      indices       The triangle list (every index less than
+///                           vertex_count)
+/// @param[in]  index_count   The number of indices
+/// @param[in]  vertex_count  The number of vertices
+/// @param[in]  cache_size    The number of vertices in the cache
+///
+/// @return     the first triangle of each cluster
+///
+std::vector<std::size_t> optimize_vertex_cache(std::uint32_t* indices, std::size_t index_count,
+    std::size_t vertex_count, std::size_t cache_size)
+{
+    auto triangle_count = index_count / 3;
+    std::vector<std::size_t> clusters;
+    if (triangle_count == 0) {
+        return clusters;
+    }
+
+    // The triangles of each vertex (in compressed rows), and how many of them
+    // are still to be emitted
+    std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+    for (std::size_t i = 0; i < 3 * triangle_count; ++i) {
+        ++offsets[indices[i] + 1];
+    }
+    std::vector<std::uint32_t> live(vertex_count);
+    for (std::size_t v = 0; v < vertex_count; ++v) {
+        live[v] = offsets[v + 1];
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<std::uint32_t> adjacency(3 * triangle_count);
+    std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < 3 * triangle_count; ++i) {
+        adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+    }
+
+    fifo_cache cache(vertex_count, cache_size);
+    std::vector<std::uint8_t> emitted(triangle_count, 0);
+    std::vector<std::uint32_t> dead_ends;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> out;
+    out.reserve(3 * triangle_count);
+
+    std::size_t cursor = 0;
+    auto fan = no_vertex;
+    auto jumped = true;
+    while (true) {
+        if (fan == no_vertex) {
+            // Go back to a recently used vertex, or else start a new cluster
+            while (!dead_ends.empty() && fan == no_vertex) {
+                if (live[dead_ends.back()] > 0) {
+                    fan = dead_ends.back();
+                }
+                dead_ends.pop_back();
+            }
+            if (fan == no_vertex) {
+                while (cursor < vertex_count && live[cursor] == 0) {
+                    ++cursor;
+                }
+                if (cursor == vertex_count) {
+                    break;
+                }
+                fan = static_cast<std::uint32_t>(cursor);
+                jumped = true;
+            }
+        }
+        if (jumped) {
+            clusters.push_back(out.size() / 3);
+            jumped = false;
+        }
+
+        candidates.clear();
+        for (auto a = offsets[fan]; a < offsets[fan + 1]; ++a) {
+            auto t = adjacency[a];
+            if (emitted[t]) {
+                continue;
+            }
+            emitted[t] = 1;
+            for (std::size_t c = 0; c < 3; ++c) {
+                auto v = indices[3 * t + c];
+                out.push_back(v);
+                dead_ends.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                cache.access(v);
+            }
+        }
+
+        // Prefer the oldest candidate that stays cached through its own fan
+        // (each live triangle can add two vertices to the cache)
+        fan = no_vertex;
+        std::size_t best = 0;
+        for (auto v : candidates) {
+            if (live[v] == 0) {
+                continue;
+            }
+            auto age = cache.m_time - cache.m_stamps[v];
+            auto priority = age + 2 * live[v] <= cache_size ? age + 1 : 1;
+            if (priority > best) {
+                best = priority;
+                fan = v;
+            }
+        }
+    }
+
+    std::copy(out.begin(), out.end(), indices);
+    return clusters;
+}
+
+// Read the position of a vertex
+static vector3 read_position(const mesh_buffers& mesh, std::size_t offset, std::uint32_t v) {
+    vector3 pos;
+    std::memcpy(pos.m_vec.data(), mesh.m_vertices.data() + v * mesh.m_stride + offset, 3 * sizeof(float));
+    return pos;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reorder the clusters of a cache optimized triangle list so
+/// that the triangles likely to occlude others are drawn first (the second
+/// half of Tipsify). The clusters are split further where the ACMR of the
+/// part so far (on a cold cache) is within threshold times the ACMR of the
+/// whole cluster, so reordering costs little vertex processing. Then they are
+/// sorted by how far out their area weighted centroid is along their average
+/// normal, relative to the centroid of the mesh: clusters on the outside
+/// facing out come first. Meshes without float positions are not changed.
+///
+/// @param      indices      The triangle list
+/// @param[in]  index_count  The number of indices
+/// @param[in]  clusters     The first triangle of each cluster (from
+///                          optimize_vertex_cache)
+/// @param[in]  mesh         The vertices (the indices need not be its own)
+/// @param[in]  threshold    How much larger than a cluster's the ACMR of its
+///                          parts may be
+/// @param[in]  cache_size   The number of vertices in the cache
+///
+void optimize_overdraw(std::uint32_t* indices, std::size_t index_count,
+    const std::vector<std::size_t>& clusters, const mesh_buffers& mesh,
+    scalar threshold, std::size_t cache_size)
+{
+    auto position = std::find_if(mesh.m_attributes.begin(), mesh.m_attributes.end(),
+        [](const mesh_attribute& a) { return a.m_semantic == mesh_position; });
+    auto triangle_count = index_count / 3;
+    if (position == mesh.m_attributes.end() || position->m_type != gl_float
+        || position->m_components != 3 || clusters.empty() || triangle_count == 0) {
+        return;
+    }
+
+    // Split the clusters
+    fifo_cache cache(mesh.vertex_count(), cache_size);
+    std::vector<std::size_t> starts;
+    for (std::size_t i = 0; i < clusters.size(); ++i) {
+        auto begin = clusters[i];
+        auto end = i + 1 < clusters.size() ? clusters[i + 1] : triangle_count;
+
+        cache.flush();
+        std::size_t misses = 0;
+        for (auto t = begin; t < end; ++t) {
+            misses += cache.access(indices + 3 * t);
+        }
+        auto limit = threshold * static_cast<scalar>(misses) / static_cast<scalar>(end - begin);
+
+        cache.flush();
+        misses = 0;
+        starts.push_back(begin);
+        for (auto t = begin; t + 1 < end; ++t) {
+            misses += cache.access(indices + 3 * t);
+            if (static_cast<scalar>(misses) <= limit * static_cast<scalar>(t + 1 - starts.back())) {
+                starts.push_back(t + 1);
+                cache.flush();
+                misses = 0;
+            }
+        }
+    }
+    starts.push_back(triangle_count);
+
+    // Find the centroid and normal of each part, and of the mesh
+    auto part_count = starts.size() - 1;
+    std::vector<vector3> centroids(part_count);
+    std::vector<vector3> normals(part_count);
+    vector3 mesh_centroid;
+    scalar mesh_area = 0;
+    for (std::size_t p = 0; p < part_count; ++p) {
+        vector3 sum;
+        scalar area = 0;
+        for (auto t = starts[p]; t < starts[p + 1]; ++t) {
+            auto a = read_position(mesh, position->m_offset, indices[3 * t]);
+            auto b = read_position(mesh, position->m_offset, indices[3 * t + 1]);
+            auto c = read_position(mesh, position->m_offset, indices[3 * t + 2]);
+            vector3 normal = b - a;
+            normal.cross(c - a);
+            auto triangle_area = normal.len();
+            sum += (a + b + c) * triangle_area;
+            area += triangle_area;
+            normals[p] += normal;
+        }
+        mesh_centroid += sum;
+        mesh_area += area;
+        centroids[p] = sum * (1 / (3 * std::max(area, std::numeric_limits<scalar>::min())));
+    }
+    mesh_centroid *= 1 / (3 * std::max(mesh_area, std::numeric_limits<scalar>::min()));
+
+    std::vector<scalar> keys(part_count);
+    for (std::size_t p = 0; p < part_count; ++p) {
+        vector3 offset = centroids[p] - mesh_centroid;
+        keys[p] = offset.dot(normals[p]) / std::max(normals[p].len(), std::numeric_limits<scalar>::min());
+    }
+    std::vector<std::size_t> order(part_count);
+    for (std::size_t p = 0; p < part_count; ++p) {
+        order[p] = p;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&](std::size_t a, std::size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<std::uint32_t> out;
+    out.reserve(3 * triangle_count);
+    for (auto p : order) {
+        out.insert(out.end(), indices + 3 * starts[p], indices + 3 * starts[p + 1]);
+    }
+    std::copy(out.begin(), out.end(), indices);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Renumber the vertices in the order the indices first use them
+/// and reorder the vertex buffer to match, so vertex fetches walk through
+/// memory. Vertices that are not used are dropped.
+///
+/// @param      mesh  The mesh
+///
+/// @return     a reference to the mesh
+///
+mesh_buffers& optimize_vertex_fetch(mesh_buffers& mesh)
+{
+    std::vector<std::uint32_t> remap(mesh.vertex_count(), no_vertex);
+    std::uint32_t next = 0;
+    for (auto& i : mesh.m_indices) {
+        if (remap[i] == no_vertex) {
+            remap[i] = next++;
+        }
+        i = remap[i];
+    }
+
+    std::vector<std::uint8_t> vertices(std::size_t{next} * mesh.m_stride);
+    for (std::size_t v = 0; v < remap.size(); ++v) {
+        if (remap[v] != no_vertex) {
+            std::memcpy(vertices.data() + std::size_t{remap[v]} * mesh.m_stride,
+                mesh.m_vertices.data() + v * mesh.m_stride, mesh.m_stride);
+        }
+    }
+    mesh.m_vertices.swap(vertices);
+    return mesh;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Optimize a mesh for the post-transform cache, overdraw and
+/// vertex fetches (in that order, since each pass keeps what the earlier
+/// ones did). Run this before the vertices are quantized.
+///
+/// @param      mesh        The mesh
+/// @param[in]  cache_size  The number of vertices in the cache
+///
+/// @return     the cache statistics of the optimized mesh
+///
+vertex_cache_stats optimize_mesh(mesh_buffers& mesh, std::size_t cache_size)
+{
+    auto& indices = mesh.m_indices;
+    auto clusters = optimize_vertex_cache(indices.data(), indices.size(), mesh.vertex_count(), cache_size);
+    optimize_overdraw(indices.data(), indices.size(), clusters, mesh, 1.05f, cache_size);
+    optimize_vertex_fetch(mesh);
+    return analyze_vertex_cache(indices.data(), indices.size(), mesh.vertex_count(), cache_size);
+}
@@ -0,0 +1,52 @@
+
+#ifndef _MESH_OPTIMIZER_H_
+#define _MESH_OPTIMIZER_H_
+
+#include "../linalg/linalg.h"
+#include "mesh_file.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// The size of the post-transform cache the triangle order is tuned for (a
+// FIFO of this many vertices; actual GPUs vary, and 16 is a safe middle)
+constexpr std::size_t vertex_cache_size = 16;
+
+//------------------------------------------------------------------------------
+/// @brief      How well a triangle order uses the post-transform cache:
+/// the number of vertices the vertex shader runs for, per triangle (ACMR,
+/// 0.5 at best for large meshes, 3 at worst) and per vertex (ATVR, 1 at
+/// best)
+///
+struct vertex_cache_stats
+{
+    std::size_t m_transformed;
+    scalar m_acmr;
+    scalar m_atvr;
+};
+
+// Simulate the post-transform cache for a triangle list
+vertex_cache_stats analyze_vertex_cache(const std::uint32_t* indices, std::size_t index_count,
+    std::size_t vertex_count, std::size_t cache_size=vertex_cache_size);
+
+// Reorder triangles for the post-transform cache, returning the first
+// triangle of each cluster (where the order had to jump)
+std::vector<std::size_t> optimize_vertex_cache(std::uint32_t* indices, std::size_t index_count,
+    std::size_t vertex_count, std::size_t cache_size=vertex_cache_size);
+
+// Reorder the clusters of a cache optimized triangle list to reduce overdraw,
+// splitting them further while the ACMR stays within threshold times theirs
+void optimize_overdraw(std::uint32_t* indices, std::size_t index_count,
+    const std::vector<std::size_t>& clusters, const mesh_buffers& mesh,
+    scalar threshold=1.05f, std::size_t cache_size=vertex_cache_size);
+
+// Renumber the vertices in the order they are first used (dropping unused
+// ones) and reorder the vertex buffer to match
+mesh_buffers& optimize_vertex_fetch(mesh_buffers& mesh);
+
+// Apply the three passes above to a mesh (with float positions) and return
+// the cache statistics of the result
+vertex_cache_stats optimize_mesh(mesh_buffers& mesh, std::size_t cache_size=vertex_cache_size);
+
+#endif
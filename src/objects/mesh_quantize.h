@@ -0,0 +1,44 @@
+
+#ifndef _MESH_QUANTIZE_H_
+#define _MESH_QUANTIZE_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+#include "../linalg/matrix4.h"
+#include "mesh_file.h"
+
+#include <array>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Quantized vertices are half the size of float ones (16 bytes instead of 32
+// for position, normal and uv), and GL expands them with normalized
+// attributes, so the vertex shader only has to undo the scaling:
+//
+//  - positions are unsigned shorts across the bounds of the mesh (padded to
+//    8 bytes), and dequantize_positions maps them back to model space
+//  - normals are octahedral encoded into two shorts, decoded with
+//        vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+//        if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+//        n = normalize(n);
+//  - uvs are unsigned shorts across the uv bounds of the mesh, and
+//    dequantize_uvs gives the scale (xy) and offset (zw) that map them back
+//
+
+// Encode a unit vector as the octahedral projection (as normalized shorts)
+std::array<std::int16_t, 2> oct_encode(const vector3& n);
+
+// Decode an octahedral encoded unit vector
+vector3 oct_decode(const std::array<std::int16_t, 2>& e);
+
+// Quantize the float attributes of a mesh (meshes with positions that are
+// not floats are not changed)
+mesh_buffers& quantize_mesh(mesh_buffers& mesh);
+
+// Return the matrix that maps quantized positions to model space (row vectors)
+matrix4 dequantize_positions(const vector3& min, const vector3& max);
+
+// Return the scale and offset that map quantized uvs back
+std::array<float, 4> dequantize_uvs(const std::array<float, 2>& min, const std::array<float, 2>& max);
+
+#endif
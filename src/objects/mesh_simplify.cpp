@@ -0,0 +1,369 @@
+
+#include "mesh_simplify.h"
+
+#include "../linalg/vector3.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+
+using position_type = std::array<double, 3>;
+
+//------------------------------------------------------------------------------
+/// @brief      A quadric error metric (Garland and Heckbert "Surface
+/// Simplification Using Quadric Error Metrics"): the area weighted sum of
+/// the squared distances to a set of planes, as the upper triangle of a
+/// symmetric 4x4 matrix
+///
+struct quadric
+{
+    std::array<double, 10> m_q;
+    double m_weight;
+
+    quadric()
+        : m_q{}, m_weight(0)
+    {}
+
+    // Add the plane n.p + d = 0 (n is unit length)
+    void add_plane(const position_type& n, double d, double weight) {
+        std::array<double, 4> p {{n[0], n[1], n[2], d}};
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            for (std::size_t j = i; j < 4; ++j) {
+                m_q[k++] += weight * p[i] * p[j];
+            }
+        }
+        m_weight += weight;
+    }
+
+    quadric& operator+=(const quadric& other) {
+        for (std::size_t i = 0; i < m_q.size(); ++i) {
+            m_q[i] += other.m_q[i];
+        }
+        m_weight += other.m_weight;
+        return *this;
+    }
+
+    // Return the weighted squared distance of a point to the planes
+    double evaluate(const position_type& p) const {
+        auto x = p[0], y = p[1], z = p[2];
+        return m_q[0] * x * x + 2 * m_q[1] * x * y + 2 * m_q[2] * x * z + 2 * m_q[3] * x
+            + m_q[4] * y * y + 2 * m_q[5] * y * z + 2 * m_q[6] * y
+            + m_q[7] * z * z + 2 * m_q[8] * z
+            + m_q[9];
+    }
+};
+
+// Return the (unnormalized) normal of a triangle
+static position_type triangle_normal(const position_type& a, const position_type& b, const position_type& c) {
+    std::array<double, 3> u {{b[0] - a[0], b[1] - a[1], b[2] - a[2]}};
+    std::array<double, 3> v {{c[0] - a[0], c[1] - a[1], c[2] - a[2]}};
+    return {{u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]}};
+}
+
+static double dot(const position_type& a, const position_type& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//------------------------------------------------------------------------------
+/// @brief      An edge collapse: the vertex m_from moves onto m_to
+///
+struct edge_collapse
+{
+    double m_cost;
+    std::uint32_t m_from;
+    std::uint32_t m_to;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Simplify a triangle list by collapsing edges (a vertex moves
+/// onto a neighbour, so the result uses a subset of the vertices and needs
+/// no new ones). Each vertex has the quadric of the planes of its triangles,
+/// which it passes on when it collapses, and the collapses with the least
+/// error go first. The collapses of each pass touch disjoint triangles, and
+/// collapses that would flip a triangle are skipped. Vertices on open
+/// borders and attribute seams (several vertices at one position, e.g. for
+/// uv or normal discontinuities) do not move, so the outline and the
+/// attributes stay intact.
+///
+/// @param[in]  mesh                The vertices (positions must be floats)
+/// @param[in]  indices             The triangle list
+/// @param[in]  index_count         The number of indices
+/// @param[in]  target_index_count  The number of indices to stop at
+/// @param[in]  max_error           The largest error allowed (in model space)
+/// @param      error               The error so far, raised to the largest
+///                                 error of the collapses
+///
+/// @return     the simplified triangle list (the input when positions are
+///             not floats)
+///
+std::vector<std::uint32_t> simplify_indices(const mesh_buffers& mesh, const std::uint32_t* indices,
+    std::size_t index_count, std::size_t target_index_count, scalar max_error, scalar& error)
+{
+    std::vector<std::uint32_t> result(indices, indices + index_count / 3 * 3);
+    auto position = std::find_if(mesh.m_attributes.begin(), mesh.m_attributes.end(),
+        [](const mesh_attribute& a) { return a.m_semantic == mesh_position; });
+    if (position == mesh.m_attributes.end() || position->m_type != gl_float || position->m_components != 3) {
+        return result;
+    }
+
+    auto vertex_count = mesh.vertex_count();
+    std::vector<position_type> positions(vertex_count);
+    std::vector<std::array<std::uint32_t, 3>> keys(vertex_count);
+    for (std::size_t v = 0; v < vertex_count; ++v) {
+        std::array<float, 3> p;
+        std::memcpy(p.data(), mesh.m_vertices.data() + v * mesh.m_stride + position->m_offset, sizeof(p));
+        std::memcpy(keys[v].data(), p.data(), sizeof(p));
+        positions[v] = {{p[0], p[1], p[2]}};
+    }
+
+    // Vertices at the same position share the first of them as their
+    // canonical vertex (and are locked, since they are on a seam)
+    std::vector<std::uint32_t> order(vertex_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [&](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+    std::vector<std::uint32_t> canonical(vertex_count);
+    std::vector<std::uint8_t> locked(vertex_count, 0);
+    for (std::size_t i = 0; i < vertex_count; ) {
+        auto j = i;
+        while (j < vertex_count && keys[order[j]] == keys[order[i]]) {
+            canonical[order[j++]] = order[i];
+        }
+        locked[order[i]] = j - i > 1;
+        i = j;
+    }
+
+    // Lock the vertices of edges that only one triangle has
+    std::vector<std::uint64_t> edges;
+    edges.reserve(result.size());
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        auto a = canonical[result[i]];
+        auto b = canonical[result[i % 3 == 2 ? i - 2 : i + 1]];
+        if (a != b) {
+            edges.push_back(std::uint64_t{std::min(a, b)} << 32 | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (std::size_t i = 0; i < edges.size(); ) {
+        auto j = i;
+        while (j < edges.size() && edges[j] == edges[i]) {
+            ++j;
+        }
+        if (j - i == 1) {
+            locked[edges[i] >> 32] = 1;
+            locked[edges[i] & 0xffffffffu] = 1;
+        }
+        i = j;
+    }
+
+    std::vector<quadric> quadrics(vertex_count);
+    for (std::size_t t = 0; t < result.size() / 3; ++t) {
+        auto a = canonical[result[3 * t]];
+        auto b = canonical[result[3 * t + 1]];
+        auto c = canonical[result[3 * t + 2]];
+        auto n = triangle_normal(positions[a], positions[b], positions[c]);
+        auto len = std::sqrt(dot(n, n));
+        if (len <= 0) {
+            continue;
+        }
+        n = {{n[0] / len, n[1] / len, n[2] / len}};
+        auto d = -dot(n, positions[a]);
+        for (auto v : {a, b, c}) {
+            quadrics[v].add_plane(n, d, len / 2);
+        }
+    }
+
+    auto max_cost = double{max_error} * max_error;
+    auto worst = double{error} * error;
+    std::vector<std::uint32_t> remap(vertex_count);
+    std::iota(remap.begin(), remap.end(), 0);
+    std::vector<std::uint32_t> offsets(vertex_count + 1);
+    std::vector<std::uint32_t> adjacency;
+    std::vector<std::uint8_t> touched(vertex_count);
+    std::vector<edge_collapse> collapses;
+
+    while (result.size() > target_index_count) {
+        auto triangle_count = result.size() / 3;
+
+        // The triangles of each vertex (in compressed rows)
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (auto v : result) {
+            ++offsets[v + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        adjacency.resize(result.size());
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            adjacency[fill[result[i]]++] = static_cast<std::uint32_t>(i / 3);
+        }
+
+        // Every edge, both ways (unless the vertex that moves is locked)
+        collapses.clear();
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            auto a = result[i];
+            auto b = result[i % 3 == 2 ? i - 2 : i + 1];
+            for (auto edge : {std::array<std::uint32_t, 2>{{a, b}}, std::array<std::uint32_t, 2>{{b, a}}}) {
+                auto from = edge[0], to = edge[1];
+                if (locked[canonical[from]]) {
+                    continue;
+                }
+                auto q = quadrics[from];
+                q += quadrics[canonical[to]];
+                auto cost = std::max(q.evaluate(positions[to]), 0.0) / std::max(q.m_weight, 1e-30);
+                collapses.push_back({cost, from, to});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+            [](const edge_collapse& a, const edge_collapse& b) { return a.m_cost < b.m_cost; });
+
+        std::fill(touched.begin(), touched.end(), 0);
+        auto needed = triangle_count - target_index_count / 3;
+        std::size_t removed = 0;
+        std::size_t collapsed = 0;
+        for (auto& c : collapses) {
+            if (c.m_cost > max_cost || removed >= needed) {
+                break;
+            }
+            if (touched[c.m_from] || touched[c.m_to]) {
+                continue;
+            }
+
+            // Skip the collapse if a triangle that stays would flip over
+            auto flips = false;
+            std::size_t removes = 0;
+            for (auto a = offsets[c.m_from]; a < offsets[c.m_from + 1] && !flips; ++a) {
+                auto tri = &result[3 * adjacency[a]];
+                if (tri[0] == c.m_to || tri[1] == c.m_to || tri[2] == c.m_to) {
+                    ++removes;
+                    continue;
+                }
+                std::array<position_type, 3> p;
+                for (std::size_t k = 0; k < 3; ++k) {
+                    p[k] = positions[tri[k]];
+                }
+                auto before = triangle_normal(p[0], p[1], p[2]);
+                for (std::size_t k = 0; k < 3; ++k) {
+                    p[k] = tri[k] == c.m_from ? positions[c.m_to] : p[k];
+                }
+                auto after = triangle_normal(p[0], p[1], p[2]);
+                flips = dot(before, after) <= 0;
+            }
+            if (flips) {
+                continue;
+            }
+
+            remap[c.m_from] = c.m_to;
+            quadrics[canonical[c.m_to]] += quadrics[c.m_from];
+            worst = std::max(worst, c.m_cost);
+            removed += removes;
+            ++collapsed;
+            for (auto a = offsets[c.m_from]; a < offsets[c.m_from + 1]; ++a) {
+                auto tri = &result[3 * adjacency[a]];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+        }
+        if (collapsed == 0) {
+            break;
+        }
+
+        // Drop the triangles that collapsed
+        std::size_t out = 0;
+        for (std::size_t t = 0; t < triangle_count; ++t) {
+            auto a = remap[result[3 * t]];
+            auto b = remap[result[3 * t + 1]];
+            auto c = remap[result[3 * t + 2]];
+            if (a != b && b != c && a != c) {
+                result[out++] = a;
+                result[out++] = b;
+                result[out++] = c;
+            }
+        }
+        result.resize(out);
+    }
+
+    error = static_cast<scalar>(std::sqrt(worst));
+    return result;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Append a chain of levels of detail to the index buffer of a
+/// mesh (replacing any it has). Each level simplifies the one before to
+/// about ratio times its triangles and is ordered for the vertex cache. The
+/// chain stops when a level would be less than 10% smaller than the one
+/// before (the error limit is reached) or there are mesh_max_lods levels.
+/// Run this after optimize_mesh (the levels share its vertex order) and
+/// before quantize_mesh.
+///
+/// @param      mesh                The mesh
+/// @param[in]  ratio               The fraction of the triangles to keep
+/// @param[in]  max_error_fraction  The largest error allowed, as a fraction
+///                                 of the diagonal of the bounds
+/// @param[in]  cache_size          The number of vertices in the cache
+///
+/// @return     a reference to the mesh
+///
+mesh_buffers& build_lods(mesh_buffers& mesh, scalar ratio, scalar max_error_fraction, std::size_t cache_size)
+{
+    auto base = mesh.m_lods.empty() ? mesh.m_indices.size() : mesh.m_lods[0].m_index_count;
+    mesh.m_indices.resize(base);
+    mesh.m_lods.assign(1, {0, static_cast<std::uint32_t>(base), 0});
+
+    vector3 diagonal = mesh.m_max - mesh.m_min;
+    auto max_error = max_error_fraction * diagonal.len();
+    scalar error = 0;
+    while (mesh.m_lods.size() < mesh_max_lods) {
+        auto last = mesh.m_lods.back();
+        auto target = static_cast<std::size_t>(static_cast<scalar>(last.m_index_count / 3) * ratio) * 3;
+        auto lod = simplify_indices(mesh, mesh.m_indices.data() + last.m_index_offset,
+            last.m_index_count, target, max_error, error);
+        if (lod.empty() || 10 * lod.size() > 9 * std::size_t{last.m_index_count}) {
+            break;
+        }
+
+        optimize_vertex_cache(lod.data(), lod.size(), mesh.vertex_count(), cache_size);
+        mesh.m_lods.push_back({static_cast<std::uint32_t>(mesh.m_indices.size()),
+            static_cast<std::uint32_t>(lod.size()), error});
+        mesh.m_indices.insert(mesh.m_indices.end(), lod.begin(), lod.end());
+    }
+    return mesh;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return how many pixels a model space length at distance 1
+/// covers on the screen (divide by the distance for other distances)
+///
+/// @param[in]  fovy             The field of view (based on the y-axis)
+/// @param[in]  viewport_height  The height of the viewport in pixels
+///
+/// @return     the scale
+///
+scalar lod_pixel_scale(scalar fovy, scalar viewport_height)
+{
+    return viewport_height / (2 * std::tan(fovy / 2));
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Select the coarsest level of detail whose error covers at most
+/// max_pixels on the screen, so the change is not visible
+///
+/// @param[in]  lods         The levels of detail (finest first)
+/// @param[in]  lod_count    The number of levels
+/// @param[in]  distance     The distance from the camera to the mesh
+/// @param[in]  pixel_scale  The result of lod_pixel_scale for the camera
+/// @param[in]  max_pixels   The largest error allowed on the screen
+///
+/// @return     the index of the level
+///
+std::size_t select_lod(const mesh_lod* lods, std::size_t lod_count, scalar distance,
+    scalar pixel_scale, scalar max_pixels)
+{
+    std::size_t lod = 0;
+    while (lod + 1 < lod_count && lods[lod + 1].m_error * pixel_scale <= max_pixels * distance) {
+        ++lod;
+    }
+    return lod;
+}
@@ -0,0 +1,34 @@
+
+#ifndef _MESH_SIMPLIFY_H_
+#define _MESH_SIMPLIFY_H_
+
+#include "../linalg/linalg.h"
+#include "mesh_optimizer.h"
+#include "mesh_file.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Simplify a triangle list of a mesh (with float positions) towards
+// target_index_count indices, collapsing edges while the error (raised to the
+// largest collapse error, in model space) stays within max_error
+std::vector<std::uint32_t> simplify_indices(const mesh_buffers& mesh, const std::uint32_t* indices,
+    std::size_t index_count, std::size_t target_index_count, scalar max_error, scalar& error);
+
+// Append a chain of levels of detail to the index buffer of a mesh, each
+// with about ratio times the triangles of the one before, while the error
+// stays within max_error_fraction of the diagonal of the bounds
+mesh_buffers& build_lods(mesh_buffers& mesh, scalar ratio=0.5f, scalar max_error_fraction=0.02f,
+    std::size_t cache_size=vertex_cache_size);
+
+// Return the pixels per model space unit at distance 1, for a perspective
+// projection (with the arguments of matrix4::perspective) onto a viewport
+scalar lod_pixel_scale(scalar fovy, scalar viewport_height);
+
+// Return the coarsest level of detail whose error projects to at most
+// max_pixels at a distance
+std::size_t select_lod(const mesh_lod* lods, std::size_t lod_count, scalar distance,
+    scalar pixel_scale, scalar max_pixels=1);
+
+#endif
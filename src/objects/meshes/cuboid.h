@@ -1,12 +1,30 @@
-
 #ifndef _CUBE_H_
 #define _CUBE_H_
 
+#include "../../linalg/linalg.h"
+#include "../procedural.h"
+
+#include <array>
+#include <utility>
+
+// Gather the positions of the vertices of a generated mesh
+template <std::size_t V, std::size_t I, std::size_t... P>
+constexpr std::array<scalar, sizeof...(P)> gather_positions(const static_mesh<V, I>& mesh,
+    std::index_sequence<P...>) {
+    return {{static_cast<scalar>(mesh.m_vertices[P / 3 * generated_vertex_floats + P % 3])...}};
+}
+
 class cuboid
 {
-    std::array<scalar, 72>
 public:
-    cuboid();
+    // The positions of the four corners of each face
+    std::array<scalar, 72> m_positions;
+public:
+    // The corners come from make_cuboid, so a constexpr cuboid costs
+    // nothing at runtime
+    constexpr cuboid()
+        : m_positions(gather_positions(make_cuboid<1>(), std::make_index_sequence<72>{}))
+    {}
 };
 
 #endif
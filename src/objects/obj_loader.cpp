@@ -0,0 +1,433 @@
+
+#include "obj_loader.h"
+#include "mapped_file.h"
+#include "../linalg/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+
+// Powers of ten that are exact in a double
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Spaces within a line (a \r before the \n is treated as one)
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skip_blanks(const char* p, const char* last) {
+    while (p < last && is_blank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// Return the start of the next line (or last)
+static const char* next_line(const char* p, const char* last) {
+    auto eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(last - p)));
+    return eol ? eol + 1 : last;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Parse a decimal number (with an optional sign, fraction and
+/// exponent) in the style of std::from_chars: nothing is allocated and the
+/// end of the number is returned. Up to 19 significant digits are kept and
+/// scaled in double precision, so the result is exact to float precision.
+///
+/// @param[in]  p     The first character
+/// @param[in]  last  The end of the text
+/// @param[out] out   The number
+///
+/// @return     the character after the number, or nullptr if there is none
+///
+static const char* parse_scalar(const char* p, const char* last, scalar& out)
+{
+    auto negative = p < last && *p == '-';
+    if (p < last && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int digits = 0, exp10 = 0;
+    auto start = p;
+    for (; p < last && is_digit(*p); ++p) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            digits += mantissa != 0;
+        }
+        else {
+            ++exp10;
+        }
+    }
+    auto int_digits = p - start;
+    if (p < last && *p == '.') {
+        start = ++p;
+        for (; p < last && is_digit(*p); ++p) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                digits += mantissa != 0;
+                --exp10;
+            }
+        }
+        if (int_digits == 0 && p == start) {
+            return nullptr;
+        }
+    }
+    else if (int_digits == 0) {
+        return nullptr;
+    }
+
+    if (p < last && (*p == 'e' || *p == 'E')) {
+        auto q = p + 1;
+        auto exp_negative = q < last && *q == '-';
+        if (q < last && (*q == '-' || *q == '+')) {
+            ++q;
+        }
+        if (q < last && is_digit(*q)) {
+            int e = 0;
+            for (; q < last && is_digit(*q); ++q) {
+                e = std::min(e * 10 + (*q - '0'), 10000);
+            }
+            exp10 += exp_negative ? -e : e;
+            p = q;
+        }
+    }
+
+    // Zero stays zero whatever the exponent, and exponents past the range of
+    // a double give infinity or zero (never a scale that overflowed)
+    double value = 0;
+    if (mantissa != 0 && exp10 > 330) {
+        value = std::numeric_limits<double>::infinity();
+    }
+    else if (mantissa != 0 && exp10 >= -330) {
+        auto scale = std::abs(exp10) <= 22 ? exact_pow10[std::abs(exp10)] : std::pow(10.0, std::abs(exp10));
+        value = static_cast<double>(mantissa);
+        value = exp10 < 0 ? value / scale : value * scale;
+    }
+    out = static_cast<scalar>(negative ? -value : value);
+    return p;
+}
+
+// Parse an integer (with an optional sign), returning the character after
+// it or nullptr if there is none
+static const char* parse_int(const char* p, const char* last, std::int64_t& out)
+{
+    auto negative = p < last && *p == '-';
+    if (p < last && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+    auto start = p;
+    std::int64_t value = 0;
+    for (; p < last && is_digit(*p); ++p) {
+        value = std::min(value * 10 + (*p - '0'), std::int64_t{1} << 40);
+    }
+    if (p == start) {
+        return nullptr;
+    }
+    out = negative ? -value : value;
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      The part of a file parsed by one chunk. Relative indices can
+/// refer to earlier chunks, so they are stored relative to the start of the
+/// chunk (as a signed value) and listed with a mask of the relative indices
+/// (1 for the position, 2 for the uv and 4 for the normal) so the merge can
+/// fix them up.
+///
+struct obj_chunk
+{
+    obj_data m_data;
+    std::vector<std::pair<std::size_t, std::uint8_t>> m_relative;
+    bool m_ok = true;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Parse one corner of a face (v, v/vt, v//vn or v/vt/vn)
+///
+/// @param[in]  p       The first character of the corner
+/// @param[in]  last    The end of the line
+/// @param      chunk   The chunk (the attribute counts so far resolve
+///                     relative indices)
+/// @param[out] corner  The corner
+/// @param[out] rel     The mask of the relative indices of the corner
+///
+/// @return     the character after the corner, or nullptr if it is malformed
+///
+static const char* parse_corner(const char* p, const char* last, const obj_chunk& chunk,
+    obj_corner& corner, std::uint8_t& rel)
+{
+    auto& data = chunk.m_data;
+    std::size_t counts[3] = {data.m_positions.size(), data.m_uvs.size(), data.m_normals.size()};
+    std::uint32_t* indices[3] = {&corner.m_pos, &corner.m_uv, &corner.m_normal};
+    corner = {obj_no_index, obj_no_index, obj_no_index};
+    rel = 0;
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (i > 0) {
+            // A slash separates the indices, and an index may be empty
+            if (p == last || *p != '/') {
+                break;
+            }
+            if (++p < last && *p == '/') {
+                continue;
+            }
+            if (p == last || is_blank(*p)) {
+                break;
+            }
+        }
+
+        std::int64_t value;
+        p = parse_int(p, last, value);
+        if (!p || value == 0) {
+            return nullptr;
+        }
+        if (value > 0) {
+            // The largest index is one below obj_no_index
+            if (value > std::int64_t{obj_no_index}) {
+                return nullptr;
+            }
+            *indices[i] = static_cast<std::uint32_t>(value - 1);
+        }
+        else {
+            // Stored as a signed 32 bit offset from the start of the chunk
+            // (the merge rejects it if it resolves before the first index)
+            auto offset = static_cast<std::int64_t>(counts[i]) + value;
+            if (offset < std::numeric_limits<std::int32_t>::min()) {
+                return nullptr;
+            }
+            *indices[i] = static_cast<std::uint32_t>(offset);
+            rel = static_cast<std::uint8_t>(rel | 1 << i);
+        }
+    }
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Parse the lines [first, last) into a chunk. Faces are split
+/// into fans as they are read, so no line is stored.
+///
+/// @param[in]  first  The start of the first line
+/// @param[in]  last   The end of the last line
+/// @param[out] chunk  The chunk
+///
+static void parse_chunk(const char* first, const char* last, obj_chunk& chunk)
+{
+    auto& data = chunk.m_data;
+    auto p = first;
+    while (p < last) {
+        p = skip_blanks(p, last);
+        auto eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(last - p)));
+        auto line_end = eol ? eol : last;
+        auto next = eol ? eol + 1 : last;
+        if (p == line_end) {
+            p = next;
+            continue;
+        }
+
+        auto tag = p;
+        while (p < line_end && !is_blank(*p)) {
+            ++p;
+        }
+        auto tag_size = p - tag;
+
+        if (tag[0] == 'v' && (tag_size == 1 || (tag_size == 2 && (tag[1] == 't' || tag[1] == 'n')))) {
+            // Texture coordinates need only u (v defaults to zero)
+            scalar values[3] = {0, 0, 0};
+            auto uv = tag_size == 2 && tag[1] == 't';
+            for (auto i = 0; i < (uv ? 1 : 3) && p; ++i) {
+                p = parse_scalar(skip_blanks(p, line_end), line_end, values[i]);
+            }
+            if (p && uv && skip_blanks(p, line_end) < line_end) {
+                p = parse_scalar(skip_blanks(p, line_end), line_end, values[1]);
+            }
+            if (!p) {
+                chunk.m_ok = false;
+                return;
+            }
+            if (tag_size == 1) {
+                data.m_positions.emplace_back(values[0], values[1], values[2]);
+            }
+            else if (uv) {
+                data.m_uvs.push_back({{values[0], values[1]}});
+            }
+            else {
+                data.m_normals.emplace_back(values[0], values[1], values[2]);
+            }
+        }
+        else if (tag[0] == 'f' && tag_size == 1) {
+            obj_corner first_corner, prev, corner;
+            std::uint8_t first_rel = 0, prev_rel = 0, rel;
+            std::size_t count = 0;
+            for (p = skip_blanks(p, line_end); p < line_end; p = skip_blanks(p, line_end)) {
+                p = parse_corner(p, line_end, chunk, corner, rel);
+                if (!p) {
+                    chunk.m_ok = false;
+                    return;
+                }
+                if (count >= 2) {
+                    auto base = data.m_corners.size();
+                    for (std::size_t i = 0; i < 3; ++i) {
+                        auto r = i == 0 ? first_rel : (i == 1 ? prev_rel : rel);
+                        if (r) {
+                            chunk.m_relative.emplace_back(base + i, r);
+                        }
+                    }
+                    data.m_corners.push_back(first_corner);
+                    data.m_corners.push_back(prev);
+                    data.m_corners.push_back(corner);
+                }
+                if (count == 0) {
+                    first_corner = corner;
+                    first_rel = rel;
+                }
+                prev = corner;
+                prev_rel = rel;
+                ++count;
+            }
+            if (count < 3) {
+                chunk.m_ok = false;
+                return;
+            }
+        }
+        p = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the start of the first line that begins in chunk i (the
+/// chunks split the text every chunk_bytes, and a line belongs to the chunk
+/// holding its first character)
+///
+static const char* chunk_start(const char* first, const char* last,
+    std::size_t i, std::size_t chunk_bytes)
+{
+    if (i == 0) {
+        return first;
+    }
+    auto offset = i * chunk_bytes;
+    if (offset >= static_cast<std::size_t>(last - first)) {
+        return last;
+    }
+    return next_line(first + offset - 1, last);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Parse OBJ text. The text is split into chunks at line
+/// boundaries which are parsed in parallel, then the chunks are copied into
+/// the output in parallel (fixing up relative indices and checking that
+/// every index is in range).
+///
+/// @param[in]  first        The start of the text
+/// @param[in]  last         The end of the text
+/// @param[out] out          The geometry (replaced)
+/// @param[in]  chunk_bytes  The size of a chunk
+///
+/// @return     true if the text was parsed
+///
+bool parse_obj(const char* first, const char* last, obj_data& out, std::size_t chunk_bytes)
+{
+    chunk_bytes = std::max(chunk_bytes, std::size_t{1});
+    auto size = static_cast<std::size_t>(last - first);
+    auto count = std::max((size + chunk_bytes - 1) / chunk_bytes, std::size_t{1});
+
+    std::vector<obj_chunk> chunks(count);
+    parallel_for(count, 4, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            parse_chunk(chunk_start(first, last, i, chunk_bytes),
+                chunk_start(first, last, i + 1, chunk_bytes), chunks[i]);
+        }
+    });
+
+    // Where each chunk goes in the output
+    std::vector<std::array<std::size_t, 4>> bases(count + 1);
+    bases[0] = {{0, 0, 0, 0}};
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& data = chunks[i].m_data;
+        if (!chunks[i].m_ok) {
+            return false;
+        }
+        bases[i + 1] = {{
+            bases[i][0] + data.m_positions.size(),
+            bases[i][1] + data.m_uvs.size(),
+            bases[i][2] + data.m_normals.size(),
+            bases[i][3] + data.m_corners.size()
+        }};
+    }
+    auto& totals = bases[count];
+    if (totals[0] >= obj_no_index || totals[1] >= obj_no_index || totals[2] >= obj_no_index) {
+        return false;
+    }
+
+    out.m_positions.resize(totals[0]);
+    out.m_uvs.resize(totals[1]);
+    out.m_normals.resize(totals[2]);
+    out.m_corners.resize(totals[3]);
+
+    std::vector<std::uint8_t> valid(count, 1);
+    parallel_for(count, 4, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            auto& data = chunks[i].m_data;
+            auto& base = bases[i];
+            std::copy(data.m_positions.begin(), data.m_positions.end(), out.m_positions.begin() + base[0]);
+            std::copy(data.m_uvs.begin(), data.m_uvs.end(), out.m_uvs.begin() + base[1]);
+            std::copy(data.m_normals.begin(), data.m_normals.end(), out.m_normals.begin() + base[2]);
+
+            // Relative indices are offset by the attributes of earlier chunks
+            for (auto& rel : chunks[i].m_relative) {
+                auto& corner = data.m_corners[rel.first];
+                std::uint32_t* indices[3] = {&corner.m_pos, &corner.m_uv, &corner.m_normal};
+                for (std::size_t j = 0; j < 3; ++j) {
+                    if (rel.second & (1 << j)) {
+                        auto index = static_cast<std::int64_t>(base[j]) + static_cast<std::int32_t>(*indices[j]);
+                        if (index < 0) {
+                            valid[i] = 0;
+                        }
+                        *indices[j] = static_cast<std::uint32_t>(index);
+                    }
+                }
+            }
+
+            auto corners = out.m_corners.begin() + static_cast<std::ptrdiff_t>(base[3]);
+            for (auto& corner : data.m_corners) {
+                if (corner.m_pos >= totals[0]
+                    || (corner.m_uv != obj_no_index && corner.m_uv >= totals[1])
+                    || (corner.m_normal != obj_no_index && corner.m_normal >= totals[2])) {
+                    valid[i] = 0;
+                }
+                *corners++ = corner;
+            }
+
+            // Release the chunk while the other threads work
+            data = obj_data();
+        }
+    });
+    return std::all_of(valid.begin(), valid.end(), [](std::uint8_t v) { return v != 0; });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Load an OBJ file. The file is memory mapped and parsed in
+/// place (in parallel for large files), so it is never copied.
+///
+/// @param[in]  path  The path of the file
+/// @param[out] out   The geometry (replaced)
+///
+/// @return     true if the file was loaded
+///
+bool load_obj(const std::string& path, obj_data& out)
+{
+    mapped_file file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    return parse_obj(file.data(), file.end(), out);
+}
@@ -0,0 +1,58 @@
+
+#ifndef _OBJ_LOADER_H_
+#define _OBJ_LOADER_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using uv_coord = std::array<scalar, 2>;
+
+// The index of an attribute that a face corner does not have
+constexpr std::uint32_t obj_no_index = 0xffffffffu;
+
+// OBJ text is parsed in chunks of about this many bytes (a chunk is the
+// smallest piece of work given to a thread)
+constexpr std::size_t obj_chunk_bytes = 1 << 18;
+
+//------------------------------------------------------------------------------
+/// @brief      One corner of a face: the (zero-based) indices of its
+/// position, texture coordinate and normal
+///
+struct obj_corner
+{
+    std::uint32_t m_pos;
+    std::uint32_t m_uv;
+    std::uint32_t m_normal;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The geometry of an OBJ file, as it is in the file: the `v`, `vt`
+/// and `vn` lines in order, and three corners per triangle (quads and other
+/// polygons are split into triangle fans).
+///
+struct obj_data
+{
+    std::vector<vector3> m_positions;
+    std::vector<uv_coord> m_uvs;
+    std::vector<vector3> m_normals;
+    std::vector<obj_corner> m_corners;
+
+    std::size_t triangle_count() const { return m_corners.size() / 3; }
+};
+
+// Parse the OBJ text [first, last) into out, splitting large texts across
+// threads (returns false for malformed lines and out of range indices)
+bool parse_obj(const char* first, const char* last, obj_data& out,
+    std::size_t chunk_bytes=obj_chunk_bytes);
+
+// Memory map an OBJ file and parse it into out (returns false if the file
+// cannot be read or is malformed)
+bool load_obj(const std::string& path, obj_data& out);
+
+#endif
@@ -0,0 +1,256 @@
+
+#include "procedural.h"
+#include "../linalg/simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(LINALG_SIMD)
+using namespace simd;
+#endif
+
+
+//------------------------------------------------------------------------------
+/// @brief      Writes the vertices and indices of a generator into mesh
+/// buffers (the runtime counterpart of static_mesh)
+///
+struct buffers_writer
+{
+    mesh_buffers& m_mesh;
+
+    float* vertex(std::size_t v) {
+        return reinterpret_cast<float*>(m_mesh.m_vertices.data()) + v * generated_vertex_floats;
+    }
+
+    void set_vertex(std::size_t v, double px, double py, double pz,
+        double nx, double ny, double nz, double u, double w) {
+        float values[generated_vertex_floats] = {
+            static_cast<float>(px), static_cast<float>(py), static_cast<float>(pz),
+            static_cast<float>(nx), static_cast<float>(ny), static_cast<float>(nz),
+            static_cast<float>(u), static_cast<float>(w)
+        };
+        std::memcpy(vertex(v), values, sizeof(values));
+    }
+
+    void set_index(std::size_t i, std::size_t value) {
+        m_mesh.m_indices[i] = static_cast<std::uint32_t>(value);
+    }
+};
+
+// Allocate mesh buffers with the layout of the generators
+static mesh_buffers make_buffers(std::size_t vertex_count, std::size_t index_count)
+{
+    mesh_buffers mesh;
+    mesh.m_attributes.assign(generated_attributes.begin(), generated_attributes.end());
+    mesh.m_stride = generated_vertex_floats * sizeof(float);
+    mesh.m_vertices.resize(vertex_count * mesh.m_stride);
+    mesh.m_indices.resize(index_count);
+    return mesh;
+}
+
+// Set the bounds of generated mesh buffers
+static mesh_buffers& set_bounds(mesh_buffers& mesh)
+{
+    std::array<float, 3> lo {{0, 0, 0}}, hi {{0, 0, 0}};
+    buffers_writer writer {mesh};
+    for (std::size_t v = 0; v < mesh.vertex_count(); ++v) {
+        auto p = writer.vertex(v);
+        for (std::size_t k = 0; k < 3; ++k) {
+            lo[k] = v ? std::min(lo[k], p[k]) : p[k];
+            hi[k] = v ? std::max(hi[k], p[k]) : p[k];
+        }
+    }
+    mesh.m_min = vector3(lo[0], lo[1], lo[2]);
+    mesh.m_max = vector3(hi[0], hi[1], hi[2]);
+    return mesh;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      The cosines, sines and u coordinates of the slices + 1
+/// vertices of a ring, computed once for all the rings of a mesh
+///
+struct ring_table
+{
+    std::vector<float> m_cos;
+    std::vector<float> m_sin;
+    std::vector<float> m_u;
+
+    explicit ring_table(std::size_t slices)
+        : m_cos(slices + 1), m_sin(slices + 1), m_u(slices + 1) {
+        for (std::size_t c = 0; c <= slices; ++c) {
+            auto s = static_cast<double>(c) / static_cast<double>(slices);
+            m_cos[c] = static_cast<float>(std::cos(2 * cx::pi * s));
+            m_sin[c] = static_cast<float>(std::sin(2 * cx::pi * s));
+            m_u[c] = static_cast<float>(s);
+        }
+    }
+
+    std::size_t size() const { return m_u.size(); }
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Write a ring of vertices around the y axis: the positions
+/// (radius cos, y, radius sin), the normals (normal_radius cos, normal_y,
+/// normal_radius sin) and the uvs (u, v). Four vertices are computed at once
+/// and transposed into the interleaved layout.
+///
+/// @param      out            The first vertex of the ring
+/// @param[in]  table          The cosines, sines and us of the ring
+/// @param[in]  radius         The radius of the positions
+/// @param[in]  y              The height of the positions
+/// @param[in]  normal_radius  The radius of the normals
+/// @param[in]  normal_y       The height of the normals
+/// @param[in]  v              The v coordinate
+///
+static void write_ring(float* out, const ring_table& table, float radius, float y,
+    float normal_radius, float normal_y, float v)
+{
+    auto count = table.size();
+    std::size_t c = 0;
+#if defined(LINALG_SIMD)
+    auto r = splat(radius), nr = splat(normal_radius);
+    for (; c + 4 <= count; c += 4) {
+        auto cosines = load(&table.m_cos[c]), sines = load(&table.m_sin[c]);
+
+        // Rows of (x, y, z, nx) and (ny, nz, u, v), transposed into vertices
+        auto a0 = mul(r, cosines), a1 = splat(y), a2 = mul(r, sines), a3 = mul(nr, cosines);
+        auto b0 = splat(normal_y), b1 = mul(nr, sines), b2 = load(&table.m_u[c]), b3 = splat(v);
+        transpose(a0, a1, a2, a3);
+        transpose(b0, b1, b2, b3);
+
+        auto p = out + c * generated_vertex_floats;
+        store(p, a0);
+        store(p + 4, b0);
+        store(p + 8, a1);
+        store(p + 12, b1);
+        store(p + 16, a2);
+        store(p + 20, b2);
+        store(p + 24, a3);
+        store(p + 28, b3);
+    }
+#endif
+    for (; c < count; ++c) {
+        auto p = out + c * generated_vertex_floats;
+        p[0] = radius * table.m_cos[c];
+        p[1] = y;
+        p[2] = radius * table.m_sin[c];
+        p[3] = normal_radius * table.m_cos[c];
+        p[4] = normal_y;
+        p[5] = normal_radius * table.m_sin[c];
+        p[6] = table.m_u[c];
+        p[7] = v;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a cuboid (see make_cuboid)
+///
+/// @param[in]  n     The quads along each edge (at least 1)
+///
+/// @return     the mesh buffers
+///
+mesh_buffers generate_cuboid(std::size_t n)
+{
+    n = std::max<std::size_t>(n, 1);
+    auto mesh = make_buffers(6 * (n + 1) * (n + 1), 36 * n * n);
+    buffers_writer writer {mesh};
+    generate_cuboid<std_math>(writer, n);
+    return set_bounds(mesh);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a plane (see make_plane)
+///
+/// @param[in]  nx    The quads along x (at least 1)
+/// @param[in]  nz    The quads along z (at least 1)
+///
+/// @return     the mesh buffers
+///
+mesh_buffers generate_plane(std::size_t nx, std::size_t nz)
+{
+    nx = std::max<std::size_t>(nx, 1);
+    nz = std::max<std::size_t>(nz, 1);
+    auto mesh = make_buffers((nx + 1) * (nz + 1), 6 * nx * nz);
+    buffers_writer writer {mesh};
+    generate_plane<std_math>(writer, nx, nz);
+    return set_bounds(mesh);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a uv sphere (see make_uv_sphere). The rings are
+/// written by write_ring from one table of the slices.
+///
+/// @param[in]  slices  The slices around y (at least 3)
+/// @param[in]  stacks  The stacks from pole to pole (at least 2)
+///
+/// @return     the mesh buffers
+///
+mesh_buffers generate_uv_sphere(std::size_t slices, std::size_t stacks)
+{
+    slices = std::max<std::size_t>(slices, 3);
+    stacks = std::max<std::size_t>(stacks, 2);
+    auto mesh = make_buffers((slices + 1) * (stacks + 1), 6 * slices * (stacks - 1));
+    buffers_writer writer {mesh};
+    generate_uv_sphere_indices(writer, slices, stacks);
+
+    ring_table table(slices);
+    for (std::size_t r = 0; r <= stacks; ++r) {
+        auto t = static_cast<double>(r) / static_cast<double>(stacks);
+        auto sin_theta = static_cast<float>(std::sin(cx::pi * t));
+        auto cos_theta = static_cast<float>(std::cos(cx::pi * t));
+        write_ring(writer.vertex(r * (slices + 1)), table, sin_theta, cos_theta,
+            sin_theta, cos_theta, static_cast<float>(t));
+    }
+    return set_bounds(mesh);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate an ico sphere (see make_ico_sphere)
+///
+/// @param[in]  frequency  The splits of each edge of the icosahedron (at
+///                        least 1)
+///
+/// @return     the mesh buffers
+///
+mesh_buffers generate_ico_sphere(std::size_t frequency)
+{
+    frequency = std::max<std::size_t>(frequency, 1);
+    auto mesh = make_buffers(10 * (frequency + 1) * (frequency + 2), 60 * frequency * frequency);
+    buffers_writer writer {mesh};
+    generate_ico_sphere<std_math>(writer, frequency);
+    return set_bounds(mesh);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a cylinder (see make_cylinder). The rings of the side
+/// are written by write_ring from one table of the slices.
+///
+/// @param[in]  slices  The slices around y (at least 3)
+/// @param[in]  stacks  The stacks of the side (at least 1)
+///
+/// @return     the mesh buffers
+///
+mesh_buffers generate_cylinder(std::size_t slices, std::size_t stacks)
+{
+    slices = std::max<std::size_t>(slices, 3);
+    stacks = std::max<std::size_t>(stacks, 1);
+    auto mesh = make_buffers((slices + 1) * (stacks + 1) + 2 * (slices + 1), 6 * slices * (stacks + 1));
+    buffers_writer writer {mesh};
+    generate_cylinder_indices(writer, slices, stacks);
+
+    ring_table table(slices);
+    for (std::size_t r = 0; r <= stacks; ++r) {
+        auto t = static_cast<float>(r) / static_cast<float>(stacks);
+        write_ring(writer.vertex(r * (slices + 1)), table, 1, 1 - 2 * t, 1, 0, t);
+    }
+    auto vertex = (slices + 1) * (stacks + 1);
+    for (float y : {1.0f, -1.0f}) {
+        writer.set_vertex(vertex++, 0, y, 0, 0, y, 0, 0.5, 0.5);
+        for (std::size_t c = 0; c < slices; ++c) {
+            writer.set_vertex(vertex++, table.m_cos[c], y, table.m_sin[c], 0, y, 0,
+                0.5f + table.m_cos[c] / 2, 0.5f + table.m_sin[c] / 2);
+        }
+    }
+    return set_bounds(mesh);
+}
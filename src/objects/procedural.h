@@ -0,0 +1,389 @@
+
+#ifndef _PROCEDURAL_H_
+#define _PROCEDURAL_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/cx.h"
+#include "mesh_file.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+// Procedural meshes for debug and proxy geometry. Each shape is generated by
+// one function template, so it can be built in two ways:
+//
+//  - make_cuboid<1>(), make_uv_sphere<32, 16>(), ... return a static_mesh
+//    for a fixed tessellation. These are constexpr, so a constexpr variable
+//    holding one is data in the binary and costs nothing at startup:
+//
+//        constexpr auto sphere = make_uv_sphere<32, 16>();
+//        renderer.add_mesh(sphere);
+//
+//  - generate_cuboid(1), generate_uv_sphere(32, 16), ... (procedural.cpp)
+//    build mesh_buffers at runtime for tessellations chosen at runtime (the
+//    rings of spheres and cylinders four vertices at a time with SIMD).
+//
+// The vertices are interleaved floats in the layout of build_mesh
+// (position, normal and uv), the triangles are counter-clockwise seen from
+// outside, and every shape fits in [-1, 1]^3.
+//
+
+// The floats of a generated vertex
+constexpr std::size_t generated_vertex_floats = 8;
+
+// The attributes of a generated vertex
+constexpr std::array<mesh_attribute, 3> generated_attributes {{
+    {mesh_position, 3, 0, 0, gl_float},
+    {mesh_normal, 3, 0, 12, gl_float},
+    {mesh_uv, 2, 0, 24, gl_float}
+}};
+
+//------------------------------------------------------------------------------
+/// @brief      The vertices and 16 bit indices of a generated mesh with a
+/// fixed tessellation (plain arrays, since the std::array members cannot be
+/// written in a C++14 constant expression)
+///
+template <std::size_t V, std::size_t I>
+struct static_mesh
+{
+    static_assert(V <= 0x10000, "The vertices must be addressable with 16 bit indices");
+
+    float m_vertices[V * generated_vertex_floats];
+    std::uint16_t m_indices[I];
+
+    static constexpr std::size_t vertex_count() { return V; }
+    static constexpr std::size_t index_count() { return I; }
+
+    constexpr void set_vertex(std::size_t v, double px, double py, double pz,
+        double nx, double ny, double nz, double u, double w) {
+        auto out = m_vertices + v * generated_vertex_floats;
+        out[0] = static_cast<float>(px);
+        out[1] = static_cast<float>(py);
+        out[2] = static_cast<float>(pz);
+        out[3] = static_cast<float>(nx);
+        out[4] = static_cast<float>(ny);
+        out[5] = static_cast<float>(nz);
+        out[6] = static_cast<float>(u);
+        out[7] = static_cast<float>(w);
+    }
+
+    constexpr void set_index(std::size_t i, std::size_t value) {
+        m_indices[i] = static_cast<std::uint16_t>(value);
+    }
+};
+
+// The math of the generators at compile time (cx) and at runtime (libm)
+struct cx_math
+{
+    static constexpr double sin(double x) { return cx::sin(x); }
+    static constexpr double cos(double x) { return cx::cos(x); }
+    static constexpr double sqrt(double x) { return cx::sqrt(x); }
+};
+
+struct std_math
+{
+    static double sin(double x) { return std::sin(x); }
+    static double cos(double x) { return std::cos(x); }
+    static double sqrt(double x) { return std::sqrt(x); }
+};
+
+
+//------------------------------------------------------------------------------
+/// @brief      Set the indices of a grid of quads (two triangles each), whose
+/// vertices are in rows of columns + 1
+///
+/// @param      m        The mesh
+/// @param[in]  index    The first index to set
+/// @param[in]  vertex   The first vertex of the grid
+/// @param[in]  columns  The quads in a row
+/// @param[in]  rows     The rows of quads
+///
+/// @return     the index after the last one set
+///
+template <typename Mesh>
+constexpr std::size_t generate_grid_indices(Mesh& m, std::size_t index, std::size_t vertex,
+    std::size_t columns, std::size_t rows)
+{
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < columns; ++c) {
+            auto a = vertex + r * (columns + 1) + c;
+            auto b = a + 1, d = a + columns + 1, e = d + 1;
+            m.set_index(index++, a);
+            m.set_index(index++, b);
+            m.set_index(index++, e);
+            m.set_index(index++, a);
+            m.set_index(index++, e);
+            m.set_index(index++, d);
+        }
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a cuboid from -1 to 1 with each face a grid of n by n
+/// quads (6 (n + 1)^2 vertices and 36 n^2 indices)
+///
+template <typename Math, typename Mesh>
+constexpr void generate_cuboid(Mesh& m, std::size_t n)
+{
+    // The normal and the axes of the uvs of each face (u x v = normal)
+    constexpr double faces[6][9] = {
+        { 1, 0, 0,   0, 0, -1,   0, 1, 0},
+        {-1, 0, 0,   0, 0, 1,    0, 1, 0},
+        { 0, 1, 0,   1, 0, 0,    0, 0, -1},
+        { 0, -1, 0,  1, 0, 0,    0, 0, 1},
+        { 0, 0, 1,   1, 0, 0,    0, 1, 0},
+        { 0, 0, -1,  -1, 0, 0,   0, 1, 0}
+    };
+
+    std::size_t vertex = 0, index = 0;
+    for (std::size_t f = 0; f < 6; ++f) {
+        auto& a = faces[f];
+        index = generate_grid_indices(m, index, vertex, n, n);
+        for (std::size_t j = 0; j <= n; ++j) {
+            for (std::size_t i = 0; i <= n; ++i) {
+                auto s = static_cast<double>(i) / static_cast<double>(n);
+                auto t = static_cast<double>(j) / static_cast<double>(n);
+                auto u = 2 * s - 1, v = 2 * t - 1;
+                m.set_vertex(vertex++,
+                    a[0] + a[3] * u + a[6] * v, a[1] + a[4] * u + a[7] * v, a[2] + a[5] * u + a[8] * v,
+                    a[0], a[1], a[2], s, t);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a plane from -1 to 1 in x and z facing +y, a grid of
+/// nx by nz quads ((nx + 1) (nz + 1) vertices and 6 nx nz indices)
+///
+template <typename Math, typename Mesh>
+constexpr void generate_plane(Mesh& m, std::size_t nx, std::size_t nz)
+{
+    generate_grid_indices(m, 0, 0, nx, nz);
+    std::size_t vertex = 0;
+    for (std::size_t j = 0; j <= nz; ++j) {
+        for (std::size_t i = 0; i <= nx; ++i) {
+            auto s = static_cast<double>(i) / static_cast<double>(nx);
+            auto t = static_cast<double>(j) / static_cast<double>(nz);
+            m.set_vertex(vertex++, 2 * s - 1, 0, 1 - 2 * t, 0, 1, 0, s, t);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set the indices of a uv sphere: the quads between its rings,
+/// without the degenerate triangles at the poles (6 slices (stacks - 1)
+/// indices)
+///
+template <typename Mesh>
+constexpr void generate_uv_sphere_indices(Mesh& m, std::size_t slices, std::size_t stacks)
+{
+    std::size_t index = 0;
+    for (std::size_t r = 0; r < stacks; ++r) {
+        for (std::size_t c = 0; c < slices; ++c) {
+            auto a = r * (slices + 1) + c;
+            auto b = a + 1, d = a + slices + 1, e = d + 1;
+            if (r != 0) {
+                m.set_index(index++, a);
+                m.set_index(index++, b);
+                m.set_index(index++, d);
+            }
+            if (r + 1 != stacks) {
+                m.set_index(index++, b);
+                m.set_index(index++, e);
+                m.set_index(index++, d);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a unit uv sphere: stacks + 1 rings of slices + 1
+/// vertices (the first and last vertex of a ring meet at the uv seam), from
+/// the top pole down
+///
+template <typename Math, typename Mesh>
+constexpr void generate_uv_sphere(Mesh& m, std::size_t slices, std::size_t stacks)
+{
+    generate_uv_sphere_indices(m, slices, stacks);
+    std::size_t vertex = 0;
+    for (std::size_t r = 0; r <= stacks; ++r) {
+        auto t = static_cast<double>(r) / static_cast<double>(stacks);
+        auto sin_theta = Math::sin(cx::pi * t), cos_theta = Math::cos(cx::pi * t);
+        for (std::size_t c = 0; c <= slices; ++c) {
+            auto s = static_cast<double>(c) / static_cast<double>(slices);
+            auto x = sin_theta * Math::cos(2 * cx::pi * s), z = sin_theta * Math::sin(2 * cx::pi * s);
+            m.set_vertex(vertex++, x, cos_theta, z, x, cos_theta, z, s, t);
+        }
+    }
+}
+
+// Return vertex j of row i of a face of an ico sphere (row i holds the
+// f + 1 - i vertices i steps towards its second corner)
+constexpr std::size_t ico_vertex(std::size_t base, std::size_t f, std::size_t i, std::size_t j) {
+    return base + i * (f + 1) - i * (i - 1) / 2 + j;
+}
+
+// The corners and faces of an icosahedron (counter-clockwise from outside)
+constexpr double ico_t = 1.6180339887498949;
+constexpr double ico_corners[12][3] = {
+    {-1, ico_t, 0}, {1, ico_t, 0}, {-1, -ico_t, 0}, {1, -ico_t, 0},
+    {0, -1, ico_t}, {0, 1, ico_t}, {0, -1, -ico_t}, {0, 1, -ico_t},
+    {ico_t, 0, -1}, {ico_t, 0, 1}, {-ico_t, 0, -1}, {-ico_t, 0, 1}
+};
+constexpr std::size_t ico_faces[20][3] = {
+    {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+    {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+    {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+    {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a unit ico sphere: each face of an icosahedron is
+/// split into frequency^2 triangles whose corners are pushed onto the
+/// sphere (10 (f + 1) (f + 2) vertices and 60 f^2 indices). The faces do
+/// not share vertices (the uvs are barycentric, per face), but the vertices
+/// on shared edges are computed from the same two corners, so they are
+/// identical and there are no cracks.
+///
+template <typename Math, typename Mesh>
+constexpr void generate_ico_sphere(Mesh& m, std::size_t frequency)
+{
+    auto f = frequency;
+    auto per_face = (f + 1) * (f + 2) / 2;
+    std::size_t index = 0;
+    for (std::size_t face = 0; face < 20; ++face) {
+        auto& a = ico_corners[ico_faces[face][0]];
+        auto& b = ico_corners[ico_faces[face][1]];
+        auto& c = ico_corners[ico_faces[face][2]];
+        auto base = face * per_face;
+        for (std::size_t i = 0; i <= f; ++i) {
+            for (std::size_t j = 0; i + j <= f; ++j) {
+                auto wa = static_cast<double>(f - i - j), wb = static_cast<double>(i),
+                     wc = static_cast<double>(j);
+                double p[3] = {};
+                for (std::size_t k = 0; k < 3; ++k) {
+                    p[k] = a[k] * wa + b[k] * wb + c[k] * wc;
+                }
+                auto inv_len = 1 / Math::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+                auto x = p[0] * inv_len, y = p[1] * inv_len, z = p[2] * inv_len;
+                m.set_vertex(ico_vertex(base, f, i, j), x, y, z, x, y, z,
+                    wb / static_cast<double>(f), wc / static_cast<double>(f));
+
+                if (i + j < f) {
+                    m.set_index(index++, ico_vertex(base, f, i, j));
+                    m.set_index(index++, ico_vertex(base, f, i + 1, j));
+                    m.set_index(index++, ico_vertex(base, f, i, j + 1));
+                }
+                if (i + j + 1 < f) {
+                    m.set_index(index++, ico_vertex(base, f, i + 1, j));
+                    m.set_index(index++, ico_vertex(base, f, i + 1, j + 1));
+                    m.set_index(index++, ico_vertex(base, f, i, j + 1));
+                }
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set the indices of a cylinder: the grid of its side, then the
+/// fans of its caps (6 slices (stacks + 1) indices)
+///
+template <typename Mesh>
+constexpr void generate_cylinder_indices(Mesh& m, std::size_t slices, std::size_t stacks)
+{
+    auto index = generate_grid_indices(m, 0, 0, slices, stacks);
+    auto top = (slices + 1) * (stacks + 1);
+    auto bottom = top + slices + 1;
+    for (std::size_t c = 0; c < slices; ++c) {
+        auto next = (c + 1) % slices;
+        m.set_index(index++, top);
+        m.set_index(index++, top + 1 + next);
+        m.set_index(index++, top + 1 + c);
+        m.set_index(index++, bottom);
+        m.set_index(index++, bottom + 1 + c);
+        m.set_index(index++, bottom + 1 + next);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Generate a cylinder of radius 1 from y = 1 to -1: stacks + 1
+/// rings of slices + 1 vertices for the side (from the top down), then the
+/// center and slices rim vertices of the top and of the bottom cap
+///
+template <typename Math, typename Mesh>
+constexpr void generate_cylinder(Mesh& m, std::size_t slices, std::size_t stacks)
+{
+    generate_cylinder_indices(m, slices, stacks);
+    std::size_t vertex = 0;
+    for (std::size_t r = 0; r <= stacks; ++r) {
+        auto t = static_cast<double>(r) / static_cast<double>(stacks);
+        for (std::size_t c = 0; c <= slices; ++c) {
+            auto s = static_cast<double>(c) / static_cast<double>(slices);
+            auto x = Math::cos(2 * cx::pi * s), z = Math::sin(2 * cx::pi * s);
+            m.set_vertex(vertex++, x, 1 - 2 * t, z, x, 0, z, s, t);
+        }
+    }
+    for (std::size_t cap = 0; cap < 2; ++cap) {
+        double y = cap == 0 ? 1 : -1;
+        m.set_vertex(vertex++, 0, y, 0, 0, y, 0, 0.5, 0.5);
+        for (std::size_t c = 0; c < slices; ++c) {
+            auto s = static_cast<double>(c) / static_cast<double>(slices);
+            auto x = Math::cos(2 * cx::pi * s), z = Math::sin(2 * cx::pi * s);
+            m.set_vertex(vertex++, x, y, z, 0, y, 0, 0.5 + x / 2, 0.5 + z / 2);
+        }
+    }
+}
+
+
+// The meshes for fixed tessellations (see the top of this file)
+template <std::size_t N=1>
+constexpr auto make_cuboid() {
+    static_mesh<6 * (N + 1) * (N + 1), 36 * N * N> m {};
+    generate_cuboid<cx_math>(m, N);
+    return m;
+}
+
+template <std::size_t NX, std::size_t NZ=NX>
+constexpr auto make_plane() {
+    static_mesh<(NX + 1) * (NZ + 1), 6 * NX * NZ> m {};
+    generate_plane<cx_math>(m, NX, NZ);
+    return m;
+}
+
+template <std::size_t Slices, std::size_t Stacks>
+constexpr auto make_uv_sphere() {
+    static_assert(Slices >= 3 && Stacks >= 2, "A uv sphere needs 3 slices and 2 stacks");
+    static_mesh<(Slices + 1) * (Stacks + 1), 6 * Slices * (Stacks - 1)> m {};
+    generate_uv_sphere<cx_math>(m, Slices, Stacks);
+    return m;
+}
+
+template <std::size_t Frequency>
+constexpr auto make_ico_sphere() {
+    static_assert(Frequency >= 1, "An ico sphere needs a frequency of at least 1");
+    static_mesh<10 * (Frequency + 1) * (Frequency + 2), 60 * Frequency * Frequency> m {};
+    generate_ico_sphere<cx_math>(m, Frequency);
+    return m;
+}
+
+template <std::size_t Slices, std::size_t Stacks=1>
+constexpr auto make_cylinder() {
+    static_assert(Slices >= 3 && Stacks >= 1, "A cylinder needs 3 slices and 1 stack");
+    static_mesh<(Slices + 1) * (Stacks + 1) + 2 * (Slices + 1), 6 * Slices * (Stacks + 1)> m {};
+    generate_cylinder<cx_math>(m, Slices, Stacks);
+    return m;
+}
+
+// The meshes for tessellations chosen at runtime
+mesh_buffers generate_cuboid(std::size_t n);
+mesh_buffers generate_plane(std::size_t nx, std::size_t nz);
+mesh_buffers generate_uv_sphere(std::size_t slices, std::size_t stacks);
+mesh_buffers generate_ico_sphere(std::size_t frequency);
+mesh_buffers generate_cylinder(std::size_t slices, std::size_t stacks);
+
+#endif
@@ -1,8 +1,12 @@
 
 #include "renderer.h"
+#include "../objects/mesh_quantize.h"
+#include "../objects/mesh_simplify.h"
 
 #include <iostream>
 #include <array>
+#include <cstdint>
+#include <cstring>
 
 
 
@@ -105,10 +109,11 @@ renderer::renderer(GLint xsize, GLint ysize)
     // Create shader program
     {
         std::string vertexShaderStr {
+            "uniform mat4 uDequantize;                              \n"
             "attribute vec4 vPosition;                              \n"
             "void main()                                            \n"
             "{                                                      \n"
-            "   gl_Position = vPosition;                            \n"
+            "   gl_Position = uDequantize * vPosition;              \n"
             "}                                                      \n"
         };
 
@@ -155,41 +160,137 @@ renderer::renderer(GLint xsize, GLint ysize)
             glDeleteProgram(m_programs.back());
             // return GL_FALSE;
         }
+
+        m_dequantize_location = glGetUniformLocation(m_programs.back(), "uDequantize");
     }
-}
 
-// ----------------------------------------------------------------
-void renderer::render_frame()
-{
-    // Create an array of vertices
-    const GLint NUM_VERTS = 9;
-    std::array<GLfloat, NUM_VERTS> vVertices {{
+    // A triangle to draw until the scene has meshes
+    mesh_buffers triangle;
+    triangle.m_attributes.push_back({mesh_position, 3, 0, 0, gl_float});
+    triangle.m_stride = 3 * sizeof(GLfloat);
+    std::array<GLfloat, 9> vVertices {{
         0.0f,  0.5f, 0.0f,
        -0.5f, -0.5f, 0.0f,
         0.5f, -0.5f, 0.0f
     }};
+    triangle.m_vertices.resize(sizeof(vVertices));
+    std::memcpy(triangle.m_vertices.data(), vVertices.data(), sizeof(vVertices));
+    triangle.m_indices = {0, 1, 2};
+    add_mesh(triangle);
+}
+
+// ----------------------------------------------------------------
+// Create the buffers of a mesh (no clientside arrays, so this is
+// webgl-friendly) and return its index. Positions and uvs stored as
+// unsigned shorts are relative to the bounds (see mesh_quantize.h). The
+// finest level of detail is selected to start with.
+std::size_t renderer::upload_mesh(const void* vertices, std::size_t vertex_bytes, GLsizei stride,
+    const mesh_attribute* attributes, std::size_t attribute_count,
+    const void* indices, std::size_t index_count, GLenum index_type,
+    const vector3& min, const vector3& max, const mesh_lod* lods, std::size_t lod_count)
+{
+    render_mesh mesh;
+    mesh.m_index_count = static_cast<GLsizei>(index_count);
+    mesh.m_index_type = index_type;
+    mesh.m_stride = stride;
+    mesh.m_attributes.assign(attributes, attributes + attribute_count);
+    mesh.m_dequantize.id();
+    for (auto& a : mesh.m_attributes) {
+        if (a.m_semantic == mesh_position && a.m_type == gl_unsigned_short) {
+            mesh.m_dequantize = dequantize_positions(min, max);
+        }
+    }
+    mesh.m_lods.assign(lods, lods + lod_count);
+    if (mesh.m_lods.empty()) {
+        mesh.m_lods.push_back({0, static_cast<std::uint32_t>(index_count), 0});
+    }
+    mesh.m_lod = 0;
+    auto index_bytes = index_count * (index_type == GL_UNSIGNED_SHORT ? 2 : 4);
+
+    glGenBuffers(1, &mesh.m_vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertex_bytes), vertices, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &mesh.m_index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.m_index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(index_bytes), indices, GL_STATIC_DRAW);
+
+    m_meshes.push_back(mesh);
+    return m_meshes.size() - 1;
+}
+
+// ----------------------------------------------------------------
+std::size_t renderer::add_mesh(const mesh_file& file)
+{
+    auto& header = file.header();
+    return upload_mesh(file.vertex_data(), header.m_vertex_bytes,
+        static_cast<GLsizei>(header.m_vertex_stride),
+        header.m_attributes.data(), header.m_attribute_count,
+        file.index_data(), header.m_index_count, header.m_index_type,
+        vector3(header.m_min), vector3(header.m_max),
+        header.m_lods.data(), header.m_lod_count);
+}
 
-    // No clientside arrays, so do this in a webgl-friendly manner
-    GLuint vertexPosObject;
-    glGenBuffers(1, &vertexPosObject);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexPosObject);
-    glBufferData(GL_ARRAY_BUFFER, NUM_VERTS * sizeof(GLfloat), &vVertices[0], GL_STATIC_DRAW);
+// ----------------------------------------------------------------
+// 32 bit indices need an extension in WebGL 1, so use 16 bits when they fit
+std::size_t renderer::add_mesh(const mesh_buffers& mesh)
+{
+    if (mesh.vertex_count() <= 0x10000) {
+        std::vector<GLushort> indices(mesh.m_indices.begin(), mesh.m_indices.end());
+        return upload_mesh(mesh.m_vertices.data(), mesh.m_vertices.size(),
+            static_cast<GLsizei>(mesh.m_stride), mesh.m_attributes.data(), mesh.m_attributes.size(),
+            indices.data(), indices.size(), GL_UNSIGNED_SHORT,
+            mesh.m_min, mesh.m_max,
+            mesh.m_lods.data(), mesh.m_lods.size());
+    }
+    return upload_mesh(mesh.m_vertices.data(), mesh.m_vertices.size(),
+        static_cast<GLsizei>(mesh.m_stride), mesh.m_attributes.data(), mesh.m_attributes.size(),
+        mesh.m_indices.data(), mesh.m_indices.size(), GL_UNSIGNED_INT,
+        mesh.m_min, mesh.m_max,
+        mesh.m_lods.data(), mesh.m_lods.size());
+}
+
+// ----------------------------------------------------------------
+// Use the coarsest level whose error stays under a pixel on the screen
+void renderer::select_lod(std::size_t mesh, scalar distance, scalar fovy)
+{
+    auto& m = m_meshes[mesh];
+    m.m_lod = ::select_lod(m.m_lods.data(), m.m_lods.size(), distance,
+        lod_pixel_scale(fovy, static_cast<scalar>(m_ysize)));
+}
 
+// ----------------------------------------------------------------
+void renderer::render_frame()
+{
     // Clear the color buffer
     glClear(GL_COLOR_BUFFER_BIT);
 
     // Use the program object
     glUseProgram(m_programs[0]);
 
-    // Load the vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, vertexPosObject);
-    glVertexAttribPointer(0, 3, GL_FLOAT, 0, 0, 0);
-    glEnableVertexAttribArray(0);
+    for (auto& mesh : m_meshes) {
+        // Load the vertex data
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.m_vertex_buffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.m_index_buffer);
+        glUniformMatrix4fv(m_dequantize_location, 1, GL_FALSE, mesh.m_dequantize.m_mat.data());
+        for (auto& a : mesh.m_attributes) {
+            glVertexAttribPointer(a.m_semantic, a.m_components, a.m_type, a.m_normalized,
+                mesh.m_stride, reinterpret_cast<const void*>(std::uintptr_t{a.m_offset}));
+            glEnableVertexAttribArray(a.m_semantic);
+        }
 
-    // Draw the vertices to the buffer
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+        // Draw the indexed triangles to the buffer
+        auto& lod = mesh.m_lods[mesh.m_lod];
+        auto index_size = mesh.m_index_type == GL_UNSIGNED_SHORT ? 2u : 4u;
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lod.m_index_count), mesh.m_index_type,
+            reinterpret_cast<const void*>(std::uintptr_t{lod.m_index_offset} * index_size));
+
+        for (auto& a : mesh.m_attributes) {
+            glDisableVertexAttribArray(a.m_semantic);
+        }
+    }
 
     // Swap the buffered frame to the front
     glfwSwapBuffers(m_window);
     glfwPollEvents();
-}
\ No newline at end of file
+}
@@ -6,6 +6,11 @@
 #include <GLFW/glfw3.h>
 #include <emscripten/emscripten.h>
 
+#include "../objects/mesh_file.h"
+#include "../objects/procedural.h"
+#include "../linalg/matrix4.h"
+
+#include <array>
 #include <string>
 #include <vector>
 
@@ -20,6 +25,26 @@ void error_callback(int error, const char* description);
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 
 
+//------------------------------------------------------------------------------
+/// @brief      A mesh uploaded to GL buffers. Its attributes are bound to the
+/// locations given by their semantic, and it is drawn with glDrawElements.
+/// Quantized positions are mapped back with m_dequantize (the identity for
+/// float positions). Only the index range of the selected level of detail
+/// is drawn.
+///
+struct render_mesh
+{
+    GLuint m_vertex_buffer;
+    GLuint m_index_buffer;
+    GLsizei m_index_count;
+    GLenum m_index_type;
+    GLsizei m_stride;
+    std::vector<mesh_attribute> m_attributes;
+    matrix4 m_dequantize;
+    std::vector<mesh_lod> m_lods;
+    std::size_t m_lod;
+};
+
 //------------------------------------------------------------------------------
 /// @brief      The renderer class is responsible for setting up OpenGL and the
 /// windowing system. Then it takes meshes and renders them to the buffer.
@@ -33,10 +58,36 @@ class renderer
     GLint m_ysize;
 
     std::vector<GLprogram> m_programs;
+    GLint m_dequantize_location;
+    std::vector<render_mesh> m_meshes;
+
+    std::size_t upload_mesh(const void* vertices, std::size_t vertex_bytes, GLsizei stride,
+        const mesh_attribute* attributes, std::size_t attribute_count,
+        const void* indices, std::size_t index_count, GLenum index_type,
+        const vector3& min, const vector3& max, const mesh_lod* lods, std::size_t lod_count);
 
 public:
     renderer(GLint xsize=640/2, GLint ysize=480/2);
 
+    // Upload a mesh and return its index (the mapped blobs of a mesh file go
+    // to glBufferData as they are; quantize meshes built at runtime first)
+    std::size_t add_mesh(const mesh_file& file);
+    std::size_t add_mesh(const mesh_buffers& mesh);
+
+    // Upload a generated mesh straight from its (constexpr) arrays
+    template <std::size_t V, std::size_t I>
+    std::size_t add_mesh(const static_mesh<V, I>& mesh) {
+        return upload_mesh(mesh.m_vertices, sizeof(mesh.m_vertices),
+            static_cast<GLsizei>(generated_vertex_floats * sizeof(float)),
+            generated_attributes.data(), generated_attributes.size(),
+            mesh.m_indices, I, GL_UNSIGNED_SHORT,
+            vector3(), vector3(), nullptr, 0);
+    }
+
+    // Select the level of detail of a mesh from its distance to a camera
+    // with the given field of view (as passed to matrix4::perspective)
+    void select_lod(std::size_t mesh, scalar distance, scalar fovy);
+
     void render_frame();
 
 };
@@ -0,0 +1,317 @@
+
+#include "animation.h"
+#include "../linalg/fast_math.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// The smallest three components of a unit quaternion are within
+// [-1/sqrt(2), 1/sqrt(2)], which is mapped onto 15 bits. Each is then off by
+// at most quat_step / 2 (2.2e-5), and the rebuilt largest one by up to three
+// times that (6.5e-5) when all four components are near 0.5.
+static const scalar half_sqrt2 = 0.707106781f;
+static const scalar quat_step = 1.41421356f / 32767;
+
+// The largest value of a 16 bit key
+static const scalar key_max = 65535;
+
+//------------------------------------------------------------------------------
+/// @brief      Pack a rotation as its smallest three components. The sign of
+/// the quaternion is chosen so the dropped (largest) component is positive,
+/// which lets it be rebuilt from the other three.
+///
+/// @param[in]  q     The rotation
+///
+/// @return     the packed rotation
+///
+static packed_quat pack_quat(quat q)
+{
+    q.normalize();
+    std::size_t largest = 0;
+    for (std::size_t i = 1; i < 4; ++i) {
+        if (std::abs(q.m_quat[i]) > std::abs(q.m_quat[largest])) {
+            largest = i;
+        }
+    }
+    scalar sign = q.m_quat[largest] < 0 ? -1 : 1;
+
+    packed_quat p;
+    for (std::size_t i = 0, j = 0; i < 4; ++i) {
+        if (i != largest) {
+            auto c = std::min(std::max(q.m_quat[i] * sign, -half_sqrt2), half_sqrt2);
+            p[j++] = static_cast<std::uint16_t>(std::lround((c + half_sqrt2) / quat_step));
+        }
+    }
+    p[0] = static_cast<std::uint16_t>(p[0] | (largest & 1) << 15);
+    p[1] = static_cast<std::uint16_t>(p[1] | (largest >> 1) << 15);
+    return p;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Unpack a rotation packed by pack_quat
+///
+/// @param[in]  p     The packed rotation
+///
+/// @return     the (unit) rotation
+///
+static quat unpack_quat(const packed_quat& p)
+{
+    auto largest = static_cast<std::size_t>((p[0] >> 15) | (p[1] >> 15) << 1);
+    scalar small[3] = {
+        static_cast<scalar>(p[0] & 0x7fff) * quat_step - half_sqrt2,
+        static_cast<scalar>(p[1] & 0x7fff) * quat_step - half_sqrt2,
+        static_cast<scalar>(p[2]) * quat_step - half_sqrt2
+    };
+    auto w = std::sqrt(std::max(scalar{0},
+        1 - small[0] * small[0] - small[1] * small[1] - small[2] * small[2]));
+
+    quat q;
+    for (std::size_t i = 0, j = 0; i < 4; ++i) {
+        q.m_quat[i] = i == largest ? w : small[j++];
+    }
+    return q;
+}
+
+// Quantize a value within [min, min + step * 65535] to 16 bits
+static std::uint16_t pack_key(scalar value, scalar min, scalar step) {
+    if (step <= 0) {
+        return 0;
+    }
+    return static_cast<std::uint16_t>(std::lround(std::min((value - min) / step, key_max)));
+}
+
+static scalar unpack_key(std::uint16_t key, scalar min, scalar step) {
+    return min + static_cast<scalar>(key) * step;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Sort the tracks into those where a channel is constant and
+/// those where it is animated. The constant values are stored; the keys of
+/// the animated tracks are added by the caller.
+///
+/// @param[in]  tracks   The uncompressed tracks
+/// @param[in]  get      Returns the value of the channel in a key
+/// @param[in]  same     Returns true if two values are within the tolerance
+/// @param[out] channel  The channel
+///
+template <typename Key, typename Value, typename Get, typename Same>
+static void split_channel(const std::vector<animation_track>& tracks, Get get, Same same,
+    animation_channel<Key, Value>& channel)
+{
+    for (std::size_t t = 0; t < tracks.size(); ++t) {
+        auto& keys = tracks[t].m_keys;
+        auto first = get(keys[0]);
+        auto constant = std::all_of(keys.begin(), keys.end(),
+            [&](const trs& key) { return same(first, get(key)); });
+
+        auto track = static_cast<std::uint32_t>(t);
+        if (constant) {
+            channel.m_const_tracks.push_back(track);
+            channel.m_const_values.push_back(first);
+        }
+        else {
+            channel.m_tracks.push_back(track);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Compress a set of tracks. The keys of every track are sampled
+/// at the same rate, and every track must have the same (non-zero) number of
+/// keys; if they do not, the clip is left empty.
+///
+/// @param[in]  rate    The number of keys per second
+/// @param[in]  tracks  The uncompressed tracks
+///
+animation_clip::animation_clip(scalar rate, const std::vector<animation_track>& tracks)
+    : m_rate(rate)
+    , m_frames(tracks.empty() ? 0 : static_cast<std::uint32_t>(tracks[0].m_keys.size()))
+{
+    for (auto& track : tracks) {
+        if (track.m_keys.size() != m_frames) {
+            m_frames = 0;
+            m_nodes.clear();
+            return;
+        }
+        m_nodes.push_back(track.m_node);
+    }
+    if (m_frames == 0) {
+        return;
+    }
+
+    // Rotations (q and -q are the same rotation)
+    split_channel(tracks, [](const trs& key) { return key.m_rot; },
+        [](const quat& a, const quat& b) {
+            scalar sign = a.dot(b) < 0 ? -1 : 1;
+            for (std::size_t i = 0; i < 4; ++i) {
+                if (std::abs(a.m_quat[i] - b.m_quat[i] * sign) > animation_constant_tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        }, m_rot);
+
+    // Translations, quantized within the bounding box of each track
+    split_channel(tracks, [](const trs& key) { return key.m_pos; },
+        [](const vector3& a, const vector3& b) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                if (std::abs(a.m_vec[i] - b.m_vec[i]) > animation_constant_tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        }, m_pos);
+    for (auto t : m_pos.m_tracks) {
+        auto& keys = tracks[t].m_keys;
+        auto lo = keys[0].m_pos, hi = keys[0].m_pos;
+        for (auto& key : keys) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                lo.m_vec[i] = std::min(lo.m_vec[i], key.m_pos.m_vec[i]);
+                hi.m_vec[i] = std::max(hi.m_vec[i], key.m_pos.m_vec[i]);
+            }
+        }
+        m_pos.m_min.push_back(lo);
+        m_pos.m_step.push_back((hi - lo) * (1 / key_max));
+    }
+
+    // Scales
+    split_channel(tracks, [](const trs& key) { return key.m_scale; },
+        [](scalar a, scalar b) { return std::abs(a - b) <= animation_constant_tolerance; },
+        m_scale);
+    for (auto t : m_scale.m_tracks) {
+        auto& keys = tracks[t].m_keys;
+        auto range = std::minmax_element(keys.begin(), keys.end(),
+            [](const trs& a, const trs& b) { return a.m_scale < b.m_scale; });
+        m_scale.m_min.push_back(range.first->m_scale);
+        m_scale.m_step.push_back((range.second->m_scale - range.first->m_scale) / key_max);
+    }
+
+    // The keys of the animated tracks, frame by frame
+    m_rot.m_keys.reserve(m_frames * m_rot.m_tracks.size());
+    m_pos.m_keys.reserve(m_frames * m_pos.m_tracks.size());
+    m_scale.m_keys.reserve(m_frames * m_scale.m_tracks.size());
+    for (std::size_t f = 0; f < m_frames; ++f) {
+        for (auto t : m_rot.m_tracks) {
+            m_rot.m_keys.push_back(pack_quat(tracks[t].m_keys[f].m_rot));
+        }
+        for (std::size_t j = 0; j < m_pos.m_tracks.size(); ++j) {
+            auto& pos = tracks[m_pos.m_tracks[j]].m_keys[f].m_pos;
+            auto& min = m_pos.m_min[j];
+            auto& step = m_pos.m_step[j];
+            m_pos.m_keys.push_back({{
+                pack_key(pos.x(), min.x(), step.x()),
+                pack_key(pos.y(), min.y(), step.y()),
+                pack_key(pos.z(), min.z(), step.z())
+            }});
+        }
+        for (std::size_t j = 0; j < m_scale.m_tracks.size(); ++j) {
+            auto scale = tracks[m_scale.m_tracks[j]].m_keys[f].m_scale;
+            m_scale.m_keys.push_back(pack_key(scale, m_scale.m_min[j], m_scale.m_step[j]));
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Sample every track at a time. The two frames around the time
+/// are decoded and interpolated (translation and scale linearly, rotation
+/// with nlerp).
+///
+/// @param[in]  time  The time in seconds (clamped to [0, duration()])
+/// @param[out] pose  The transform of each track (track_count() entries)
+///
+void animation_clip::sample(scalar time, trs* pose) const
+{
+    if (m_frames == 0) {
+        return;
+    }
+
+    auto last = m_frames - 1;
+    auto frame = std::min(std::max(time * m_rate, scalar{0}), static_cast<scalar>(last));
+    auto k = std::min(static_cast<std::uint32_t>(frame), last);
+    auto next = std::min(k + 1, last);
+    auto alpha = frame - static_cast<scalar>(k);
+
+    // Constant channels
+    for (std::size_t j = 0; j < m_rot.m_const_tracks.size(); ++j) {
+        pose[m_rot.m_const_tracks[j]].m_rot = m_rot.m_const_values[j];
+    }
+    for (std::size_t j = 0; j < m_pos.m_const_tracks.size(); ++j) {
+        pose[m_pos.m_const_tracks[j]].m_pos = m_pos.m_const_values[j];
+    }
+    for (std::size_t j = 0; j < m_scale.m_const_tracks.size(); ++j) {
+        pose[m_scale.m_const_tracks[j]].m_scale = m_scale.m_const_values[j];
+    }
+
+    // Animated rotations (nlerp, normalized with fast_rsqrt since the keys
+    // are only accurate to 7e-5 anyway)
+    auto count = m_rot.m_tracks.size();
+    auto a_rot = m_rot.m_keys.data() + k * count,
+         b_rot = m_rot.m_keys.data() + next * count;
+    for (std::size_t j = 0; j < count; ++j) {
+        auto a = unpack_quat(a_rot[j]), b = unpack_quat(b_rot[j]);
+        auto b_alpha = a.dot(b) < 0 ? -alpha : alpha;
+        auto& out = pose[m_rot.m_tracks[j]].m_rot;
+        for (std::size_t i = 0; i < 4; ++i) {
+            out.m_quat[i] = a.m_quat[i] * (1 - alpha) + b.m_quat[i] * b_alpha;
+        }
+        auto scale = fast_rsqrt(out.len2());
+        for (std::size_t i = 0; i < 4; ++i) {
+            out.m_quat[i] *= scale;
+        }
+    }
+
+    // Animated translations
+    count = m_pos.m_tracks.size();
+    auto a_pos = m_pos.m_keys.data() + k * count,
+         b_pos = m_pos.m_keys.data() + next * count;
+    for (std::size_t j = 0; j < count; ++j) {
+        auto& min = m_pos.m_min[j];
+        auto& step = m_pos.m_step[j];
+        auto& out = pose[m_pos.m_tracks[j]].m_pos;
+        for (std::size_t i = 0; i < 3; ++i) {
+            auto a = unpack_key(a_pos[j][i], min.m_vec[i], step.m_vec[i]),
+                 b = unpack_key(b_pos[j][i], min.m_vec[i], step.m_vec[i]);
+            out.m_vec[i] = a + (b - a) * alpha;
+        }
+    }
+
+    // Animated scales
+    count = m_scale.m_tracks.size();
+    auto a_scale = m_scale.m_keys.data() + k * count,
+         b_scale = m_scale.m_keys.data() + next * count;
+    for (std::size_t j = 0; j < count; ++j) {
+        auto a = unpack_key(a_scale[j], m_scale.m_min[j], m_scale.m_step[j]),
+             b = unpack_key(b_scale[j], m_scale.m_min[j], m_scale.m_step[j]);
+        pose[m_scale.m_tracks[j]].m_scale = a + (b - a) * alpha;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Sample every track at a time and set the local transform of
+/// its node (the world transforms change on the next tree update)
+///
+/// @param[in]  time  The time in seconds (clamped to [0, duration()])
+/// @param      pose  Scratch space for the sampled transforms
+/// @param      tree  The tree holding the nodes of the tracks
+///
+void animation_clip::apply(scalar time, std::vector<trs>& pose, transform_tree& tree) const
+{
+    pose.resize(track_count());
+    sample(time, pose.data());
+    for (std::size_t i = 0; i < pose.size(); ++i) {
+        tree.set_local(m_nodes[i], pose[i].to_matrix4());
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Return the number of bytes used by the keys and ranges of this
+/// clip (not counting unused vector capacity)
+///
+std::size_t animation_clip::memory_size() const
+{
+    return m_nodes.size() * sizeof(node_id)
+        + m_rot.memory_size()
+        + m_pos.memory_size()
+        + m_scale.memory_size();
+}
@@ -0,0 +1,125 @@
+
+#ifndef _ANIMATION_H_
+#define _ANIMATION_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+#include "../linalg/quat.h"
+#include "../linalg/trs.h"
+#include "transform_tree.h"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// Keys within this distance of the first key of a track (per component) make
+// the channel constant, and it is stored once at full precision
+constexpr scalar animation_constant_tolerance = 1e-5f;
+
+//------------------------------------------------------------------------------
+/// @brief      The keyframes of one node, sampled at the rate of the clip
+/// (key i is the transform at time i / rate). This is the uncompressed input
+/// of animation_clip.
+///
+struct animation_track
+{
+    node_id m_node;
+    std::vector<trs> m_keys;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One channel (rotation, translation or scale) of every track in
+/// a clip. The tracks whose channel never changes keep a single value; the
+/// keys of the others are quantized to 16 bits per component and stored
+/// frame by frame (all the animated tracks of frame 0, then frame 1, ...),
+/// so sampling a frame reads two contiguous rows.
+///
+template <typename Key, typename Value>
+struct animation_channel
+{
+    // Tracks with a constant value
+    std::vector<std::uint32_t> m_const_tracks;
+    std::vector<Value> m_const_values;
+
+    // Animated tracks, with the range used to decode their keys (the value
+    // of a key k is m_min + k * m_step; rotations do not use a range)
+    std::vector<std::uint32_t> m_tracks;
+    std::vector<Value> m_min;
+    std::vector<Value> m_step;
+    std::vector<Key> m_keys;
+
+    // Return the number of bytes used by this channel
+    std::size_t memory_size() const {
+        return (m_const_tracks.size() + m_tracks.size()) * sizeof(std::uint32_t)
+            + (m_const_values.size() + m_min.size() + m_step.size()) * sizeof(Value)
+            + m_keys.size() * sizeof(Key);
+    }
+};
+
+// A rotation packed as its three smallest components (15 bits each) and the
+// index of the largest one (2 bits), a translation as three 16 bit offsets
+using packed_quat = std::array<std::uint16_t, 3>;
+using packed_vector3 = std::array<std::uint16_t, 3>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines a compressed, uniformly sampled animation
+/// of a number of nodes. Rotations take 6 bytes per key (smallest three,
+/// error < 7e-5 per component, reached when all four components are near
+/// 0.5), translations 6 bytes per key (16 bits within the range of the
+/// track) and the uniform scale 2 bytes per key; channels that do not change
+/// take no keys at all. A clip is sampled for every track at once and the
+/// result can be written straight into a transform_tree.
+///
+class animation_clip
+{
+public:
+    scalar m_rate;
+    std::uint32_t m_frames;
+    std::vector<node_id> m_nodes;
+    animation_channel<packed_quat, quat> m_rot;
+    animation_channel<packed_vector3, vector3> m_pos;
+    animation_channel<std::uint16_t, scalar> m_scale;
+
+public: // Constructors ---------------------------------------------
+
+    animation_clip()
+        : m_rate(1)
+        , m_frames(0)
+    {}
+
+    // Compress tracks sampled at rate keys per second (every track must
+    // have the same, non-zero, number of keys, otherwise the clip is empty)
+    animation_clip(scalar rate, const std::vector<animation_track>& tracks);
+
+    animation_clip clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    std::size_t track_count() const { return m_nodes.size(); }
+
+    std::uint32_t frame_count() const { return m_frames; }
+
+    // The time of the last key (in seconds)
+    scalar duration() const {
+        return m_frames > 1 ? static_cast<scalar>(m_frames - 1) / m_rate : 0;
+    }
+
+public: // Information interface mthods -----------------------------
+
+    // Sample every track at time (clamped to the clip) into pose, which must
+    // have room for track_count() transforms
+    void sample(scalar time, trs* pose) const;
+
+    // Sample every track at time and set the local transforms of the nodes
+    // (pose is scratch space and is resized to track_count())
+    void apply(scalar time, std::vector<trs>& pose, transform_tree& tree) const;
+
+    // Return the number of bytes used by the keys and ranges of this clip
+    std::size_t memory_size() const;
+
+};
+
+#endif
@@ -0,0 +1,195 @@
+
+#include "frustum.h"
+#include "../linalg/simd.h"
+
+#include <cmath>
+
+#if defined(LINALG_SIMD)
+using namespace simd;
+#endif
+
+
+//------------------------------------------------------------------------------
+/// @brief      Set the planes from a view-projection matrix. With row vectors
+/// the clip coordinates are [p 1] * m, so each plane is the w column plus or
+/// minus the x, y or z column (Gribb and Hartmann). The planes are
+/// normalized so that plane distances are in world units.
+///
+/// @param[in]  view_proj  The view-projection matrix
+///
+/// @return     the updated frustum
+///
+frustum& frustum::set(const matrix4& view_proj) {
+    const auto& m = view_proj.m_mat;
+
+    // Left, right, bottom, top, near, far
+    for (auto p = 0u; p < 6; ++p) {
+        auto col = p / 2;
+        scalar sign = (p % 2 == 0) ? 1 : -1;
+
+        scalar len2 = 0;
+        for (auto i = 0u; i < 4; ++i) {
+            m_planes[p * 4 + i] = m[i * 4 + 3] + sign * m[i * 4 + col];
+            len2 += (i < 3) ? m_planes[p * 4 + i] * m_planes[p * 4 + i] : 0;
+        }
+
+        if (len2 > 0) {
+            auto s = 1 / std::sqrt(len2);
+            for (auto i = 0u; i < 4; ++i) {
+                m_planes[p * 4 + i] *= s;
+            }
+        }
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Test a sphere against the frustum
+///
+/// @param[in]  center  The center of the sphere
+/// @param[in]  radius  The radius of the sphere
+///
+/// @return     false if the sphere is entirely outside a plane
+///
+bool frustum::test_sphere(const vector3& center, scalar radius) const {
+    for (auto p = 0u; p < 24; p += 4) {
+        auto d = m_planes[p] * center.x() + m_planes[p + 1] * center.y()
+               + m_planes[p + 2] * center.z() + m_planes[p + 3];
+        if (d < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Test an axis aligned box against the frustum
+///
+/// @param[in]  center  The center of the box
+/// @param[in]  extent  The half size of the box along each axis
+///
+/// @return     false if the box is entirely outside a plane
+///
+bool frustum::test_box(const vector3& center, const vector3& extent) const {
+    for (auto p = 0u; p < 24; p += 4) {
+        auto d = m_planes[p] * center.x() + m_planes[p + 1] * center.y()
+               + m_planes[p + 2] * center.z() + m_planes[p + 3];
+        auto r = std::abs(m_planes[p]) * extent.x() + std::abs(m_planes[p + 1]) * extent.y()
+               + std::abs(m_planes[p + 2]) * extent.z();
+        if (d < -r) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Append the indices i..i+3 whose bit is set in mask to visible.
+/// Every index is written and the count only advances for set bits, so
+/// there are no branches to mispredict.
+///
+static inline std::size_t compact(int mask, std::uint32_t i, std::uint32_t* visible,
+    std::size_t n)
+{
+    visible[n] = i;
+    n += static_cast<std::size_t>(mask & 1);
+    visible[n] = i + 1;
+    n += static_cast<std::size_t>((mask >> 1) & 1);
+    visible[n] = i + 2;
+    n += static_cast<std::size_t>((mask >> 2) & 1);
+    visible[n] = i + 3;
+    n += static_cast<std::size_t>((mask >> 3) & 1);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Cull a batch of spheres. The output must have room for
+/// centers.size() indices; the visible ones are written in order.
+///
+/// @param[in]  centers  The sphere centers
+/// @param[in]  radii    The sphere radii (centers.size() values)
+/// @param[out] visible  The indices of the spheres that may be visible
+///
+/// @return     the number of indices written to visible
+///
+std::size_t frustum::cull_spheres(const vector3_soa& centers, const scalar* radii,
+    std::uint32_t* visible) const
+{
+    std::size_t n = 0, i = 0, count = centers.size();
+#if defined(LINALG_SIMD)
+    f32x4 planes[24];
+    for (auto p = 0u; p < 24; ++p) {
+        planes[p] = splat(m_planes[p]);
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        auto x = load_aligned(&centers.m_x[i]), y = load_aligned(&centers.m_y[i]),
+             z = load_aligned(&centers.m_z[i]), r = load(&radii[i]);
+
+        // The smallest signed distance (plus radius) over all planes
+        auto nearest = splat(0);
+        for (auto p = 0u; p < 24; p += 4) {
+            auto d = madd(planes[p], x, madd(planes[p + 1], y, madd(planes[p + 2], z,
+                simd::add(planes[p + 3], r))));
+            nearest = p == 0 ? d : simd::min(nearest, d);
+        }
+
+        auto outside = bitmask(lt(nearest, splat(0)));
+        n = compact(~outside & 0xF, static_cast<std::uint32_t>(i), visible, n);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (test_sphere(centers.get(i), radii[i])) {
+            visible[n++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Cull a batch of axis aligned boxes. The output must have room
+/// for centers.size() indices; the visible ones are written in order.
+///
+/// @param[in]  centers  The box centers
+/// @param[in]  extents  The half sizes of the boxes (same size as centers)
+/// @param[out] visible  The indices of the boxes that may be visible
+///
+/// @return     the number of indices written to visible
+///
+std::size_t frustum::cull_boxes(const vector3_soa& centers, const vector3_soa& extents,
+    std::uint32_t* visible) const
+{
+    std::size_t n = 0, i = 0, count = centers.size();
+#if defined(LINALG_SIMD)
+    f32x4 planes[24], abs_planes[24];
+    for (auto p = 0u; p < 24; ++p) {
+        planes[p] = splat(m_planes[p]);
+        abs_planes[p] = splat(std::abs(m_planes[p]));
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        auto x = load_aligned(&centers.m_x[i]), y = load_aligned(&centers.m_y[i]),
+             z = load_aligned(&centers.m_z[i]), ex = load_aligned(&extents.m_x[i]),
+             ey = load_aligned(&extents.m_y[i]), ez = load_aligned(&extents.m_z[i]);
+
+        // The smallest signed distance (plus projected extent) over all planes
+        auto nearest = splat(0);
+        for (auto p = 0u; p < 24; p += 4) {
+            auto r = madd(abs_planes[p], ex, madd(abs_planes[p + 1], ey,
+                mul(abs_planes[p + 2], ez)));
+            auto d = madd(planes[p], x, madd(planes[p + 1], y, madd(planes[p + 2], z,
+                simd::add(planes[p + 3], r))));
+            nearest = p == 0 ? d : simd::min(nearest, d);
+        }
+
+        auto outside = bitmask(lt(nearest, splat(0)));
+        n = compact(~outside & 0xF, static_cast<std::uint32_t>(i), visible, n);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (test_box(centers.get(i), extents.get(i))) {
+            visible[n++] = static_cast<std::uint32_t>(i);
+        }
+    }
+    return n;
+}
@@ -0,0 +1,69 @@
+
+#ifndef _FRUSTUM_H_
+#define _FRUSTUM_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+#include "../linalg/vector3_soa.h"
+#include "../linalg/matrix4.h"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+// Six planes (a, b, c, d) with ax + by + cz + d >= 0 on the inside
+using plane_array = std::array<scalar, 24>;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines a view frustum that is used to reject
+/// objects that can not be seen. The planes are extracted from a
+/// view-projection matrix (view.mul(proj)) and point inwards. Note that
+/// matrix4::look_at points +z at the target while matrix4::perspective looks
+/// down -z, so a z flip is needed between the two. Tests are conservative:
+/// an object that is reported as outside is never visible, but some objects
+/// near the corners are reported as inside.
+///
+class frustum
+{
+public:
+    plane_array m_planes;
+
+public: // Constructors ---------------------------------------------
+
+    // The clip cube [-1, 1] (the frustum of the identity matrix)
+    frustum() {
+        set(matrix4());
+    }
+
+    explicit frustum(const matrix4& view_proj) {
+        set(view_proj);
+    }
+
+    frustum clone() const {
+        return {*this};
+    }
+
+public: // Mutating interface methods -------------------------------
+
+    // Set the planes from a view-projection matrix
+    frustum& set(const matrix4& view_proj);
+
+public: // Information interface mthods -----------------------------
+
+    // Return true if the sphere may be visible
+    bool test_sphere(const vector3& center, scalar radius) const;
+
+    // Return true if the box (center +/- extent) may be visible
+    bool test_box(const vector3& center, const vector3& extent) const;
+
+    // Write the indices of the spheres that may be visible
+    std::size_t cull_spheres(const vector3_soa& centers, const scalar* radii,
+        std::uint32_t* visible) const;
+
+    // Write the indices of the boxes that may be visible
+    std::size_t cull_boxes(const vector3_soa& centers, const vector3_soa& extents,
+        std::uint32_t* visible) const;
+
+};
+
+#endif
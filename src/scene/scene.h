@@ -3,13 +3,20 @@
 #define _SCENE_H_
 
 #include "../render/renderer.h"
+#include "transform_tree.h"
 
 class scene
 {
     renderer m_renderer;
+    transform_tree m_transforms;
 public:
     // scene();
+    transform_tree& transforms() {
+        return m_transforms;
+    }
+
     void render() {
+        m_transforms.update();
         m_renderer.render_frame();
     }
 };
@@ -0,0 +1,172 @@
+
+#include "skinning.h"
+#include "../linalg/simd.h"
+#include "../linalg/fast_math.h"
+#include "../linalg/parallel.h"
+
+#include <algorithm>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Add a joint under the parent (or a root). Call bind once every
+/// joint is in its bind pose.
+///
+/// @param[in]  parent  The parent joint, which must already be in the
+///                     skeleton (or no_parent for a root)
+/// @param[in]  local   The bind pose transform relative to the parent
+///
+/// @return     the id of the new joint, or no_parent (and nothing is
+///             added) if the parent is not in the skeleton
+///
+node_id skeleton::add_joint(node_id parent, const matrix4& local) {
+    auto joint = m_joints.add(parent, local);
+    if (joint != no_parent) {
+        m_inverse_bind.emplace_back();
+        m_palette.emplace_back();
+    }
+    return joint;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Make the current pose of the joints the bind pose (the pose
+/// the meshes were modelled in, where the palette is all identities)
+///
+/// @return     the updated skeleton
+///
+skeleton& skeleton::bind() {
+    m_joints.update();
+    for (std::size_t i = 0; i < size(); ++i) {
+        m_inverse_bind[i] = m_joints.m_world[i].clone().invert();
+    }
+    return update_palette();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Update the world transforms of the joints and set palette[i]
+/// to inverse_bind[i] * world[i]
+///
+/// @return     the updated skeleton
+///
+skeleton& skeleton::update_palette() {
+    m_joints.update();
+    mul_batch(m_inverse_bind.data(), m_joints.world_data(), m_palette.data(), size());
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Add a vertex
+///
+/// @param[in]  pos      The bind pose position
+/// @param[in]  normal   The bind pose normal
+/// @param[in]  weights  The joints moving the vertex
+///
+/// @return     the updated skin
+///
+skin& skin::add(const vector3& pos, const vector3& normal, const skin_weights& weights) {
+    m_positions.push_back(pos);
+    m_normals.push_back(normal);
+    m_weights.push_back(weights);
+    return *this;
+}
+
+// Write a skinned vertex, normalizing the normal (zero normals stay zero)
+static void store_vertex(skinned_vertex& out, const float* pos, const float* normal) {
+    auto len2 = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+    auto s = len2 > 0 ? fast_rsqrt(len2) : 0;
+    out.m_pos = vector3(pos[0], pos[1], pos[2]);
+    out.m_normal = vector3(normal[0] * s, normal[1] * s, normal[2] * s);
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Skin the vertices [begin, end) of a mesh. The palette matrices
+/// of each vertex are blended by its weights (linear blend skinning), and the
+/// position and normal are transformed by the blend. With SIMD a matrix row
+/// is one register, so the blend is four multiply-adds per row.
+///
+/// @param[in]  mesh     The bind pose
+/// @param[in]  palette  The palette of the skeleton (indexed by the joints of
+///                      the weights)
+/// @param[out] out      The skinned vertices (indexed like the mesh)
+/// @param[in]  begin    The first vertex
+/// @param[in]  end      One past the last vertex
+///
+void skin_vertices(const skin& mesh, const matrix4* palette, skinned_vertex* out,
+    std::size_t begin, std::size_t end)
+{
+    for (auto i = begin; i < end; ++i) {
+        auto& w = mesh.m_weights[i];
+        auto& p = mesh.m_positions[i];
+        auto& n = mesh.m_normals[i];
+        auto a = palette[w.m_joints[0]].m_mat.data(),
+             b = palette[w.m_joints[1]].m_mat.data(),
+             c = palette[w.m_joints[2]].m_mat.data(),
+             d = palette[w.m_joints[3]].m_mat.data();
+        float pos[4], normal[4];
+
+#if defined(LINALG_SIMD)
+        using namespace simd;
+        auto wa = splat(w.m_weights[0]), wb = splat(w.m_weights[1]),
+             wc = splat(w.m_weights[2]), wd = splat(w.m_weights[3]);
+        f32x4 rows[4];
+        for (std::size_t r = 0; r < 4; ++r) {
+            auto k = 4 * r;
+            rows[r] = madd(load(d + k), wd, madd(load(c + k), wc,
+                madd(load(b + k), wb, mul(load(a + k), wa))));
+        }
+        store(pos, madd(splat(p.x()), rows[0],
+            madd(splat(p.y()), rows[1], madd(splat(p.z()), rows[2], rows[3]))));
+        store(normal, madd(splat(n.x()), rows[0],
+            madd(splat(n.y()), rows[1], mul(splat(n.z()), rows[2]))));
+#else
+        // Only the first three columns of the blend are needed
+        float blend[12];
+        for (std::size_t r = 0; r < 4; ++r) {
+            for (std::size_t col = 0; col < 3; ++col) {
+                auto k = 4 * r + col;
+                blend[3 * r + col] = a[k] * w.m_weights[0] + b[k] * w.m_weights[1]
+                    + c[k] * w.m_weights[2] + d[k] * w.m_weights[3];
+            }
+        }
+        for (std::size_t col = 0; col < 3; ++col) {
+            normal[col] = n.x() * blend[col] + n.y() * blend[3 + col] + n.z() * blend[6 + col];
+            pos[col] = p.x() * blend[col] + p.y() * blend[3 + col] + p.z() * blend[6 + col]
+                + blend[9 + col];
+        }
+#endif
+        store_vertex(out[i], pos, normal);
+    }
+}
+
+// Meshes with fewer vertices than this (per thread) are skinned on the
+// calling thread
+static const std::size_t skin_min_per_thread = 1 << 13;
+
+//------------------------------------------------------------------------------
+/// @brief      Skin a number of meshes. The vertices of all the meshes are
+/// split evenly across threads (so one large mesh is spread as well as many
+/// small ones), and each thread skins the parts of the meshes in its range.
+///
+/// @param[in]  jobs   The meshes, palettes and output buffers
+/// @param[in]  count  The number of meshes
+///
+void skin_meshes(const skin_job* jobs, std::size_t count)
+{
+    // The index of the first vertex of each mesh in the combined range
+    std::vector<std::size_t> first(count + 1, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        first[i + 1] = first[i] + jobs[i].m_skin->size();
+    }
+
+    parallel_for(first[count], skin_min_per_thread, [&](std::size_t begin, std::size_t end) {
+        auto mesh = static_cast<std::size_t>(
+            std::upper_bound(first.begin(), first.end(), begin) - first.begin()) - 1;
+        while (begin < end) {
+            auto stop = std::min(end, first[mesh + 1]);
+            auto& job = jobs[mesh];
+            skin_vertices(*job.m_skin, job.m_palette, job.m_out,
+                begin - first[mesh], stop - first[mesh]);
+            begin = stop;
+            ++mesh;
+        }
+    });
+}
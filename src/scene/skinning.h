@@ -0,0 +1,121 @@
+
+#ifndef _SKINNING_H_
+#define _SKINNING_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/vector3.h"
+#include "../linalg/matrix4.h"
+#include "../linalg/matrix4a.h"
+#include "transform_tree.h"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines the joints of a skinned character. The
+/// joints are a transform_tree (so an animation_clip can pose them), the
+/// inverse bind matrices map the bind pose into the space of each joint, and
+/// the palette holds inverse_bind * world for every joint, which is what the
+/// vertices are skinned with.
+///
+class skeleton
+{
+public:
+    transform_tree m_joints;
+    matrix4_array m_inverse_bind;
+    matrix4_array m_palette;
+
+public: // Constructors ---------------------------------------------
+
+    skeleton clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    std::size_t size() const { return m_joints.size(); }
+
+    // The palette (as of the last update_palette)
+    const matrix4* palette() const { return m_palette.data(); }
+
+public: // Mutating interface methods -------------------------------
+
+    // Add a joint under the parent (or a root) with its bind pose transform
+    node_id add_joint(node_id parent, const matrix4& local=matrix4());
+
+    // Make the current pose of the joints the bind pose
+    skeleton& bind();
+
+    // Update the world transforms of the joints and recompute the palette
+    skeleton& update_palette();
+
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The joints that move a vertex and their weights (which sum to
+/// one; unused influences have a weight of zero)
+///
+struct skin_weights
+{
+    std::array<std::uint8_t, 4> m_joints;
+    std::array<scalar, 4> m_weights;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A skinned vertex as it is uploaded (position then normal,
+/// tightly packed, so the stride is 24 bytes)
+///
+struct skinned_vertex
+{
+    vector3 m_pos;
+    vector3 m_normal;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      The bind pose of a skinned mesh, one array per attribute
+///
+class skin
+{
+public:
+    std::vector<vector3> m_positions;
+    std::vector<vector3> m_normals;
+    std::vector<skin_weights> m_weights;
+
+public: // Constructors ---------------------------------------------
+
+    skin clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    std::size_t size() const { return m_positions.size(); }
+
+public: // Mutating interface methods -------------------------------
+
+    // Add a vertex
+    skin& add(const vector3& pos, const vector3& normal, const skin_weights& weights);
+
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One mesh to skin: the bind pose, the palette of its skeleton
+/// and where to write the size() skinned vertices
+///
+struct skin_job
+{
+    const skin* m_skin;
+    const matrix4* m_palette;
+    skinned_vertex* m_out;
+};
+
+// Skin the vertices [begin, end) of a mesh (on the calling thread)
+void skin_vertices(const skin& mesh, const matrix4* palette, skinned_vertex* out,
+    std::size_t begin, std::size_t end);
+
+// Skin a number of meshes, splitting their vertices across threads
+void skin_meshes(const skin_job* jobs, std::size_t count);
+
+#endif
@@ -0,0 +1,125 @@
+
+#include "transform_tree.h"
+
+#include <algorithm>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Add a node under the parent (or a root). The node starts
+/// dirty, so its world transform is set by the next update.
+///
+/// @param[in]  parent  The parent node, which must already be in the tree
+///                     (or no_parent for a root)
+/// @param[in]  local   The transform relative to the parent
+///
+/// @return     the id of the new node, or no_parent (and nothing is added)
+///             if the parent is not in the tree
+///
+node_id transform_tree::add(node_id parent, const matrix4& local) {
+    // update() relies on parents coming before their children
+    if (parent != no_parent && parent >= size()) {
+        return no_parent;
+    }
+    auto node = static_cast<node_id>(size());
+    m_parent.push_back(parent);
+    m_local.push_back(local);
+    m_world.push_back(local);
+    m_dirty.push_back(1);
+    m_any_dirty = true;
+    return node;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Set the local transform of a node
+///
+/// @param[in]  node   The node
+/// @param[in]  local  The transform relative to the parent
+///
+/// @return     the updated tree
+///
+transform_tree& transform_tree::set_local(node_id node, const matrix4& local) {
+    m_local[node] = local;
+    m_dirty[node] = 1;
+    m_any_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Multiply the local transform of a node by a matrix (applying
+/// the matrix after the current local transform)
+///
+/// @param[in]  node  The node
+/// @param[in]  mat   The matrix
+///
+/// @return     the updated tree
+///
+transform_tree& transform_tree::mul_local(node_id node, const matrix4& mat) {
+    m_local[node].mul(mat);
+    m_dirty[node] = 1;
+    m_any_dirty = true;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Reserve space for a number of nodes
+///
+/// @param[in]  count  The number of nodes
+///
+/// @return     the updated tree
+///
+transform_tree& transform_tree::reserve(std::size_t count) {
+    m_parent.reserve(count);
+    m_local.reserve(count);
+    m_world.reserve(count);
+    m_dirty.reserve(count);
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Remove every node
+///
+/// @return     the updated tree
+///
+transform_tree& transform_tree::clear() {
+    m_parent.clear();
+    m_local.clear();
+    m_world.clear();
+    m_dirty.clear();
+    m_any_dirty = false;
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Recompute the world transforms of the dirty nodes and their
+/// descendants in one pass over the nodes. Parents come before their
+/// children, so when a node is reached its parent is final and the parent's
+/// flag says whether it changed in this pass.
+///
+/// @return     the number of world transforms that were recomputed
+///
+std::size_t transform_tree::update() {
+    if (!m_any_dirty) {
+        return 0;
+    }
+
+    std::size_t updated = 0;
+    auto count = size();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto parent = m_parent[i];
+        if (parent == no_parent) {
+            if (m_dirty[i]) {
+                m_world[i] = m_local[i];
+                ++updated;
+            }
+        }
+        else if (m_dirty[i] | m_dirty[parent]) {
+            mul_batch(&m_local[i], m_world[parent], &m_world[i], 1);
+            m_dirty[i] = 1;
+            ++updated;
+        }
+    }
+
+    std::fill(m_dirty.begin(), m_dirty.end(), std::uint8_t{0});
+    m_any_dirty = false;
+    return updated;
+}
@@ -0,0 +1,91 @@
+
+#ifndef _TRANSFORM_TREE_H_
+#define _TRANSFORM_TREE_H_
+
+#include "../linalg/linalg.h"
+#include "../linalg/matrix4.h"
+#include "../linalg/matrix4a.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// The index of a node in a transform_tree
+using node_id = std::uint32_t;
+
+// The parent of a root node
+constexpr node_id no_parent = 0xffffffffu;
+
+//------------------------------------------------------------------------------
+/// @brief      This class defines a hierarchy of transforms (a scene graph
+/// without the scene). The nodes are flat arrays indexed by node_id, and a
+/// parent is always stored before its children, so a single pass in index
+/// order visits every parent before its subtree. Each node has a local
+/// transform (relative to its parent) and a world transform (local times
+/// the world transform of the parent). Changing a local transform only marks
+/// the node dirty; update() then recomputes the world transforms of the
+/// dirty nodes and their descendants, and nothing else.
+///
+class transform_tree
+{
+public:
+    std::vector<node_id> m_parent;
+    matrix4_array m_local;
+    matrix4_array m_world;
+    std::vector<std::uint8_t> m_dirty;
+    bool m_any_dirty;
+
+public: // Constructors ---------------------------------------------
+
+    transform_tree()
+        : m_any_dirty(false)
+    {}
+
+    transform_tree clone() const {
+        return {*this};
+    }
+
+public: // Accessor methods -----------------------------------------
+
+    std::size_t size() const { return m_parent.size(); }
+
+    node_id parent(node_id node) const { return m_parent[node]; }
+
+    const matrix4& local(node_id node) const { return m_local[node]; }
+
+    // The world transform (as of the last update)
+    const matrix4& world(node_id node) const { return m_world[node]; }
+
+    // All world transforms in node order (e.g. for uploading or culling)
+    const matrix4* world_data() const { return m_world.data(); }
+
+public: // Mutating interface methods -------------------------------
+
+    // Add a node under the parent (or a root) and return its id. The parent
+    // must already be in the tree, so parents come before their children;
+    // otherwise nothing is added and no_parent is returned.
+    node_id add(node_id parent, const matrix4& local=matrix4());
+
+    // Set the local transform of a node
+    transform_tree& set_local(node_id node, const matrix4& local);
+
+    // Multiply the local transform of a node by a matrix
+    transform_tree& mul_local(node_id node, const matrix4& mat);
+
+    // Reserve space for a number of nodes
+    transform_tree& reserve(std::size_t count);
+
+    // Remove every node
+    transform_tree& clear();
+
+    // Recompute the world transforms of the dirty subtrees
+    std::size_t update();
+
+public: // Information interface mthods -----------------------------
+
+    // Return true if a world transform is out of date
+    bool dirty() const { return m_any_dirty; }
+
+};
+
+#endif
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+/// Convert OBJ files to the binary mesh format (see objects/mesh_file.h), so
+/// the meshes are memory mapped and uploaded at runtime instead of parsed.
+/// The triangles and vertices are reordered for the vertex cache, overdraw
+/// and vertex fetches (see objects/mesh_optimizer.h), given a chain of
+/// levels of detail (see objects/mesh_simplify.h) and quantized (see
+/// objects/mesh_quantize.h) on the way.
+///
+/// Usage: spear-meshc input.obj output.mesh
+///
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh_optimizer.h>
+#include <objects/mesh_quantize.h>
+#include <objects/mesh_simplify.h>
+#include <objects/mesh_file.h>
+
+#include <iostream>
+#include <cstdlib>
+
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " input.obj output.mesh" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    obj_data obj;
+    if (!load_obj(argv[1], obj)) {
+        std::cerr << "ERROR: Could not load " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto mesh = build_mesh(obj);
+    auto& indices = mesh.m_indices;
+    auto before = analyze_vertex_cache(indices.data(), indices.size(), mesh.vertex_count());
+    auto after = optimize_mesh(mesh);
+    build_lods(mesh);
+    quantize_mesh(mesh);
+    if (!write_mesh_file(argv[2], mesh)) {
+        std::cerr << "ERROR: Could not write " << argv[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << argv[2] << ": " << mesh.vertex_count() << " vertices ("
+              << mesh.m_stride << " bytes each), "
+              << obj.triangle_count() << " triangles, ACMR "
+              << before.m_acmr << " -> " << after.m_acmr << ", ATVR "
+              << before.m_atvr << " -> " << after.m_atvr << std::endl;
+    for (std::size_t i = 1; i < mesh.m_lods.size(); ++i) {
+        std::cout << "  LOD " << i << ": " << mesh.m_lods[i].m_index_count / 3
+                  << " triangles, error " << mesh.m_lods[i].m_error << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
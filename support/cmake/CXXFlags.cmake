@@ -36,3 +36,22 @@ SET(CMAKE_CXX_FLAGS_DEBUG "${CMAKE_CXX_FLAGS_DEBUG} -Wconversion")
 SET(CMAKE_CXX_FLAGS_DEBUG "${CMAKE_CXX_FLAGS_DEBUG} -Wunreachable-code")
 ### Issue all warnings demanded by strict ISO C++
 SET(CMAKE_CXX_FLAGS_DEBUG "${CMAKE_CXX_FLAGS_DEBUG} -pedantic")
+
+## SIMD Flags
+### Use the SIMD backend in linalg (SSE natively, simd128 under Emscripten)
+option (LINALG_SIMD "Use the SIMD backend for linalg" ON)
+if (LINALG_SIMD)
+    if (EMSCRIPTEN)
+        SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -msimd128")
+    endif (EMSCRIPTEN)
+else (LINALG_SIMD)
+    SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DLINALG_NO_SIMD")
+endif (LINALG_SIMD)
+
+## Fast Math Flags
+### Use the approximations in linalg/fast_math.h by default (normalize, len,
+### rotate and perspective); the exact versions are used otherwise
+option (LINALG_FAST_MATH "Use the approximate math in linalg by default" OFF)
+if (LINALG_FAST_MATH)
+    SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DLINALG_FAST_MATH")
+endif (LINALG_FAST_MATH)
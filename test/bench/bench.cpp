@@ -0,0 +1,80 @@
+
+#include "bench.h"
+
+#include <linalg/simd.h>
+#include <linalg/parallel.h>
+
+#include <ostream>
+
+
+//------------------------------------------------------------------------------
+/// @brief      Write a string as a JSON string (the names only use printable
+/// characters, so only quotes and backslashes are escaped)
+///
+static void write_string(std::ostream& out, const std::string& s)
+{
+    out << '"';
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Write all results as JSON, along with what the numbers depend
+/// on (platform, SIMD backend, threads and compiler) so that results from
+/// native and Emscripten builds can be told apart and compared
+///
+/// @param      out   The output stream
+///
+void bench_suite::write_json(std::ostream& out) const
+{
+#if defined(__EMSCRIPTEN__)
+    const char* platform = "emscripten";
+#else
+    const char* platform = "native";
+#endif
+
+#if defined(LINALG_SIMD_SSE)
+    const char* simd_backend = "sse";
+#elif defined(LINALG_SIMD_WASM)
+    const char* simd_backend = "wasm";
+#else
+    const char* simd_backend = "none";
+#endif
+
+#if defined(LINALG_NO_THREADS)
+    const char* threads = "false";
+#else
+    const char* threads = "true";
+#endif
+
+#if defined(__VERSION__)
+    const char* compiler = __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+
+    out << "{\n"
+        << "  \"suite\": \"spear-LinalgBench\",\n"
+        << "  \"platform\": \"" << platform << "\",\n"
+        << "  \"simd\": \"" << simd_backend << "\",\n"
+        << "  \"threads\": " << threads << ",\n"
+        << "  \"compiler\": ";
+    write_string(out, compiler);
+    out << ",\n  \"results\": [";
+
+    for (std::size_t i = 0; i < m_results.size(); ++i) {
+        const auto& r = m_results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        write_string(out, r.m_name);
+        out << ", \"scenario\": ";
+        write_string(out, r.m_scenario);
+        out << ", \"ns_per_op\": " << r.m_ns_per_op
+            << ", \"ops\": " << r.m_ops << "}";
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,129 @@
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+/// @brief      Keep the compiler from optimizing away a value (or the work
+/// that produced it) and from caching memory across loop iterations
+///
+template <typename T>
+inline void escape(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline void clobber()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+//------------------------------------------------------------------------------
+/// @brief      The result of a single benchmark
+///
+struct bench_result
+{
+    std::string m_name;
+    std::string m_scenario;
+    double m_ns_per_op;
+    std::size_t m_ops;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A minimal benchmark runner. Each benchmark is a function that
+/// performs a number of operations; the runner repeats it and keeps the
+/// best time (the least disturbed by the rest of the system), then writes
+/// all results as JSON.
+///
+class bench_suite
+{
+    using clock = std::chrono::steady_clock;
+
+    std::string m_filter;
+    double m_min_ms;
+    int m_reps;
+    std::vector<bench_result> m_results;
+
+public:
+    bench_suite(std::string filter="", double min_ms=20, int reps=5)
+        : m_filter(filter)
+        , m_min_ms(min_ms)
+        , m_reps(reps)
+    {}
+
+    const std::vector<bench_result>& results() const { return m_results; }
+
+    // Run f(n), which makes n calls of ops_per_call operations each, with n
+    // grown until a run takes at least min_ms. Record the best time per
+    // operation.
+    template <typename F>
+    void run(const std::string& name, const std::string& scenario,
+        std::size_t ops_per_call, F f)
+    {
+        if (!selected(name, scenario)) {
+            return;
+        }
+
+        std::size_t n = 1;
+        while (time_ms(f, n) < m_min_ms / 10 && n < (std::size_t{1} << 40)) {
+            n *= 2;
+        }
+        n *= 10;
+
+        record(name, scenario, f, n, n * ops_per_call);
+    }
+
+    // Run f(), which performs ops operations, a fixed number of times (for
+    // passes over large arrays that take long enough on their own)
+    template <typename F>
+    void run_fixed(const std::string& name, const std::string& scenario,
+        std::size_t ops, F f)
+    {
+        if (!selected(name, scenario)) {
+            return;
+        }
+        record(name, scenario, [&](std::size_t) { f(); }, 1, ops);
+    }
+
+    // Write all results (and a description of the build) as JSON
+    void write_json(std::ostream& out) const;
+
+private:
+    bool selected(const std::string& name, const std::string& scenario) const {
+        return m_filter.empty() || (name + "/" + scenario).find(m_filter) != std::string::npos;
+    }
+
+    template <typename F>
+    double time_ms(F& f, std::size_t n) {
+        auto start = clock::now();
+        f(n);
+        auto stop = clock::now();
+        return std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+
+    template <typename F>
+    void record(const std::string& name, const std::string& scenario, F f,
+        std::size_t n, std::size_t ops)
+    {
+        double best = time_ms(f, n);
+        for (auto r = 1; r < m_reps; ++r) {
+            best = std::min(best, time_ms(f, n));
+        }
+        m_results.push_back({name, scenario, best * 1e6 / static_cast<double>(ops), ops});
+    }
+};
+
+#endif
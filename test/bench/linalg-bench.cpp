@@ -0,0 +1,573 @@
+//------------------------------------------------------------------------------
+/// Benchmarking the linalg classes. Every operation is timed in three
+/// scenarios and the results are written as JSON:
+///
+///     single  the same operands over and over (latency of one call)
+///     batch   arrays that fit in the L1 cache (throughput)
+///     cold    arrays much larger than the caches (memory bound)
+///
+/// Usage: spear-LinalgBench [--filter text] [--out file] [--min-ms ms]
+///                          [--cold-mb mb]
+///
+
+
+#include "bench.h"
+
+#include <linalg/linalg.h>
+#include <linalg/vector3.h>
+#include <linalg/vector3_soa.h>
+#include <linalg/matrix4.h>
+#include <linalg/cached_matrix4.h>
+#include <scene/transform_tree.h>
+#include <scene/animation.h>
+#include <scene/skinning.h>
+#include <objects/obj_loader.h>
+
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Arrays in the batch scenario (small enough to stay in the L1 cache)
+static const std::size_t hot_count = 128;
+
+
+//------------------------------------------------------------------------------
+/// @brief      A small deterministic generator so runs are comparable
+///
+class lcg
+{
+    std::uint32_t m_state;
+public:
+    lcg(std::uint32_t seed=1) : m_state(seed) {}
+
+    // Return a value in [lo, hi)
+    scalar next(scalar lo=-1, scalar hi=1) {
+        m_state = m_state * 1664525u + 1013904223u;
+        auto unit = static_cast<scalar>(m_state >> 8) / static_cast<scalar>(1u << 24);
+        return lo + (hi - lo) * unit;
+    }
+};
+
+static std::vector<vector3> make_vectors(std::size_t count, lcg& gen)
+{
+    std::vector<vector3> vecs;
+    vecs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        vecs.emplace_back(gen.next(), gen.next(), gen.next(0.1f, 1));
+    }
+    return vecs;
+}
+
+// Invertible transforms (rotation, scale and translation)
+static std::vector<matrix4> make_matrices(std::size_t count, lcg& gen)
+{
+    std::vector<matrix4> mats(count);
+    for (auto& m : mats) {
+        m.rotate(gen.next(-3, 3), vector3(gen.next(), gen.next(), gen.next(0.1f, 1)));
+        m.m_mat[0] *= gen.next(0.5f, 2);
+        m.m_mat[5] *= gen.next(0.5f, 2);
+        m.m_mat[12] = gen.next(-10, 10);
+        m.m_mat[13] = gen.next(-10, 10);
+        m.m_mat[14] = gen.next(-10, 10);
+    }
+    return mats;
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time op(a, b) in the single, batch and cold scenarios. The
+/// result of op is stored, so nothing is optimized away.
+///
+template <typename T, typename Op>
+void bench_op(bench_suite& suite, const std::string& name,
+    const std::vector<T>& a, const std::vector<T>& b, Op op)
+{
+    using result = decltype(op(a[0], b[0]));
+
+    suite.run(name, "single", 1, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            clobber();
+            escape(op(a[0], b[0]));
+        }
+    });
+
+    std::vector<result> hot_out(hot_count);
+    suite.run(name, "batch", hot_count, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < hot_count; ++j) {
+                hot_out[j] = op(a[j], b[j]);
+            }
+            escape(hot_out);
+        }
+    });
+
+    std::vector<result> cold_out(a.size());
+    suite.run_fixed(name, "cold", a.size(), [&] {
+        for (std::size_t j = 0; j < a.size(); ++j) {
+            cold_out[j] = op(a[j], b[j]);
+        }
+        escape(cold_out);
+    });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time a batch kernel f(offset, count) on the hot and cold parts
+/// of the arrays
+///
+template <typename F>
+void bench_kernel(bench_suite& suite, const std::string& name, std::size_t cold_count, F f)
+{
+    suite.run(name, "batch", hot_count, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            f(std::size_t{0}, hot_count);
+            clobber();
+        }
+    });
+    suite.run_fixed(name, "cold", cold_count, [&] {
+        f(std::size_t{0}, cold_count);
+        clobber();
+    });
+}
+
+static void bench_vector3(bench_suite& suite, std::size_t count)
+{
+    lcg gen(3);
+    auto a = make_vectors(count, gen), b = make_vectors(count, gen);
+
+    bench_op(suite, "vector3::add", a, b, [](const vector3& x, const vector3& y) {
+        return x.clone().add(y);
+    });
+    bench_op(suite, "vector3::sub", a, b, [](const vector3& x, const vector3& y) {
+        return x.clone().sub(y);
+    });
+    bench_op(suite, "vector3::scale", a, b, [](const vector3& x, const vector3& y) {
+        return x.clone().scale(y.x());
+    });
+    bench_op(suite, "vector3::normalize", a, b, [](const vector3& x, const vector3&) {
+        return x.clone().normalize();
+    });
+    bench_op(suite, "vector3::normalize/fast", a, b, [](const vector3& x, const vector3&) {
+        return x.clone().normalize(fast_math);
+    });
+    bench_op(suite, "vector3::cross", a, b, [](const vector3& x, const vector3& y) {
+        return x.clone().cross(y);
+    });
+    bench_op(suite, "vector3::lerp", a, b, [](const vector3& x, const vector3& y) {
+        return x.clone().lerp(y, 0.25f);
+    });
+    bench_op(suite, "vector3::len", a, b, [](const vector3& x, const vector3&) {
+        return x.len();
+    });
+    bench_op(suite, "vector3::len/fast", a, b, [](const vector3& x, const vector3&) {
+        return x.len(fast_math);
+    });
+    bench_op(suite, "vector3::len2", a, b, [](const vector3& x, const vector3&) {
+        return x.len2();
+    });
+    bench_op(suite, "vector3::dot", a, b, [](const vector3& x, const vector3& y) {
+        return x.dot(y);
+    });
+    bench_op(suite, "vector3::operator==", a, b, [](const vector3& x, const vector3& y) {
+        return static_cast<int>(x == y);
+    });
+    bench_op(suite, "vector3::expression", a, b, [](const vector3& x, const vector3& y) {
+        return vector3(x + y * 0.5f - x);
+    });
+
+    // The structure of arrays kernels over the same vectors
+    vector3_soa soa_a(a.data(), a.size()), soa_b(b.data(), b.size());
+    vector3_soa hot_a(a.data(), hot_count), hot_b(b.data(), hot_count);
+    std::vector<scalar> out(count);
+
+    // With unit vectors in b the in-place cross products keep their length
+    soa_b.normalize();
+    hot_b.normalize();
+
+    bench_kernel(suite, "vector3_soa::normalize", count, [&](std::size_t, std::size_t n) {
+        (n == hot_count ? hot_a : soa_a).normalize();
+    });
+    bench_kernel(suite, "vector3_soa::cross", count, [&](std::size_t, std::size_t n) {
+        (n == hot_count ? hot_a : soa_a).cross(n == hot_count ? hot_b : soa_b);
+    });
+    bench_kernel(suite, "vector3_soa::dot", count, [&](std::size_t, std::size_t n) {
+        (n == hot_count ? hot_a : soa_a).dot(n == hot_count ? hot_b : soa_b, out.data());
+    });
+}
+
+static void bench_matrix4(bench_suite& suite, std::size_t count)
+{
+    lcg gen(7);
+    auto a = make_matrices(count, gen), b = make_matrices(count, gen);
+
+    bench_op(suite, "matrix4::add", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().add(y);
+    });
+    bench_op(suite, "matrix4::sub", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().sub(y);
+    });
+    bench_op(suite, "matrix4::scale", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().scale(y.m_mat[0]);
+    });
+    bench_op(suite, "matrix4::mul", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().mul(y);
+    });
+    bench_op(suite, "matrix4::operator*", a, b, [](const matrix4& x, const matrix4& y) {
+        return x * y;
+    });
+    bench_op(suite, "matrix4::rotate", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().rotate(y.m_mat[12], vector3(y.m_mat[0], y.m_mat[1], y.m_mat[2]));
+    });
+    bench_op(suite, "matrix4::rotate/fast", a, b, [](const matrix4& x, const matrix4& y) {
+        return x.clone().rotate(y.m_mat[12], vector3(y.m_mat[0], y.m_mat[1], y.m_mat[2]),
+            fast_math);
+    });
+    bench_op(suite, "matrix4::invert", a, b, [](const matrix4& x, const matrix4&) {
+        return x.clone().invert();
+    });
+    bench_op(suite, "matrix4::transpose", a, b, [](const matrix4& x, const matrix4&) {
+        return x.clone().transpose();
+    });
+    bench_op(suite, "matrix4::look_at", a, b, [](const matrix4& x, const matrix4& y) {
+        return matrix4().look_at(vector3(x.m_mat[12], x.m_mat[13], x.m_mat[14]),
+            vector3(y.m_mat[12], y.m_mat[13], y.m_mat[14]), vector3(0, 1, 0));
+    });
+    bench_op(suite, "matrix4::perspective", a, b, [](const matrix4& x, const matrix4&) {
+        return matrix4().perspective(1 + x.m_mat[0] * 0.1f, 1.5f, 0.1f, 100);
+    });
+    bench_op(suite, "matrix4::perspective/fast", a, b, [](const matrix4& x, const matrix4&) {
+        return matrix4().perspective(1 + x.m_mat[0] * 0.1f, 1.5f, 0.1f, 100, fast_math);
+    });
+    bench_op(suite, "matrix4::set_as_normal", a, b, [](const matrix4& x, const matrix4&) {
+        std::array<scalar, 9> normal;
+        x.set_as_normal(normal.data());
+        return normal;
+    });
+    bench_op(suite, "matrix4::operator==", a, b, [](const matrix4& x, const matrix4& y) {
+        return static_cast<int>(x == y);
+    });
+    bench_op(suite, "matrix4::expression", a, b, [](const matrix4& x, const matrix4& y) {
+        return matrix4(x + y * 0.5f - x);
+    });
+
+    // Cached inverses of unchanged transforms (the common case for static
+    // objects) compared with matrix4::invert above
+    std::vector<cached_matrix4> cached(a.begin(), a.end());
+    bench_op(suite, "cached_matrix4::inverse", cached, cached,
+        [](const cached_matrix4& x, const cached_matrix4&) {
+            return x.inverse();
+        });
+
+    // The batch kernels
+    std::vector<matrix4> out(count);
+    bench_kernel(suite, "mul_batch", count, [&](std::size_t first, std::size_t n) {
+        mul_batch(&a[first], &b[first], &out[first], n);
+    });
+    bench_kernel(suite, "mul_batch/naive", count, [&](std::size_t first, std::size_t n) {
+        for (auto i = first; i < first + n; ++i) {
+            out[i] = a[i].clone().mul(b[i]);
+        }
+    });
+}
+
+static void bench_transforms(bench_suite& suite, std::size_t count)
+{
+    lcg gen(11);
+    auto in = make_vectors(count, gen);
+    std::vector<vector3> out(count);
+    auto m = make_matrices(1, gen)[0];
+
+    bench_kernel(suite, "transform_points", count, [&](std::size_t first, std::size_t n) {
+        transform_points(m, &in[first], &out[first], n);
+    });
+    bench_kernel(suite, "transform_points/naive", count, [&](std::size_t first, std::size_t n) {
+        for (auto i = first; i < first + n; ++i) {
+            auto& v = in[i];
+            out[i] = vector3(
+                v.x() * m.m_mat[0] + v.y() * m.m_mat[4] + v.z() * m.m_mat[8] + m.m_mat[12],
+                v.x() * m.m_mat[1] + v.y() * m.m_mat[5] + v.z() * m.m_mat[9] + m.m_mat[13],
+                v.x() * m.m_mat[2] + v.y() * m.m_mat[6] + v.z() * m.m_mat[10] + m.m_mat[14]);
+        }
+    });
+    bench_kernel(suite, "transform_directions", count, [&](std::size_t first, std::size_t n) {
+        transform_directions(m, &in[first], &out[first], n);
+    });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time transform_tree::update on a tree of count nodes (eight
+/// children per node) when 2% of the nodes change, and when every node does
+///
+static void bench_hierarchy(bench_suite& suite, std::size_t count)
+{
+    lcg gen(17);
+    auto locals = make_matrices(count, gen);
+    transform_tree tree;
+    tree.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        tree.add(i == 0 ? no_parent : static_cast<node_id>((i - 1) / 8), locals[i]);
+    }
+    tree.update();
+
+    std::vector<node_id> changed(count / 50);
+    for (auto& node : changed) {
+        node = static_cast<node_id>(gen.next(0, static_cast<scalar>(count - 1)));
+    }
+
+    suite.run_fixed("transform_tree::update", "sparse", count, [&] {
+        for (auto node : changed) {
+            tree.set_local(node, locals[node]);
+        }
+        escape(tree.update());
+    });
+    suite.run_fixed("transform_tree::update", "full", count, [&] {
+        tree.set_local(0, locals[0]);
+        escape(tree.update());
+    });
+    suite.run_fixed("transform_tree::update/naive", "full", count, [&] {
+        auto& world = tree.m_world;
+        world[0] = tree.m_local[0];
+        for (std::size_t j = 1; j < count; ++j) {
+            world[j] = tree.m_local[j] * world[tree.m_parent[j]];
+        }
+        escape(world);
+    });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time sampling a clip of count tracks (all channels animated,
+/// two seconds at 30 keys per second) into a pose and into a tree
+///
+static void bench_animation(bench_suite& suite, std::size_t count)
+{
+    lcg gen(23);
+    std::vector<animation_track> tracks(count);
+    transform_tree tree;
+    for (std::size_t i = 0; i < count; ++i) {
+        tracks[i].m_node = tree.add(i == 0 ? no_parent : static_cast<node_id>((i - 1) / 8));
+        auto axis = vector3(gen.next(), gen.next(), gen.next(0.1f, 1));
+        auto speed = gen.next(-3, 3);
+        for (auto f = 0; f <= 60; ++f) {
+            auto t = static_cast<scalar>(f) / 30;
+            tracks[i].m_keys.emplace_back(quat().axis_angle(speed * t, axis),
+                vector3(gen.next(), gen.next(), gen.next()), 1 + t * gen.next(0, 0.1f));
+        }
+    }
+    animation_clip clip(30, tracks);
+
+    std::vector<trs> pose(count);
+    scalar time = 0;
+    suite.run("animation_clip::sample", "batch", count, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            time = time < 2 ? time + 0.01f : 0;
+            clip.sample(time, pose.data());
+            escape(pose);
+        }
+    });
+    suite.run("animation_clip::apply", "batch", count, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            time = time < 2 ? time + 0.01f : 0;
+            clip.apply(time, pose, tree);
+            escape(tree.update());
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time skinning meshes of count vertices (four influences each)
+/// with a 64 joint palette, one mesh on the calling thread and sixteen meshes
+/// split across threads. ns_per_op is per vertex.
+///
+static void bench_skinning(bench_suite& suite, std::size_t count)
+{
+    lcg gen(29);
+    auto palette = make_matrices(64, gen);
+    skin mesh;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto w = gen.next(0, 1);
+        skin_weights weights{{{
+            static_cast<std::uint8_t>(i % 64), static_cast<std::uint8_t>((i * 7) % 64),
+            static_cast<std::uint8_t>((i * 13) % 64), static_cast<std::uint8_t>((i * 31) % 64)
+        }}, {{w * 0.5f, w * 0.5f, (1 - w) * 0.5f, (1 - w) * 0.5f}}};
+        mesh.add(vector3(gen.next(), gen.next(), gen.next()),
+            vector3(gen.next(), gen.next(), gen.next(0.1f, 1)), weights);
+    }
+
+    std::vector<skinned_vertex> out(16 * count);
+    suite.run_fixed("skin_vertices", "batch", count, [&] {
+        skin_vertices(mesh, palette.data(), out.data(), 0, count);
+        escape(out);
+    });
+    suite.run_fixed("skin_vertices/naive", "batch", count, [&] {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& w = mesh.m_weights[i];
+            matrix4 blend = palette[w.m_joints[0]] * w.m_weights[0]
+                + palette[w.m_joints[1]] * w.m_weights[1]
+                + palette[w.m_joints[2]] * w.m_weights[2]
+                + palette[w.m_joints[3]] * w.m_weights[3];
+            out[i].m_pos = blend.transform_point(mesh.m_positions[i]);
+            out[i].m_normal = blend.transform_vector(mesh.m_normals[i]).normalize();
+        }
+        escape(out);
+    });
+
+    std::vector<skin_job> jobs;
+    for (std::size_t i = 0; i < 16; ++i) {
+        jobs.push_back({&mesh, palette.data(), out.data() + i * count});
+    }
+    suite.run_fixed("skin_meshes", "batch", jobs.size() * count, [&] {
+        skin_meshes(jobs.data(), jobs.size());
+        escape(out);
+    });
+}
+
+//------------------------------------------------------------------------------
+/// @brief      Time parsing OBJ text of about count vertices (in the format
+/// Blender writes, with quads). ns_per_op is per byte.
+///
+static void bench_obj(bench_suite& suite, std::size_t count)
+{
+    lcg gen(31);
+    std::string text;
+    char line[96];
+    for (std::size_t i = 0; i < count; ++i) {
+        std::snprintf(line, sizeof(line), "v %f %f %f\nvt %.4f %.4f\nvn %.4f %.4f %.4f\n",
+            double(gen.next(-10, 10)), double(gen.next(-10, 10)), double(gen.next(-10, 10)),
+            double(gen.next(0, 1)), double(gen.next(0, 1)),
+            double(gen.next()), double(gen.next()), double(gen.next()));
+        text += line;
+        if (i >= 3) {
+            auto k = i + 1;
+            std::snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                k - 3, k - 3, k - 3, k - 2, k - 2, k - 2, k - 1, k - 1, k - 1, k, k, k);
+            text += line;
+        }
+    }
+
+    obj_data data;
+    suite.run_fixed("parse_obj", "cold", text.size(), [&] {
+        escape(parse_obj(text.data(), text.data() + text.size(), data));
+    });
+}
+
+static void bench_scalar(bench_suite& suite, std::size_t count)
+{
+    lcg gen(13);
+    std::vector<scalar> a(count), b(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        a[i] = gen.next(-100, 100);
+        b[i] = (i % 2 == 0) ? a[i] * (1 + 1e-7f) : gen.next(-100, 100);
+    }
+
+    bench_op(suite, "nearly_equal", a, b, [](scalar x, scalar y) {
+        return static_cast<int>(nearly_equal(x, y));
+    });
+}
+
+// Parse a number of milliseconds (finite and not negative)
+static bool parse_ms(const char* text, double& ms)
+{
+    char* end = nullptr;
+    auto value = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(value) || value < 0) {
+        return false;
+    }
+    ms = value;
+    return true;
+}
+
+// Parse a number of megabytes that still fits in a size_t as bytes
+static bool parse_mb(const char* text, std::size_t& mb)
+{
+    // strtoull skips spaces and negates a leading '-', so require a digit
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    auto value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value > (std::numeric_limits<std::size_t>::max() >> 20)) {
+        return false;
+    }
+    mb = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter, out_path;
+    double min_ms = 20;
+    std::size_t cold_mb = 64;
+
+    for (auto i = 1; i < argc; i += 2) {
+        auto option = argv[i];
+        auto is = [&](const char* name) { return std::strcmp(option, name) == 0; };
+        if (!is("--filter") && !is("--out") && !is("--min-ms") && !is("--cold-mb")) {
+            std::cerr << "Unknown option: " << option << "\n";
+            return EXIT_FAILURE;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for option: " << option << "\n";
+            return EXIT_FAILURE;
+        }
+
+        auto value = argv[i + 1];
+        auto valid = true;
+        if (is("--filter")) {
+            filter = value;
+        }
+        else if (is("--out")) {
+            out_path = value;
+        }
+        else if (is("--min-ms")) {
+            valid = parse_ms(value, min_ms);
+        }
+        else {
+            valid = parse_mb(value, cold_mb);
+        }
+        if (!valid) {
+            std::cerr << "Invalid value for option " << option << ": " << value << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Open the output first, so a bad path fails before the benchmarks run
+    std::ofstream out;
+    if (!out_path.empty()) {
+        out.open(out_path);
+        if (!out) {
+            std::cerr << "Cannot open output file: " << out_path << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Size the cold arrays by their total footprint (inputs and outputs)
+    auto cold_bytes = cold_mb << 20;
+    bench_suite suite(filter, min_ms);
+    bench_vector3(suite, std::max(hot_count, cold_bytes / (3 * sizeof(vector3))));
+    bench_matrix4(suite, std::max(hot_count, cold_bytes / (3 * sizeof(matrix4))));
+    bench_transforms(suite, std::max(hot_count, cold_bytes / (2 * sizeof(vector3))));
+    bench_scalar(suite, std::max(hot_count, cold_bytes / (3 * sizeof(scalar))));
+    bench_hierarchy(suite, 100000);
+    bench_animation(suite, 1000);
+    bench_skinning(suite, 8192);
+    bench_obj(suite, 100000);
+
+    if (out_path.empty()) {
+        suite.write_json(std::cout);
+    }
+    else {
+        suite.write_json(out);
+        if (!out) {
+            std::cerr << "Cannot write output file: " << out_path << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+}
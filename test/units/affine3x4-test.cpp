@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/// Testing the affine3x4 class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/affine3x4.h>
+
+SCENARIO ( "The affine3x4 class can be used for affine transforms", "[linalg][affine3x4]" ) {
+
+    GIVEN ( "A default constructed affine3x4" ) {
+        affine3x4 a;
+
+        WHEN ( "It is converted to a matrix4" ) {
+            auto m = a.to_matrix4();
+
+            THEN ( "The matrix is the identity matrix" ) {
+                CHECK ( m == matrix4() );
+            }
+        }
+    }
+
+    GIVEN ( "An affine matrix4 (rotation, scale and translation)" ) {
+        matrix4 m;
+        m.rotate(0.3f, vector3(1, 2, 3));
+        m.m_mat[0] *= 2;
+        m.m_mat[5] *= 0.5f;
+        m.m_mat[12] = 4;
+        m.m_mat[13] = -5;
+        m.m_mat[14] = 6;
+
+        WHEN ( "It is converted to an affine3x4 and back" ) {
+            affine3x4 a(m);
+
+            THEN ( "The values are unchanged" ) {
+                CHECK ( a.to_matrix4() == m );
+                CHECK ( a.translation() == vector3(4, -5, 6) );
+            }
+        }
+
+        AND_WHEN ( "The 'invert' method is called" ) {
+            affine3x4 a(m);
+            a.invert();
+
+            THEN ( "The transform matches the inverted matrix4" ) {
+                auto m_inv = m.clone().invert();
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( a.to_matrix4().m_mat[i] == Approx( m_inv.m_mat[i] ).margin(1e-6) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "Two affine transforms" ) {
+        matrix4 m1, m2;
+        m1.rotate(0.7f, vector3(0, 1, 1));
+        m1.m_mat[12] = 1;
+        m1.m_mat[13] = 2;
+        m1.m_mat[14] = 3;
+        m2.rotate(-1.1f, vector3(1, 0, 1)).scale(2);
+        m2.m_mat[15] = 1;
+        m2.m_mat[14] = -7;
+
+        affine3x4 a1(m1), a2(m2);
+
+        WHEN ( "They are multiplied" ) {
+            auto a3 = a1 * a2;
+            affine3x4 a4(a1);
+            a4 *= a2;
+
+            THEN ( "The product matches the matrix4 product" ) {
+                CHECK ( a3.to_matrix4() == m1 * m2 );
+                CHECK ( a4 == a3 );
+            }
+        }
+
+        AND_WHEN ( "A transform is multiplied by itself" ) {
+            auto squared = a2 * a2;
+            a2.mul(a2);
+
+            THEN ( "The result matches the product of two copies" ) {
+                CHECK ( a2 == squared );
+            }
+        }
+
+        AND_WHEN ( "Points and directions are transformed" ) {
+            vector3 p(0.5f, -2, 3);
+            auto tp = a1.transform_point(p);
+            auto tv = a1.transform_vector(p);
+
+            // Transform p as the row vector [p 1] (or [p 0]) times the matrix4
+            auto row_times = [&](scalar w, unsigned c) {
+                return p.x() * m1.m_mat[c] + p.y() * m1.m_mat[4 + c]
+                     + p.z() * m1.m_mat[8 + c] + w * m1.m_mat[12 + c];
+            };
+
+            THEN ( "The results match the matrix4 product" ) {
+                CHECK ( tp == vector3(row_times(1, 0), row_times(1, 1), row_times(1, 2)) );
+                CHECK ( tv == vector3(row_times(0, 0), row_times(0, 1), row_times(0, 2)) );
+            }
+        }
+
+        AND_WHEN ( "The rigid transform is inverted with 'invert_rigid'" ) {
+            auto a_inv = a1.clone().invert_rigid();
+
+            THEN ( "It matches the general inverse and undoes the transform" ) {
+                auto a_gen = a1.clone().invert();
+                for (auto i = 0u; i < 12; ++i) {
+                    CHECK ( a_inv.m_aff[i] == Approx( a_gen.m_aff[i] ).margin(1e-6) );
+                    CHECK ( (a1 * a_inv).m_aff[i] == Approx( affine3x4().m_aff[i] ).margin(1e-6) );
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/// Testing the animation_clip class
+///
+
+
+#include <catch.hpp>
+
+#include <scene/animation.h>
+
+#include <algorithm>
+#include <cmath>
+
+// Check two rotations (q and -q are the same rotation)
+static void check_rotation(const quat& actual, const quat& expected, double margin) {
+    auto sign = actual.dot(expected) < 0 ? -1.0 : 1.0;
+    for (auto i = 0u; i < 4; ++i) {
+        CHECK ( actual.m_quat[i] * sign == Approx( expected.m_quat[i] ).margin(margin) );
+    }
+}
+
+SCENARIO ( "The animation_clip class compresses and samples keyframes", "[scene][animation]" ) {
+
+    GIVEN ( "A spinning, moving and growing track and a static track" ) {
+        const std::uint32_t frames = 31;
+        animation_track moving{0, {}}, fixed{1, {}};
+        for (auto f = 0u; f < frames; ++f) {
+            auto t = static_cast<scalar>(f) / 10;
+            moving.m_keys.emplace_back(quat().axis_angle(t * 2, vector3(1, 2, 3)),
+                vector3(t, -2 * t, 5), 1 + t);
+            fixed.m_keys.emplace_back(quat().axis_angle(0.5f, vector3(0, 1, 0)),
+                vector3(1, 2, 3), 2);
+        }
+        animation_clip clip(10, {moving, fixed});
+
+        THEN ( "Only the changing channels are stored as keys" ) {
+            CHECK ( clip.track_count() == 2 );
+            CHECK ( clip.frame_count() == frames );
+            CHECK ( clip.duration() == Approx( 3 ) );
+            CHECK ( clip.m_rot.m_tracks.size() == 1 );
+            CHECK ( clip.m_pos.m_tracks.size() == 1 );
+            CHECK ( clip.m_scale.m_tracks.size() == 1 );
+            CHECK ( clip.m_rot.m_const_tracks.size() == 1 );
+            CHECK ( clip.m_pos.m_const_tracks.size() == 1 );
+            CHECK ( clip.m_scale.m_const_tracks.size() == 1 );
+            CHECK ( clip.m_rot.m_keys.size() == frames );
+            CHECK ( clip.memory_size() < 2 * frames * sizeof(trs) / 3 );
+        }
+
+        WHEN ( "The clip is sampled at the keys" ) {
+            std::vector<trs> pose(2);
+
+            THEN ( "The keys are recovered within the quantization error" ) {
+                for (auto f = 0u; f < frames; ++f) {
+                    clip.sample(static_cast<scalar>(f) / 10, pose.data());
+                    auto& key = moving.m_keys[f];
+                    check_rotation(pose[0].m_rot, key.m_rot, 7e-5);
+                    CHECK ( pose[0].m_pos.x() == Approx( key.m_pos.x() ).margin(1e-4) );
+                    CHECK ( pose[0].m_pos.y() == Approx( key.m_pos.y() ).margin(1e-4) );
+                    CHECK ( pose[0].m_pos.z() == Approx( key.m_pos.z() ).margin(1e-4) );
+                    CHECK ( pose[0].m_scale == Approx( key.m_scale ).margin(1e-4) );
+                    CHECK ( pose[1] == fixed.m_keys[f] );
+                }
+            }
+        }
+
+        WHEN ( "The clip is sampled between two keys" ) {
+            std::vector<trs> pose(2);
+            clip.sample(0.55f, pose.data());
+            auto expected = moving.m_keys[5].clone().lerp(moving.m_keys[6], 0.5f);
+
+            THEN ( "The keys are interpolated" ) {
+                check_rotation(pose[0].m_rot, expected.m_rot, 1e-4);
+                CHECK ( pose[0].m_pos.x() == Approx( 0.55 ).margin(1e-4) );
+                CHECK ( pose[0].m_scale == Approx( 1.55 ).margin(1e-4) );
+            }
+        }
+
+        WHEN ( "The clip is sampled outside of its duration" ) {
+            std::vector<trs> before(2), after(2);
+            clip.sample(-1, before.data());
+            clip.sample(100, after.data());
+
+            THEN ( "The time is clamped" ) {
+                CHECK ( before[0].m_pos.y() == Approx( 0 ).margin(1e-4) );
+                CHECK ( after[0].m_pos.y() == Approx( -6 ).margin(1e-4) );
+            }
+        }
+
+        WHEN ( "The clip is applied to a transform tree" ) {
+            transform_tree tree;
+            tree.add(no_parent);
+            tree.add(0);
+            tree.update();
+
+            std::vector<trs> pose;
+            clip.apply(1, pose, tree);
+            tree.update();
+
+            THEN ( "The local transforms of the nodes are set" ) {
+                CHECK ( tree.local(0) == pose[0].to_matrix4() );
+                CHECK ( tree.world(1) == pose[1].to_matrix4() * pose[0].to_matrix4() );
+            }
+        }
+    }
+
+    GIVEN ( "A track whose rotation components are all near 0.5" ) {
+        const std::uint32_t frames = 256;
+        animation_track track{0, {}};
+        for (auto f = 0u; f < frames; ++f) {
+            auto t = static_cast<scalar>(f) / frames;
+            auto q = quat(0.5f + 0.02f * t, 0.5f - 0.01f * t, 0.5f + 0.005f * std::sin(7 * t), 0.5f);
+            track.m_keys.emplace_back(q.normalize(), vector3(), 1);
+        }
+        animation_clip clip(10, {track});
+
+        WHEN ( "The clip is sampled at the keys" ) {
+            std::vector<trs> pose(1);
+            double worst = 0;
+            for (auto f = 0u; f < frames; ++f) {
+                clip.sample(static_cast<scalar>(f) / 10, pose.data());
+                auto& expected = track.m_keys[f].m_rot;
+                auto sign = pose[0].m_rot.dot(expected) < 0 ? -1.0 : 1.0;
+                for (auto i = 0u; i < 4; ++i) {
+                    worst = std::max(worst, std::abs(pose[0].m_rot.m_quat[i] * sign - expected.m_quat[i]));
+                }
+            }
+
+            THEN ( "The rebuilt component stays within the documented bound" ) {
+                CHECK ( worst > 3e-5 );
+                CHECK ( worst < 7e-5 );
+            }
+        }
+    }
+
+    GIVEN ( "Tracks with different numbers of keys" ) {
+        animation_track full{0, {}}, missing{1, {}};
+        full.m_keys.resize(4);
+        missing.m_keys.resize(2);
+        animation_clip clip(10, {full, missing});
+
+        THEN ( "The clip is empty" ) {
+            CHECK ( clip.frame_count() == 0 );
+            CHECK ( clip.track_count() == 0 );
+        }
+    }
+}
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/// Testing the cached_matrix4 class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/cached_matrix4.h>
+
+SCENARIO ( "The cached_matrix4 class caches the inverse and normal matrix", "[linalg][cached_matrix4]" ) {
+
+    GIVEN ( "A cached singular transform" ) {
+        matrix4 m;
+        m.m_mat[1] = 2;
+        m.m_mat[5] = 0;
+        m.m_mat[12] = 4;
+        cached_matrix4 c(m);
+
+        WHEN ( "The normal matrix is requested" ) {
+            auto normal = c.normal();
+            scalar expected_normal[9] = {9, 9, 9, 9, 9, 9, 9, 9, 9};
+            m.set_as_normal(expected_normal);
+
+            THEN ( "It matches matrix4::set_as_normal (the transposed upper 3x3)" ) {
+                for (auto i = 0u; i < 9; ++i) {
+                    CHECK ( normal[i] == Approx( expected_normal[i] ) );
+                    CHECK ( normal[i] == Approx( m.m_mat[4 * (i % 3) + i / 3] ) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A cached transform with rotation, scale and translation" ) {
+        matrix4 m;
+        m.rotate(0.6f, vector3(1, 2, -1));
+        m.m_mat[0] *= 2;
+        m.m_mat[12] = 3;
+        m.m_mat[13] = -1;
+        cached_matrix4 c(m);
+
+        WHEN ( "The inverse and normal matrix are requested" ) {
+            auto inv = c.inverse();
+            auto normal = c.normal();
+
+            scalar expected_normal[9];
+            m.set_as_normal(expected_normal);
+
+            THEN ( "They match matrix4::invert and matrix4::set_as_normal" ) {
+                CHECK ( inv == m.clone().invert() );
+                for (auto i = 0u; i < 9; ++i) {
+                    CHECK ( normal[i] == Approx( expected_normal[i] ).margin(1e-6) );
+                }
+            }
+
+            THEN ( "Only the first request is a miss" ) {
+                CHECK ( c.stats().m_misses == 1 );
+                CHECK ( c.stats().m_hits == 1 );
+                CHECK ( c.stats().hit_rate() == Approx( 0.5 ) );
+            }
+        }
+
+        WHEN ( "The transform is changed after a request" ) {
+            c.inverse();
+            c.rotate(0.2f, vector3(0, 1, 0));
+            auto inv = c.inverse();
+            c.inverse();
+
+            THEN ( "The inverse is recomputed once" ) {
+                CHECK ( inv == c.matrix().clone().invert() );
+                CHECK ( c.stats().m_misses == 2 );
+                CHECK ( c.stats().m_hits == 1 );
+            }
+        }
+
+        WHEN ( "The counts are reset" ) {
+            c.inverse();
+            c.reset_stats();
+
+            THEN ( "The next request is a hit" ) {
+                c.normal();
+                CHECK ( c.stats().m_misses == 0 );
+                CHECK ( c.stats().m_hits == 1 );
+                CHECK ( c.stats().hit_rate() == Approx( 1 ) );
+            }
+        }
+    }
+
+    GIVEN ( "A default constructed cached transform" ) {
+        cached_matrix4 c;
+
+        THEN ( "The inverse is the identity without any computation" ) {
+            CHECK ( c.inverse() == matrix4() );
+            CHECK ( c.stats().m_misses == 0 );
+        }
+    }
+}
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/// Testing the compile-time linalg functions
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/cx.h>
+
+#include <cmath>
+
+SCENARIO ( "The cx functions can be evaluated at compile time", "[linalg][cx]" ) {
+
+    GIVEN ( "Values in the domain of the math functions" ) {
+        double vals[] = {0, 1e-6, 0.5, 1, 2, 3.14159, 10, 1234.5, -7.25};
+
+        WHEN ( "The constexpr sqrt, sin, cos and tan are called" ) {
+
+            THEN ( "They agree with the standard library" ) {
+                for (auto v : vals) {
+                    auto a = std::abs(v);
+                    CHECK ( cx::sqrt(a) == Approx( std::sqrt(a) ).epsilon(1e-12) );
+                    CHECK ( cx::sin(v) == Approx( std::sin(v) ).margin(1e-12) );
+                    CHECK ( cx::cos(v) == Approx( std::cos(v) ).margin(1e-12) );
+                    CHECK ( cx::tan(v) == Approx( std::tan(v) ).margin(1e-9) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "Constant vector3 values" ) {
+        constexpr vector3 a(1, 2, 3);
+        constexpr vector3 b(4, -5, 6);
+
+        WHEN ( "Vector expressions are evaluated at compile time" ) {
+            constexpr vector3 sum = a + b * 2.0f - a;
+            constexpr auto dot = cx::dot(a, b);
+            constexpr auto cross = cx::cross(a, b);
+            constexpr auto unit = cx::normalize(b);
+
+            THEN ( "The results match the runtime methods" ) {
+                CHECK ( sum == vector3(8, -10, 12) );
+                CHECK ( dot == Approx( a.clone().dot(b) ) );
+                CHECK ( cross == a.clone().cross(b) );
+                CHECK ( unit == b.clone().normalize() );
+            }
+        }
+    }
+
+    GIVEN ( "Constant matrix4 values" ) {
+        constexpr matrix4 m1(mat_array({{1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6}}));
+        constexpr matrix4 m2(mat_array({{1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2}}));
+
+        WHEN ( "Matrices are built at compile time" ) {
+            constexpr auto id = cx::id();
+            constexpr auto prod = cx::mul(m1, m2);
+            constexpr auto trans = cx::transpose(m1);
+            constexpr auto rot = cx::rotate(m1, 0.7f, vector3(1, 2, -1));
+            constexpr auto view = cx::look_at({1, 2, 3}, {-1, -1, -1}, {0, 0.5, 1});
+            constexpr auto proj = cx::perspective(static_cast<scalar>(cx::pi / 3), 1.5f, 0.1f, 100);
+
+            THEN ( "The results match the runtime methods" ) {
+                auto view_rt = matrix4().look_at({1, 2, 3}, {-1, -1, -1}, {0, 0.5, 1});
+                auto proj_rt = matrix4().perspective(static_cast<scalar>(M_PI / 3), 1.5f, 0.1f, 100);
+                auto rot_rt = m1.clone().rotate(0.7f, vector3(1, 2, -1));
+
+                CHECK ( id == matrix4() );
+                CHECK ( prod == m1.clone().mul(m2) );
+                CHECK ( trans == m1.clone().transpose() );
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( rot.m_mat[i] == Approx( rot_rt.m_mat[i] ).margin(1e-5) );
+                    CHECK ( view.m_mat[i] == Approx( view_rt.m_mat[i] ).margin(1e-6) );
+                    CHECK ( proj.m_mat[i] == Approx( proj_rt.m_mat[i] ).margin(1e-6) );
+                }
+            }
+        }
+    }
+
+}
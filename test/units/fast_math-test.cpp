@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/// Testing the approximate math functions and methods
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/fast_math.h>
+#include <linalg/vector3.h>
+#include <linalg/matrix4.h>
+
+#include <cmath>
+#include <cstring>
+
+SCENARIO ( "The fast math functions stay within their documented error", "[linalg][fast_math]" ) {
+
+    GIVEN ( "Positive floats across the whole normal range" ) {
+        WHEN ( "'fast_rsqrt' is called" ) {
+            auto worst = 0.0;
+            for (std::uint32_t bits = 0x00800000u; bits < 0x7f800000u; bits += 4099) {
+                float x;
+                std::memcpy(&x, &bits, sizeof(x));
+                auto exact = 1 / std::sqrt(static_cast<double>(x));
+                worst = std::fmax(worst, std::fabs(fast_rsqrt(x) / exact - 1));
+            }
+
+            THEN ( "The relative error is bounded" ) {
+#if defined(LINALG_SIMD_SSE)
+                CHECK ( worst < 5e-7 );
+#else
+                CHECK ( worst < 5e-6 );
+#endif
+            }
+        }
+    }
+
+    GIVEN ( "Angles up to 8192 radians" ) {
+        WHEN ( "'fast_sincos' and 'fast_tan' are called" ) {
+            auto worst_sin = 0.0, worst_cos = 0.0, worst_tan = 0.0;
+            for (auto i = -400000; i <= 400000; ++i) {
+                auto x = static_cast<float>(i) * 0.0204799f;
+                float s, c;
+                fast_sincos(x, s, c);
+                worst_sin = std::fmax(worst_sin, std::fabs(s - std::sin(static_cast<double>(x))));
+                worst_cos = std::fmax(worst_cos, std::fabs(c - std::cos(static_cast<double>(x))));
+            }
+            for (auto i = -15000; i <= 15000; ++i) {
+                auto x = static_cast<float>(i) * 0.0001f;
+                auto exact = std::tan(static_cast<double>(x));
+                if (i != 0) {
+                    worst_tan = std::fmax(worst_tan, std::fabs(fast_tan(x) / exact - 1));
+                }
+            }
+
+            THEN ( "The errors are bounded" ) {
+                CHECK ( worst_sin < 2e-7 );
+                CHECK ( worst_cos < 2e-7 );
+                CHECK ( worst_tan < 1e-6 );
+            }
+        }
+
+        AND_WHEN ( "The quadrant boundaries are used" ) {
+            float s, c;
+            fast_sincos(0, s, c);
+
+            THEN ( "Sine and cosine are exact at zero" ) {
+                CHECK ( s == Approx( 0 ) );
+                CHECK ( c == Approx( 1 ) );
+            }
+        }
+    }
+
+    GIVEN ( "Angles past 8192 radians and NaN" ) {
+        WHEN ( "'fast_sincos' is called" ) {
+            auto worst = 0.0;
+            for (auto x : {8192.5f, -1e5f, 3.5e9f, -1e30f}) {
+                float s, c;
+                fast_sincos(x, s, c);
+                worst = std::fmax(worst, std::fabs(s - std::sin(static_cast<double>(x))));
+                worst = std::fmax(worst, std::fabs(c - std::cos(static_cast<double>(x))));
+            }
+            float nan_s, nan_c;
+            fast_sincos(std::nanf(""), nan_s, nan_c);
+
+            THEN ( "The error is still bounded and NaN stays NaN" ) {
+                CHECK ( worst < 2e-7 );
+                CHECK ( std::isnan(nan_s) );
+                CHECK ( std::isnan(nan_c) );
+            }
+        }
+    }
+
+    GIVEN ( "A vector3 and a matrix4" ) {
+        vector3 v(3, -4, 12);
+        vector3 axis(1, 2, -2);
+        matrix4 m;
+        m.m_mat[12] = 4;
+
+        THEN ( "The fast_math methods match the exact methods" ) {
+            CHECK ( v.len(fast_math) == Approx( 13 ) );
+            CHECK ( v.clone().normalize(fast_math) == v.clone().normalize() );
+            CHECK ( vector3().normalize(fast_math) == vector3() );
+            CHECK ( vector3().len(fast_math) == Approx( 0 ) );
+
+            auto fast = m.clone().rotate(2.5f, axis, fast_math),
+                 exact = m.clone().rotate(2.5f, axis);
+            // (the axis is normalized with fast_rsqrt, and its error is doubled
+            // in the products of the axis values)
+            for (auto i = 0u; i < 16; ++i) {
+                CHECK ( fast.m_mat[i] == Approx( exact.m_mat[i] ).margin( 2e-5 ) );
+            }
+
+            fast = matrix4().perspective(1.1f, 1.5f, 0.1f, 100, fast_math);
+            exact = matrix4().perspective(1.1f, 1.5f, 0.1f, 100);
+            CHECK ( fast == exact );
+        }
+
+        AND_THEN ( "The double versions are exact" ) {
+            vector3d vd(3, -4, 12);
+            CHECK ( vd.len(fast_math) == Approx( 13 ).epsilon( 1e-15 ) );
+            CHECK ( matrix4d().rotate(0.3, vector3d(0, 0, 1), fast_math).m_mat[0]
+                == Approx( std::cos(0.3) ).epsilon( 1e-15 ) );
+        }
+    }
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/// Testing the frustum class
+///
+
+
+#include <catch.hpp>
+
+#include <scene/frustum.h>
+
+#include <cstdint>
+#include <vector>
+
+SCENARIO ( "The frustum class can be used to cull objects", "[scene][frustum]" ) {
+
+    GIVEN ( "A frustum from a camera at (0, 0, 5) looking at the origin" ) {
+        matrix4 view, proj;
+        view.look_at(vector3(0, 0, 5), vector3(0, 0, 0), vector3(0, 1, 0));
+        proj.perspective(1.0f, 1.0f, 0.1f, 100);
+
+        // look_at points +z at the target while perspective looks down -z
+        matrix4 flip_z(mat_array{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1}});
+        frustum f(view.clone().mul(flip_z).mul(proj));
+
+        THEN ( "Spheres in front of the camera are visible" ) {
+            CHECK ( f.test_sphere(vector3(0, 0, 0), 1) );
+            CHECK ( f.test_sphere(vector3(1, -1, -20), 0.5f) );
+        }
+
+        THEN ( "Spheres behind, beside and beyond the camera are not visible" ) {
+            CHECK_FALSE ( f.test_sphere(vector3(0, 0, 10), 1) );
+            CHECK_FALSE ( f.test_sphere(vector3(100, 0, 0), 1) );
+            CHECK_FALSE ( f.test_sphere(vector3(0, -100, 0), 1) );
+            CHECK_FALSE ( f.test_sphere(vector3(0, 0, -200), 1) );
+        }
+
+        THEN ( "Spheres and boxes that cross a plane are visible" ) {
+            CHECK ( f.test_sphere(vector3(0, 0, 5.5f), 1) );
+            CHECK ( f.test_box(vector3(10, 0, 0), vector3(9, 1, 1)) );
+            CHECK_FALSE ( f.test_box(vector3(10, 0, 0), vector3(1, 1, 1)) );
+        }
+
+        WHEN ( "A batch of objects is culled" ) {
+            // Not a multiple of four so the scalar tail is used too
+            const std::size_t count = 103;
+            vector3_soa centers(count), extents(count);
+            std::vector<scalar> radii(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto t = static_cast<scalar>(i);
+                centers.set(i, vector3(t * 0.7f - 30, (t - 50) * 0.3f, 6 - t));
+                extents.set(i, vector3(0.5f, 1, 0.25f * static_cast<scalar>(i % 5)));
+                radii[i] = 0.1f * static_cast<scalar>(i % 7);
+            }
+
+            std::vector<std::uint32_t> spheres(count), boxes(count);
+            auto num_spheres = f.cull_spheres(centers, radii.data(), spheres.data());
+            auto num_boxes = f.cull_boxes(centers, extents, boxes.data());
+
+            THEN ( "The visible indices match the single object tests" ) {
+                std::vector<std::uint32_t> expected_spheres, expected_boxes;
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    if (f.test_sphere(centers.get(i), radii[i])) {
+                        expected_spheres.push_back(i);
+                    }
+                    if (f.test_box(centers.get(i), extents.get(i))) {
+                        expected_boxes.push_back(i);
+                    }
+                }
+
+                REQUIRE ( num_spheres > 0 );
+                REQUIRE ( num_spheres < count );
+                spheres.resize(num_spheres);
+                boxes.resize(num_boxes);
+                CHECK ( spheres == expected_spheres );
+                CHECK ( boxes == expected_boxes );
+            }
+        }
+    }
+}
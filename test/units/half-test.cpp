@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/// Testing the half and vector3h classes
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/half.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+SCENARIO ( "Floats are stored as half floats", "[linalg][half]" ) {
+
+    GIVEN ( "Values that are exact halves" ) {
+        std::vector<float> values = {0, 1, -2, 0.5f, 65504, -0.000061035156f, 5.9604645e-8f};
+
+        THEN ( "They convert back unchanged" ) {
+            for (auto v : values) {
+                CHECK ( s_equal(half(v).to_float(), v) );
+            }
+            CHECK ( half(1).m_bits == 0x3c00 );
+            CHECK ( half(-2).m_bits == 0xc000 );
+            CHECK ( half(5.9604645e-8f).m_bits == 0x0001 );
+        }
+    }
+
+    GIVEN ( "Values between two halves" ) {
+        THEN ( "They round to the nearest half (ties to even)" ) {
+            CHECK ( half(1 + 1.0f / 2048).m_bits == 0x3c00 );
+            CHECK ( half(1 + 3.0f / 2048).m_bits == 0x3c02 );
+            CHECK ( half(1 + 1.5f / 2048).m_bits == 0x3c01 );
+            CHECK ( half(65519).m_bits == 0x7bff );
+            CHECK ( half(2.9802322e-8f).m_bits == 0x0000 );
+            CHECK ( half(4.5e-8f).m_bits == 0x0001 );
+        }
+    }
+
+    GIVEN ( "Values outside the range of a half" ) {
+        auto inf = std::numeric_limits<float>::infinity();
+
+        THEN ( "They become infinities, zeros and NaNs" ) {
+            CHECK ( half(65520).m_bits == 0x7c00 );
+            CHECK ( half(-1e10f).m_bits == 0xfc00 );
+            CHECK ( half(inf).to_float() > 65504 );
+            CHECK ( half(1e-10f).to_float() == Approx( 0 ) );
+            CHECK ( std::isnan(half(std::nanf("")).to_float()) );
+        }
+    }
+
+    GIVEN ( "Arrays of floats and vectors" ) {
+        std::vector<float> values;
+        for (auto i = 0; i < 23; ++i) {
+            values.push_back(static_cast<float>(i) * 0.37f - 4);
+        }
+        std::vector<vector3> vecs = {{1, 2, 3}, {-0.1f, 0.2f, 100}, {1000, -7, 0.001f}};
+
+        WHEN ( "They are converted to halves and back" ) {
+            std::vector<half> halves(values.size());
+            std::vector<float> back(values.size());
+            to_half(values.data(), halves.data(), values.size());
+            from_half(halves.data(), back.data(), values.size());
+
+            std::vector<vector3h> vecs_h(vecs.size());
+            std::vector<vector3> vecs_back(vecs.size());
+            to_half(vecs.data(), vecs_h.data(), vecs.size());
+            from_half(vecs_h.data(), vecs_back.data(), vecs.size());
+
+            THEN ( "The batch results match the single conversions" ) {
+                for (auto i = 0u; i < values.size(); ++i) {
+                    CHECK ( halves[i].m_bits == half(values[i]).m_bits );
+                    CHECK ( s_equal(back[i], half(values[i]).to_float()) );
+                }
+                for (auto i = 0u; i < vecs.size(); ++i) {
+                    CHECK ( s_equal(vecs_back[i].x(), vector3h(vecs[i]).to_vector3().x()) );
+                    CHECK ( s_equal(vecs_back[i].y(), vector3h(vecs[i]).to_vector3().y()) );
+                    CHECK ( s_equal(vecs_back[i].z(), vector3h(vecs[i]).to_vector3().z()) );
+                    CHECK ( vecs_back[i].x() == Approx( vecs[i].x() ).epsilon( 0.001 ) );
+                    CHECK ( vecs_back[i].z() == Approx( vecs[i].z() ).epsilon( 0.001 ) );
+                }
+            }
+        }
+    }
+}
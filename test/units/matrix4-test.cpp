@@ -8,6 +8,8 @@
 #include <linalg/matrix4.h>
 
 #include <iostream>
+#include <cmath>
+#include <vector>
 
 SCENARIO ( "The matrix4 class can be used for linear algebra", "[linalg][matrix4]" ) {
 
@@ -316,4 +318,267 @@ SCENARIO ( "The matrix4 class can be used for linear algebra", "[linalg][matrix4
         }
     }
 
+    GIVEN ( "An invertible matrix4 and a copy of it" ) {
+        matrix4 m(mat_array({{2,0.5f,1,0,1,3,0.25f,1,0,1,4,2,1,-1,0.5f,1}}));
+        matrix4 m_inv(m);
+
+        WHEN ( "The copy is inverted and multiplied with the original" ) {
+            m_inv.invert();
+            auto m_left = m_inv * m;
+            auto m_right = m * m_inv;
+
+            THEN ( "The products are the identity matrix" ) {
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( m_left.m_mat[i] == Approx( matrix4().m_mat[i] ).margin(1e-5) );
+                    CHECK ( m_right.m_mat[i] == Approx( matrix4().m_mat[i] ).margin(1e-5) );
+                }
+            }
+        }
+
+        AND_WHEN ( "The 'set_as_normal' method is called" ) {
+            scalar normal[9];
+            m.set_as_normal(normal);
+            m_inv.invert().transpose();
+
+            THEN ( "The values are the upper 3x3 of the inverse transpose" ) {
+                for (auto r = 0u; r < 3; ++r) {
+                    for (auto c = 0u; c < 3; ++c) {
+                        CHECK ( normal[3 * r + c] == Approx( m_inv.m_mat[4 * r + c] ) );
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A singular matrix4" ) {
+        mat_array vals = {{1,2,3,4,2,4,6,8,9,0,1,2,3,4,5,6}};
+        matrix4 m(vals);
+
+        WHEN ( "The 'invert' method is called" ) {
+            m.invert();
+
+            THEN ( "The matrix4 is left unchanged" ) {
+                CHECK ( m == matrix4(vals) );
+            }
+        }
+    }
+
+    GIVEN ( "A matrix4 with any arbitrary values" ) {
+        mat_array vals = {{1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6}};
+        matrix4 m(vals);
+
+        WHEN ( "The 'rotate' method is called with a quarter turn about z" ) {
+            m.rotate(static_cast<scalar>(M_PI / 2), vector3(0, 0, 2));
+
+            // The first two rows are rotated, the others are unchanged
+            mat_array vals_rot = {{5,6,7,8,-1,-2,-3,-4,9,0,1,2,3,4,5,6}};
+
+            THEN ( "The matrix4 values are set to the rotated values" ) {
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( m.m_mat[i] == Approx( vals_rot[i] ).margin(1e-5) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "Arrays of matrix4 with any arbitrary values" ) {
+        const auto count = 5u;
+        std::vector<matrix4> a, b;
+        for (auto i = 0u; i < count; ++i) {
+            auto k = static_cast<scalar>(i);
+            a.push_back(matrix4(mat_array({{1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,k}})));
+            b.push_back(matrix4(mat_array({{k,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2}})));
+        }
+        matrix4 parent(mat_array({{2,0,0,0,0,3,0,0,0,0,4,0,1,2,3,1}}));
+
+        WHEN ( "The 'mul_batch' functions are called" ) {
+            std::vector<matrix4> ab(count), a_parent(count), parent_b(count);
+            mul_batch(a.data(), b.data(), ab.data(), count);
+            mul_batch(a.data(), parent, a_parent.data(), count);
+            mul_batch(parent, b.data(), parent_b.data(), count);
+
+            THEN ( "Each output matches the single 'mul' method" ) {
+                for (auto i = 0u; i < count; ++i) {
+                    CHECK ( ab[i] == a[i].clone().mul(b[i]) );
+                    CHECK ( a_parent[i] == a[i].clone().mul(parent) );
+                    CHECK ( parent_b[i] == parent.clone().mul(b[i]) );
+                }
+            }
+        }
+
+        AND_WHEN ( "The output of 'mul_batch' aliases its input" ) {
+            auto a_copy = a;
+            mul_batch(a.data(), b.data(), a.data(), count);
+
+            THEN ( "The products are still correct" ) {
+                for (auto i = 0u; i < count; ++i) {
+                    CHECK ( a[i] == a_copy[i].mul(b[i]) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "Three matrix4 with any arbitrary values" ) {
+        mat_array vals1 = {{1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6}};
+        mat_array vals2 = {{1,1,1,1,1,1,1,1,2,2,2,2,2,2,2,2}};
+        mat_array vals3 = {{0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1}};
+        matrix4 m1(vals1), m2(vals2), m3(vals3);
+        scalar s = 0.5f;
+
+        WHEN ( "Compound expressions are evaluated" ) {
+            matrix4 m4 = m1 + m2 * s - m3;
+            matrix4 m5(m1);
+            m5 -= s * (m2 + m3);
+            auto m6 = (m1 + m2) * m3;
+
+            mat_array vals4, vals5;
+            for (auto i = 0u; i < 16; ++i) {
+                vals4[i] = vals1[i] + vals2[i] * s - vals3[i];
+                vals5[i] = vals1[i] - s * (vals2[i] + vals3[i]);
+            }
+
+            THEN ( "The results match the element-wise values" ) {
+                CHECK ( m4 == matrix4(vals4) );
+                CHECK ( m5 == matrix4(vals5) );
+                CHECK ( m6 == matrix4(vals1).add(m2).mul(m3) );
+            }
+        }
+    }
+
+    GIVEN ( "An affine matrix4 and arrays of vectors" ) {
+        matrix4 m;
+        m.rotate(0.4f, vector3(1, -1, 2)).scale(1.5f);
+        m.m_mat[15] = 1;
+        m.m_mat[12] = 3;
+        m.m_mat[13] = -2;
+        m.m_mat[14] = 0.5f;
+
+        // Longer than one thread's share and not a multiple of four
+        const std::size_t count = 100003;
+        std::vector<vector3> in, points(count), dirs(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto f = static_cast<scalar>(i % 97);
+            in.emplace_back(f, 1 - f, 0.5f * f);
+        }
+
+        // Transform v as the row vector [v w] times the matrix4
+        auto row_times = [&](const vector3& v, scalar w) {
+            return vector3(
+                v.x() * m.m_mat[0] + v.y() * m.m_mat[4] + v.z() * m.m_mat[8] + w * m.m_mat[12],
+                v.x() * m.m_mat[1] + v.y() * m.m_mat[5] + v.z() * m.m_mat[9] + w * m.m_mat[13],
+                v.x() * m.m_mat[2] + v.y() * m.m_mat[6] + v.z() * m.m_mat[10] + w * m.m_mat[14]);
+        };
+
+        WHEN ( "The 'transform_points' and 'transform_directions' functions are called" ) {
+            transform_points(m, in.data(), points.data(), count);
+            transform_directions(m, in.data(), dirs.data(), count);
+
+            THEN ( "The results match the matrix4 product" ) {
+                for (std::size_t i = 0; i < count; i += 997) {
+                    CHECK ( points[i] == row_times(in[i], 1) );
+                    CHECK ( dirs[i] == row_times(in[i], 0) );
+                    CHECK ( points[i] == m.transform_point(in[i]) );
+                    CHECK ( dirs[i] == m.transform_vector(in[i]) );
+                }
+                CHECK ( points[count - 1] == row_times(in[count - 1], 1) );
+            }
+        }
+
+        AND_WHEN ( "The output of 'transform_points' aliases its input" ) {
+            auto copy = in;
+            transform_points(m, in.data(), in.data(), 11);
+
+            THEN ( "The results are still correct" ) {
+                for (auto i = 0u; i < 11; ++i) {
+                    CHECK ( in[i] == row_times(copy[i], 1) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A perspective matrix4 and an array of points" ) {
+        matrix4 m;
+        m.perspective(1.2f, 1.5f, 0.1f, 100);
+        std::vector<vector3> in, out(7);
+        for (auto i = 0; i < 7; ++i) {
+            auto f = static_cast<scalar>(i);
+            in.emplace_back(f - 3, 0.5f * f, -1 - f);
+        }
+
+        WHEN ( "The points are transformed with the perspective divide" ) {
+            transform_points(m, in.data(), out.data(), in.size(), true);
+
+            THEN ( "The results match 'transform_point'" ) {
+                for (auto i = 0u; i < in.size(); ++i) {
+                    auto p = m.transform_point(in[i]);
+                    CHECK ( out[i].x() == Approx( p.x() ) );
+                    CHECK ( out[i].y() == Approx( p.y() ) );
+                    CHECK ( out[i].z() == Approx( p.z() ) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A matrix4 whose w is nearly zero for every point" ) {
+        matrix4 m;
+        m.m_mat[15] = 1e-44f;
+        std::vector<vector3> in, out(9);
+        for (auto i = 0; i < 9; ++i) {
+            auto f = static_cast<scalar>(i);
+            in.emplace_back(f, 2 * f, -f);
+        }
+
+        WHEN ( "The points are transformed with the perspective divide" ) {
+            transform_points(m, in.data(), out.data(), in.size(), true);
+
+            THEN ( "They are not divided by w, as with 'transform_point'" ) {
+                for (auto i = 0u; i < in.size(); ++i) {
+                    CHECK ( out[i] == m.transform_point(in[i]) );
+                    CHECK ( out[i] == in[i] );
+                }
+            }
+        }
+    }
+
+}
+
+SCENARIO ( "The matrix4d class works in double precision", "[linalg][matrix4]" ) {
+
+    GIVEN ( "The same transform as a matrix4 and a matrix4d" ) {
+        matrix4 mf;
+        mf.rotate(0.7f, vector3(1, 2, 3));
+        mf.m_mat[12] = 5;
+        mf.m_mat[13] = -2;
+        matrix4d md(mf);
+
+        WHEN ( "Both are inverted" ) {
+            auto inv_f = mf.clone().invert();
+            auto inv_d = md.clone().invert();
+
+            THEN ( "They agree to float precision" ) {
+                CHECK ( matrix4(inv_d) == inv_f );
+                auto product = md * inv_d;
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( product.m_mat[i] == Approx( matrix4d().m_mat[i] ).margin( 1e-12 ) );
+                }
+            }
+        }
+
+        AND_WHEN ( "The batch functions are called" ) {
+            std::vector<vector3d> in, out(9);
+            for (auto i = 0; i < 9; ++i) {
+                in.emplace_back(i, 1e6 + i, -0.5 * i);
+            }
+            transform_points(md, in.data(), out.data(), in.size());
+            std::vector<matrix4d> mats(3, md), prods(3);
+            mul_batch(mats.data(), md, prods.data(), mats.size());
+
+            THEN ( "The results match the single versions" ) {
+                for (auto i = 0u; i < in.size(); ++i) {
+                    CHECK ( out[i] == md.transform_point(in[i]) );
+                }
+                CHECK ( prods[2] == md * md );
+            }
+        }
+    }
 }
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+/// Testing the matrix4a class and aligned transform arrays
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/matrix4a.h>
+
+#include <cstdint>
+
+SCENARIO ( "Aligned matrices behave like matrix4", "[linalg][matrix4a]" ) {
+
+    GIVEN ( "A matrix4a and a matrix4 with the same values" ) {
+        mat_array vals = {{1,2,3,4,5,6,7,8,9,0,1,2,3,4,5,6}};
+        matrix4 m(vals);
+        matrix4a ma(vals);
+
+        THEN ( "The matrix4a is on a cache line boundary" ) {
+            CHECK ( reinterpret_cast<std::uintptr_t>(&ma) % 64 == 0 );
+            CHECK ( ma == m );
+        }
+
+        WHEN ( "The matrix4 methods and operators are used" ) {
+            ma.rotate(0.5f, vector3(1, 1, 0)).scale(2);
+            matrix4a product = ma * m;
+
+            THEN ( "The results match matrix4" ) {
+                auto expected = m.clone().rotate(0.5f, vector3(1, 1, 0)).scale(2);
+                CHECK ( ma == expected );
+                CHECK ( product == expected * m );
+            }
+        }
+    }
+
+    GIVEN ( "A matrix4_array" ) {
+        matrix4_array a(9), b(9), out(9);
+        for (auto i = 0u; i < a.size(); ++i) {
+            a[i].rotate(0.1f * static_cast<scalar>(i), vector3(0, 1, 0));
+            b[i].m_mat[12] = static_cast<scalar>(i);
+        }
+
+        THEN ( "Every matrix is on a cache line boundary" ) {
+            for (const auto& m : a) {
+                CHECK ( reinterpret_cast<std::uintptr_t>(&m) % 64 == 0 );
+            }
+        }
+
+        WHEN ( "The arrays are passed to 'mul_batch'" ) {
+            mul_batch(a.data(), b.data(), out.data(), a.size());
+
+            THEN ( "The products are correct" ) {
+                for (auto i = 0u; i < a.size(); ++i) {
+                    CHECK ( out[i] == a[i] * b[i] );
+                }
+            }
+        }
+    }
+}
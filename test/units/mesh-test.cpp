@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+/// Testing meshes viewing arena memory
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh.h>
+
+#include <cstring>
+#include <utility>
+
+SCENARIO ( "Meshes are laid out in one allocation", "[objects][mesh]" ) {
+
+    GIVEN ( "The cuboid mesh buffers and an arena" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto buffers = build_mesh(obj);
+        mesh_arena arena;
+
+        WHEN ( "The mesh is interleaved" ) {
+            auto m = make_mesh(arena, buffers, mesh_interleaved);
+
+            THEN ( "The vertices are one stream, then the indices" ) {
+                REQUIRE ( m.is_valid() );
+                CHECK ( m.m_layout.stream_count() == 1 );
+                CHECK ( m.m_layout.stream_stride(0) == 32 );
+                CHECK ( m.m_index_type == gl_unsigned_short );
+                CHECK ( m.m_index_offset == 24 * 32 );
+                CHECK ( m.size() == 24 * 32 + 36 * 2 );
+                CHECK ( arena.size() == m.size() );
+                CHECK ( std::memcmp(m.stream(0), buffers.m_vertices.data(), buffers.m_vertices.size()) == 0 );
+                for (auto i = 0u; i < 36; ++i) {
+                    CHECK ( m.index(i) == buffers.m_indices[i] );
+                }
+            }
+        }
+
+        WHEN ( "The mesh is split into streams" ) {
+            auto m = make_mesh(arena, buffers, mesh_split);
+
+            THEN ( "Each attribute is a packed, aligned stream" ) {
+                REQUIRE ( m.m_layout.stream_count() == 3 );
+                CHECK ( m.m_layout.stream_stride(0) == 12 );
+                CHECK ( m.m_layout.stream_stride(2) == 8 );
+                CHECK ( m.m_stream_offsets[1] == 24 * 12 );
+                CHECK ( m.m_stream_offsets[2] == 24 * 12 * 2 );
+                for (auto s = 0u; s < 3; ++s) {
+                    CHECK ( reinterpret_cast<std::uintptr_t>(m.stream(s)) % 16 == 0 );
+                }
+                for (auto v = 0u; v < 24; ++v) {
+                    for (auto a = 0u; a < 3; ++a) {
+                        auto& attribute = buffers.m_attributes[a];
+                        CHECK ( std::memcmp(m.attribute(a, v),
+                            buffers.m_vertices.data() + v * 32 + attribute.m_offset,
+                            attribute.m_components * 4u) == 0 );
+                    }
+                }
+            }
+        }
+
+        WHEN ( "The buffers have levels of detail" ) {
+            buffers.m_lods = {{0, 36, 0}, {12, 24, 0.5f}};
+            buffers.m_uv_min = {{0.25f, 0}};
+            auto m = make_mesh(arena, buffers, mesh_interleaved);
+            auto copy = m.clone(arena);
+
+            THEN ( "The levels and bounds are kept, also by clones" ) {
+                REQUIRE ( m.m_lod_count == 2 );
+                CHECK ( m.m_lods[1].m_index_offset == 12 );
+                CHECK ( m.m_lods[1].m_error == Approx( 0.5f ) );
+                CHECK ( m.m_min == buffers.m_min );
+                CHECK ( m.m_max == buffers.m_max );
+                CHECK ( m.m_uv_min[0] == Approx( 0.25f ) );
+                CHECK ( copy.m_lod_count == 2 );
+                CHECK ( copy.m_lods[1].m_index_count == 24 );
+                CHECK ( copy.m_max == buffers.m_max );
+            }
+        }
+
+        WHEN ( "A mesh is moved and cloned" ) {
+            auto m = make_mesh(arena, buffers, mesh_split);
+            auto data = m.m_data;
+            auto moved = std::move(m);
+            auto copy = moved.clone(arena);
+            auto allocated = arena.size();
+            auto invalid_copy = m.clone(arena);
+
+            THEN ( "The view moves and the clone has its own copy" ) {
+                CHECK ( !m.is_valid() );
+                CHECK ( moved.m_data == data );
+                CHECK ( copy.m_data != data );
+                CHECK ( std::memcmp(copy.m_data, moved.m_data, moved.size()) == 0 );
+            }
+
+            THEN ( "Cloning the moved-from mesh allocates nothing" ) {
+                CHECK ( !invalid_copy.is_valid() );
+                CHECK ( arena.size() == allocated );
+            }
+        }
+    }
+
+    GIVEN ( "A mesh with more vertices than 16 bit indices address" ) {
+        mesh_arena arena;
+        mesh_attribute position {mesh_position, 3, 0, 0, gl_float};
+        mesh m(arena, make_layout(&position, 1, mesh_interleaved), 70000, 3);
+        m.set_index(2, 69999);
+
+        THEN ( "The indices are 32 bits" ) {
+            CHECK ( m.m_index_type == gl_unsigned_int );
+            CHECK ( m.index(2) == 69999 );
+        }
+    }
+}
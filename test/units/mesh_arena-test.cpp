@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+/// Testing the mesh arena
+///
+
+
+#include <catch.hpp>
+
+#include <objects/mesh_arena.h>
+
+#include <cstdint>
+#include <utility>
+
+SCENARIO ( "Mesh memory is bump allocated from blocks", "[objects][mesh_arena]" ) {
+
+    GIVEN ( "An arena with 1 KiB blocks" ) {
+        mesh_arena arena(1024);
+
+        WHEN ( "Small allocations are made" ) {
+            auto a = static_cast<std::uint8_t*>(arena.allocate(100));
+            auto b = static_cast<std::uint8_t*>(arena.allocate(100, 64));
+
+            THEN ( "They share a block and are aligned" ) {
+                CHECK ( arena.block_count() == 1 );
+                CHECK ( reinterpret_cast<std::uintptr_t>(a) % 16 == 0 );
+                CHECK ( reinterpret_cast<std::uintptr_t>(b) % 64 == 0 );
+                CHECK ( b >= a + 100 );
+                CHECK ( arena.size() == 200 );
+            }
+        }
+
+        WHEN ( "An allocation is larger than a block" ) {
+            auto a = static_cast<std::uint8_t*>(arena.allocate(100));
+            arena.allocate(4096);
+            auto b = static_cast<std::uint8_t*>(arena.allocate(100));
+
+            THEN ( "It gets a block of its own and the current block goes on" ) {
+                CHECK ( arena.block_count() == 2 );
+                CHECK ( b >= a + 100 );
+                CHECK ( b < a + 1024 );
+            }
+        }
+
+        WHEN ( "An allocation larger than a block follows the first block and the arena is reset" ) {
+            auto first = static_cast<std::uint8_t*>(arena.allocate(100));
+            arena.allocate(4096);
+            arena.reset();
+            auto a = static_cast<std::uint8_t*>(arena.allocate(1000));
+
+            THEN ( "The block of the standard size is the one kept" ) {
+                CHECK ( arena.block_count() == 1 );
+                CHECK ( a == first );
+                CHECK ( arena.m_end - a == 1024 );
+            }
+        }
+
+        WHEN ( "The blocks fill up and the arena is reset" ) {
+            for (auto i = 0; i < 20; ++i) {
+                arena.allocate(200);
+            }
+            auto blocks = arena.block_count();
+            arena.reset();
+
+            THEN ( "Only the first block is kept" ) {
+                CHECK ( blocks > 1 );
+                CHECK ( arena.block_count() == 1 );
+                CHECK ( arena.size() == 0 );
+            }
+        }
+
+        WHEN ( "The arena is moved" ) {
+            arena.allocate(100);
+            auto moved = std::move(arena);
+
+            THEN ( "The blocks move with it" ) {
+                CHECK ( moved.block_count() == 1 );
+                CHECK ( moved.size() == 100 );
+                CHECK ( arena.block_count() == 0 );
+            }
+        }
+    }
+}
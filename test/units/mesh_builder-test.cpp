@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/// Testing the mesh builder
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+
+#include <cstring>
+#include <string>
+
+// Return the floats of attribute a of vertex i
+static const float* attribute(const mesh_buffers& mesh, std::size_t a, std::uint32_t i) {
+    return reinterpret_cast<const float*>(
+        mesh.m_vertices.data() + i * mesh.m_stride + mesh.m_attributes[a].m_offset);
+}
+
+SCENARIO ( "The mesh builder shares vertices between corners", "[objects][mesh_builder]" ) {
+
+    GIVEN ( "The cuboid mesh" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto mesh = build_mesh(obj);
+
+        THEN ( "Each unique position, uv and normal is one vertex" ) {
+            CHECK ( mesh.vertex_count() == 24 );
+            CHECK ( mesh.m_indices.size() == 36 );
+        }
+
+        THEN ( "The indexed vertices have the attributes of the corners" ) {
+            for (auto i = 0u; i < obj.m_corners.size(); ++i) {
+                auto& c = obj.m_corners[i];
+                auto v = mesh.m_indices[i];
+                CHECK ( std::memcmp(attribute(mesh, 0, v), obj.m_positions[c.m_pos].m_vec.data(), 12) == 0 );
+                CHECK ( std::memcmp(attribute(mesh, 1, v), obj.m_normals[c.m_normal].m_vec.data(), 12) == 0 );
+                CHECK ( std::memcmp(attribute(mesh, 2, v), obj.m_uvs[c.m_uv].data(), 8) == 0 );
+            }
+        }
+    }
+
+    GIVEN ( "A quad with normals on only some corners" ) {
+        std::string text =
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\n"
+            "f 1//1 2//1 3//1 4\n";
+        obj_data obj;
+        REQUIRE ( parse_obj(text.data(), text.data() + text.size(), obj) );
+        auto mesh = build_mesh(obj);
+
+        THEN ( "The normals are dropped and the shared corners are one vertex" ) {
+            CHECK ( mesh.m_attributes.size() == 1 );
+            CHECK ( mesh.m_stride == 12 );
+            CHECK ( mesh.vertex_count() == 4 );
+            CHECK ( mesh.m_indices.size() == 6 );
+            CHECK ( mesh.m_indices[3] == 0 );
+            CHECK ( mesh.m_indices[4] == 2 );
+            CHECK ( mesh.m_max.x() == Approx( 1 ) );
+        }
+    }
+}
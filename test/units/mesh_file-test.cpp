@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/// Testing the binary mesh format
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh_file.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+SCENARIO ( "Meshes are written to and mapped from mesh files", "[objects][mesh_file]" ) {
+
+    GIVEN ( "The cuboid mesh built from its OBJ file" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto mesh = build_mesh(obj);
+        const char* path = "mesh_file-test.mesh";
+
+        THEN ( "The buffers interleave positions, normals and uvs" ) {
+            REQUIRE ( mesh.m_attributes.size() == 3 );
+            CHECK ( mesh.m_attributes[1].m_semantic == mesh_normal );
+            CHECK ( mesh.m_attributes[1].m_offset == 12 );
+            CHECK ( mesh.m_attributes[2].m_semantic == mesh_uv );
+            CHECK ( mesh.m_attributes[2].m_offset == 24 );
+            CHECK ( mesh.m_stride == 32 );
+            CHECK ( mesh.m_indices.size() == 36 );
+            CHECK ( mesh.m_min.x() == Approx( -1 ) );
+            CHECK ( mesh.m_max.z() == Approx( 1 ).margin(1e-5) );
+        }
+
+        WHEN ( "The mesh is written and mapped" ) {
+            REQUIRE ( write_mesh_file(path, mesh) );
+            mesh_file file(path);
+
+            THEN ( "The header and blobs match the buffers" ) {
+                REQUIRE ( file.is_valid() );
+                auto& header = file.header();
+                CHECK ( header.m_version == mesh_file_version );
+                CHECK ( header.m_vertex_count == mesh.vertex_count() );
+                CHECK ( header.m_index_count == 36 );
+                CHECK ( header.m_index_type == gl_unsigned_short );
+                CHECK ( header.m_vertex_stride == 32 );
+                CHECK ( header.m_attribute_count == 3 );
+                CHECK ( header.m_vertex_offset % mesh_file_alignment == 0 );
+                CHECK ( header.m_index_offset % mesh_file_alignment == 0 );
+                CHECK ( header.m_min[1] == Approx( -1 ) );
+                CHECK ( header.m_uv_min[0] == Approx( mesh.m_uv_min[0] ) );
+                CHECK ( header.m_uv_max[1] == Approx( mesh.m_uv_max[1] ) );
+                CHECK ( header.m_lod_count == 1 );
+                CHECK ( header.m_lods[0].m_index_count == 36 );
+                CHECK ( std::memcmp(file.vertex_data(), mesh.m_vertices.data(), mesh.m_vertices.size()) == 0 );
+
+                auto indices = static_cast<const std::uint16_t*>(file.index_data());
+                for (auto i = 0u; i < mesh.m_indices.size(); ++i) {
+                    CHECK ( indices[i] == mesh.m_indices[i] );
+                }
+            }
+        }
+
+        WHEN ( "The file is truncated" ) {
+            REQUIRE ( write_mesh_file(path, mesh) );
+            {
+                std::ifstream in(path, std::ios::binary);
+                std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                std::ofstream out(path, std::ios::binary);
+                out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+            }
+            mesh_file file(path);
+
+            THEN ( "It is rejected" ) {
+                CHECK ( !file.is_valid() );
+            }
+        }
+
+        WHEN ( "The file has a different version" ) {
+            REQUIRE ( write_mesh_file(path, mesh) );
+            {
+                std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+                std::uint32_t version = mesh_file_version + 1;
+                io.seekp(4);
+                io.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            }
+            mesh_file file(path);
+
+            THEN ( "It is rejected" ) {
+                CHECK ( !file.is_valid() );
+            }
+        }
+
+        WHEN ( "The index offset of the file wraps around past its end" ) {
+            REQUIRE ( write_mesh_file(path, mesh) );
+            {
+                std::fstream io(path, std::ios::binary | std::ios::in | std::ios::out);
+                std::uint64_t offset = ~std::uint64_t{0} - 63;
+                io.seekp(offsetof(mesh_file_header, m_index_offset));
+                io.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+            }
+            mesh_file file(path);
+
+            THEN ( "It is rejected" ) {
+                CHECK ( !file.is_valid() );
+            }
+        }
+
+        std::remove(path);
+    }
+
+    GIVEN ( "A missing file" ) {
+        mesh_file file("missing.mesh");
+
+        THEN ( "It is not valid" ) {
+            CHECK ( !file.is_valid() );
+        }
+    }
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/// Testing the mesh optimizer
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh_optimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+
+// Return a mesh of positions only
+static mesh_buffers position_mesh(const std::vector<vector3>& positions, std::vector<std::uint32_t> indices) {
+    mesh_buffers mesh;
+    mesh.m_attributes.push_back({mesh_position, 3, 0, 0, gl_float});
+    mesh.m_stride = 12;
+    mesh.m_vertices.resize(positions.size() * 12);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        std::memcpy(mesh.m_vertices.data() + 12 * i, positions[i].m_vec.data(), 12);
+    }
+    mesh.m_indices = std::move(indices);
+    return mesh;
+}
+
+// Return the triangles of a mesh as sorted lists of positions
+static std::vector<std::array<std::array<float, 3>, 3>> triangles(const mesh_buffers& mesh) {
+    std::vector<std::array<std::array<float, 3>, 3>> out(mesh.m_indices.size() / 3);
+    for (std::size_t i = 0; i < mesh.m_indices.size(); ++i) {
+        std::memcpy(out[i / 3][i % 3].data(), mesh.m_vertices.data() + mesh.m_indices[i] * mesh.m_stride, 12);
+    }
+    for (auto& t : out) {
+        std::sort(t.begin(), t.end());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+SCENARIO ( "Triangle lists are reordered for the vertex cache", "[objects][mesh_optimizer]" ) {
+
+    GIVEN ( "A grid of quads with its triangles shuffled" ) {
+        const std::uint32_t n = 32;
+        std::vector<vector3> positions;
+        for (std::uint32_t y = 0; y <= n; ++y) {
+            for (std::uint32_t x = 0; x <= n; ++x) {
+                positions.push_back({static_cast<scalar>(x), static_cast<scalar>(y), 0});
+            }
+        }
+        std::vector<std::array<std::uint32_t, 3>> quads;
+        for (std::uint32_t y = 0; y < n; ++y) {
+            for (std::uint32_t x = 0; x < n; ++x) {
+                auto i = y * (n + 1) + x;
+                quads.push_back({{i, i + 1, i + n + 2}});
+                quads.push_back({{i, i + n + 2, i + n + 1}});
+            }
+        }
+        std::shuffle(quads.begin(), quads.end(), std::mt19937{7});
+        std::vector<std::uint32_t> indices;
+        for (auto& q : quads) {
+            indices.insert(indices.end(), q.begin(), q.end());
+        }
+        auto mesh = position_mesh(positions, indices);
+        auto before = analyze_vertex_cache(indices.data(), indices.size(), positions.size());
+
+        WHEN ( "The mesh is optimized" ) {
+            auto original = triangles(mesh);
+            auto after = optimize_mesh(mesh);
+
+            THEN ( "Fewer vertices are transformed" ) {
+                CHECK ( before.m_acmr > 2 );
+                CHECK ( after.m_acmr < 0.8f );
+                CHECK ( after.m_atvr < 1.5f );
+                CHECK ( after.m_transformed < before.m_transformed / 3 );
+            }
+
+            THEN ( "The triangles are the same" ) {
+                CHECK ( triangles(mesh) == original );
+            }
+
+            THEN ( "The vertices are numbered in the order they are used" ) {
+                std::uint32_t next = 0;
+                auto in_order = true;
+                for (auto i : mesh.m_indices) {
+                    in_order = in_order && i <= next;
+                    next = std::max(next, i + 1);
+                }
+                CHECK ( in_order );
+                CHECK ( next == mesh.vertex_count() );
+            }
+        }
+    }
+
+    GIVEN ( "The cuboid mesh" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto mesh = build_mesh(obj);
+
+        WHEN ( "The mesh is optimized" ) {
+            auto stats = optimize_mesh(mesh);
+
+            THEN ( "Each vertex is transformed once" ) {
+                CHECK ( mesh.vertex_count() == 24 );
+                CHECK ( stats.m_transformed == 24 );
+                CHECK ( stats.m_atvr == Approx( 1 ) );
+                CHECK ( stats.m_acmr == Approx( 2 ) );
+            }
+        }
+    }
+}
+
+SCENARIO ( "Clusters are reordered to reduce overdraw", "[objects][mesh_optimizer]" ) {
+
+    GIVEN ( "Two quads facing +z, the one behind first" ) {
+        auto mesh = position_mesh({
+            {-1, -1, 0}, {1, -1, 0}, {1, 1, 0}, {-1, 1, 0},
+            {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},
+            {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7});
+        auto& indices = mesh.m_indices;
+
+        WHEN ( "The clusters are found and reordered" ) {
+            auto clusters = optimize_vertex_cache(indices.data(), indices.size(), mesh.vertex_count());
+            optimize_overdraw(indices.data(), indices.size(), clusters, mesh);
+
+            THEN ( "The quad in front is drawn first" ) {
+                CHECK ( clusters.size() == 2 );
+                for (std::size_t i = 0; i < 6; ++i) {
+                    CHECK ( indices[i] >= 4 );
+                }
+                for (std::size_t i = 6; i < 12; ++i) {
+                    CHECK ( indices[i] < 4 );
+                }
+            }
+        }
+    }
+}
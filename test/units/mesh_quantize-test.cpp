@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+/// Testing quantized vertices
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh_quantize.h>
+
+#include <cstring>
+#include <random>
+
+// Return the values of attribute a of vertex i
+template <typename T, std::size_t N>
+static std::array<T, N> attribute(const mesh_buffers& mesh, std::size_t a, std::size_t i) {
+    std::array<T, N> values;
+    std::memcpy(values.data(), mesh.m_vertices.data() + i * mesh.m_stride + mesh.m_attributes[a].m_offset, sizeof(values));
+    return values;
+}
+
+SCENARIO ( "Unit vectors are octahedral encoded", "[objects][mesh_quantize]" ) {
+
+    GIVEN ( "The axes and random unit vectors" ) {
+        std::vector<vector3> normals {
+            {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+        std::mt19937 gen{3};
+        std::uniform_real_distribution<scalar> dist(-1, 1);
+        for (auto i = 0; i < 1000; ++i) {
+            vector3 n(dist(gen), dist(gen), dist(gen));
+            normals.push_back(n.normalize());
+        }
+
+        THEN ( "They decode to within 0.01 degrees" ) {
+            scalar worst = 0;
+            for (auto& n : normals) {
+                auto decoded = oct_decode(oct_encode(n));
+                worst = std::max(worst, decoded.cross(n).len());
+            }
+            CHECK ( worst < 1.75e-4f );
+        }
+    }
+}
+
+SCENARIO ( "Meshes are quantized", "[objects][mesh_quantize]" ) {
+
+    GIVEN ( "The cuboid mesh" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto mesh = build_mesh(obj);
+        auto original = mesh;
+
+        WHEN ( "The mesh is quantized (without bounds to start with)" ) {
+            mesh.m_min = mesh.m_max = vector3(0, 0, 0);
+            quantize_mesh(mesh);
+
+            THEN ( "The vertices are half the size" ) {
+                CHECK ( mesh.m_stride == 16 );
+                CHECK ( mesh.m_vertices.size() * 2 == original.m_vertices.size() );
+                CHECK ( mesh.m_indices == original.m_indices );
+                REQUIRE ( mesh.m_attributes.size() == 3 );
+                CHECK ( mesh.m_attributes[0].m_type == gl_unsigned_short );
+                CHECK ( mesh.m_attributes[1].m_type == gl_short );
+                CHECK ( mesh.m_attributes[1].m_components == 2 );
+                CHECK ( mesh.m_attributes[2].m_type == gl_unsigned_short );
+                for (auto& a : mesh.m_attributes) {
+                    CHECK ( a.m_normalized == 1 );
+                }
+            }
+
+            THEN ( "The attributes decode to the originals" ) {
+                auto dequantize = dequantize_positions(mesh.m_min, mesh.m_max);
+                auto uv_dequantize = dequantize_uvs(mesh.m_uv_min, mesh.m_uv_max);
+                for (std::size_t i = 0; i < mesh.vertex_count(); ++i) {
+                    auto q = attribute<std::uint16_t, 4>(mesh, 0, i);
+                    auto pos = attribute<float, 3>(original, 0, i);
+                    for (std::size_t j = 0; j < 3; ++j) {
+                        auto decoded = static_cast<scalar>(q[j]) / 65535 * dequantize.m_mat[5 * j] + dequantize.m_mat[12 + j];
+                        CHECK ( decoded == Approx( pos[j] ).margin(1e-4) );
+                    }
+
+                    // (the normals of the file are not quite unit length)
+                    vector3 normal(attribute<float, 3>(original, 1, i));
+                    auto decoded = oct_decode(attribute<std::int16_t, 2>(mesh, 1, i));
+                    CHECK ( decoded.dot(normal.normalize()) == Approx( 1 ) );
+
+                    auto q_uv = attribute<std::uint16_t, 2>(mesh, 2, i);
+                    auto uv = attribute<float, 2>(original, 2, i);
+                    for (std::size_t j = 0; j < 2; ++j) {
+                        auto decoded_uv = static_cast<scalar>(q_uv[j]) / 65535 * uv_dequantize[j] + uv_dequantize[2 + j];
+                        CHECK ( decoded_uv == Approx( uv[j] ).margin(1e-4) );
+                    }
+                }
+            }
+
+            THEN ( "The bounds are those of the positions" ) {
+                CHECK ( mesh.m_min.x() == Approx( original.m_min.x() ) );
+                CHECK ( mesh.m_min.y() == Approx( original.m_min.y() ) );
+                CHECK ( mesh.m_max.z() == Approx( original.m_max.z() ) );
+            }
+
+            THEN ( "Quantizing again changes nothing" ) {
+                auto quantized = mesh;
+                quantize_mesh(mesh);
+                CHECK ( mesh.m_stride == quantized.m_stride );
+                CHECK ( mesh.m_vertices == quantized.m_vertices );
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/// Testing mesh simplification and levels of detail
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+#include <objects/mesh_builder.h>
+#include <objects/mesh_simplify.h>
+
+#include <cmath>
+#include <cstring>
+
+// Return a grid of n by n quads in x and y, with z = height(x, y)
+template <typename F>
+static mesh_buffers grid_mesh(std::uint32_t n, F height) {
+    mesh_buffers mesh;
+    mesh.m_attributes.push_back({mesh_position, 3, 0, 0, gl_float});
+    mesh.m_stride = 12;
+    for (std::uint32_t y = 0; y <= n; ++y) {
+        for (std::uint32_t x = 0; x <= n; ++x) {
+            auto fx = static_cast<scalar>(x) / static_cast<scalar>(n);
+            auto fy = static_cast<scalar>(y) / static_cast<scalar>(n);
+            std::array<float, 3> p {{fx, fy, height(fx, fy)}};
+            auto offset = mesh.m_vertices.size();
+            mesh.m_vertices.resize(offset + 12);
+            std::memcpy(mesh.m_vertices.data() + offset, p.data(), 12);
+        }
+    }
+    for (std::uint32_t y = 0; y < n; ++y) {
+        for (std::uint32_t x = 0; x < n; ++x) {
+            auto i = y * (n + 1) + x;
+            mesh.m_indices.insert(mesh.m_indices.end(), {i, i + 1, i + n + 2, i, i + n + 2, i + n + 1});
+        }
+    }
+    mesh.m_min = {0, 0, -1};
+    mesh.m_max = {1, 1, 1};
+    return mesh;
+}
+
+// Return the z of the normal of triangle t of a flat grid
+static scalar normal_z(const mesh_buffers& mesh, const std::uint32_t* tri) {
+    std::array<std::array<float, 3>, 3> p;
+    for (std::size_t k = 0; k < 3; ++k) {
+        std::memcpy(p[k].data(), mesh.m_vertices.data() + 12 * tri[k], 12);
+    }
+    return (p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+}
+
+SCENARIO ( "Triangle lists are simplified", "[objects][mesh_simplify]" ) {
+
+    GIVEN ( "A flat grid" ) {
+        auto mesh = grid_mesh(32, [](scalar, scalar) { return scalar{0}; });
+
+        WHEN ( "It is simplified to a tenth" ) {
+            scalar error = 0;
+            auto target = mesh.m_indices.size() / 30 * 3;
+            auto lod = simplify_indices(mesh, mesh.m_indices.data(), mesh.m_indices.size(), target, 0.01f, error);
+
+            THEN ( "It loses the triangles without error" ) {
+                CHECK ( lod.size() <= target + target / 2 );
+                CHECK ( error < 1e-3f );
+            }
+
+            THEN ( "No triangle flips and the border stays" ) {
+                auto flipped = 0;
+                for (std::size_t t = 0; t < lod.size(); t += 3) {
+                    flipped += normal_z(mesh, &lod[t]) <= 0;
+                }
+                CHECK ( flipped == 0 );
+                for (std::uint32_t corner : {0u, 32u, 33u * 32u, 33u * 33u - 1}) {
+                    CHECK ( std::find(lod.begin(), lod.end(), corner) != lod.end() );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A curved grid" ) {
+        auto mesh = grid_mesh(48, [](scalar x, scalar y) { return std::sin(3 * x) * std::cos(2 * y) / 2; });
+
+        WHEN ( "A chain of levels is built" ) {
+            build_lods(mesh);
+            auto& lods = mesh.m_lods;
+
+            THEN ( "The levels get coarser and their errors grow" ) {
+                REQUIRE ( lods.size() > 2 );
+                CHECK ( lods[0].m_index_count == 48 * 48 * 6 );
+                CHECK ( lods[0].m_error == Approx( 0 ) );
+                for (std::size_t i = 1; i < lods.size(); ++i) {
+                    CHECK ( lods[i].m_index_count < lods[i - 1].m_index_count );
+                    CHECK ( lods[i].m_error >= lods[i - 1].m_error );
+                    CHECK ( lods[i].m_error <= 0.02f * std::sqrt(6.0f) );
+                    CHECK ( lods[i].m_index_offset == lods[i - 1].m_index_offset + lods[i - 1].m_index_count );
+                }
+                CHECK ( mesh.m_indices.size() == lods.back().m_index_offset + lods.back().m_index_count );
+            }
+        }
+    }
+
+    GIVEN ( "The cuboid mesh" ) {
+        obj_data obj;
+        REQUIRE ( load_obj(MESHES_PATH "/cuboid.obj", obj) );
+        auto mesh = build_mesh(obj);
+
+        WHEN ( "A chain of levels is built" ) {
+            build_lods(mesh);
+
+            THEN ( "Every vertex is on a seam, so there is only the mesh" ) {
+                REQUIRE ( mesh.m_lods.size() == 1 );
+                CHECK ( mesh.m_indices.size() == 36 );
+            }
+        }
+    }
+}
+
+SCENARIO ( "Levels of detail are selected by their size on the screen", "[objects][mesh_simplify]" ) {
+
+    GIVEN ( "Three levels and a camera" ) {
+        std::vector<mesh_lod> lods {{0, 300, 0}, {300, 150, 0.01f}, {450, 60, 0.05f}};
+        auto scale = lod_pixel_scale(1.5707963f, 480);
+
+        THEN ( "The scale is half the viewport height for 90 degrees" ) {
+            CHECK ( scale == Approx( 240 ) );
+        }
+
+        THEN ( "Nearer meshes use finer levels" ) {
+            CHECK ( select_lod(lods.data(), lods.size(), 1, scale) == 0 );
+            CHECK ( select_lod(lods.data(), lods.size(), 5, scale) == 1 );
+            CHECK ( select_lod(lods.data(), lods.size(), 20, scale) == 2 );
+            CHECK ( select_lod(lods.data(), lods.size(), 0, scale) == 0 );
+        }
+    }
+}
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+/// Testing the OBJ loader
+///
+
+
+#include <catch.hpp>
+
+#include <objects/obj_loader.h>
+
+#include <cmath>
+#include <string>
+
+SCENARIO ( "The OBJ loader parses positions, uvs, normals and faces", "[objects][obj_loader]" ) {
+
+    GIVEN ( "OBJ text with a triangle, a quad and the other face formats" ) {
+        std::string text =
+            "# A comment\n"
+            "mtllib test.mtl\n"
+            "o test\n"
+            "v 1 2 3\n"
+            "v -1.5 +2.25e1 .5\r\n"
+            "v 0.000001 1E-3 -7\n"
+            "  v 4 5 6 1\n"
+            "vt 0.25 0.75\n"
+            "vt 1\n"
+            "vn 0 0 1\n"
+            "s 1\n"
+            "\n"
+            "f 1 2 3\n"
+            "f 1/1/1 2/2/1 3/1/1 4/2/1\n"
+            "f 1//1 2//1 3//1\n"
+            "f -4/-2 -3/-1 -2/-2\n"
+            "vp 0.5\n";
+        obj_data data;
+        auto ok = parse_obj(text.data(), text.data() + text.size(), data);
+
+        THEN ( "The attributes are parsed in order" ) {
+            REQUIRE ( ok );
+            REQUIRE ( data.m_positions.size() == 4 );
+            CHECK ( data.m_positions[0] == vector3(1, 2, 3) );
+            CHECK ( data.m_positions[1] == vector3(-1.5f, 22.5f, 0.5f) );
+            CHECK ( data.m_positions[2].x() == Approx( 1e-6 ) );
+            CHECK ( data.m_positions[2].y() == Approx( 1e-3 ) );
+            CHECK ( data.m_positions[3] == vector3(4, 5, 6) );
+            REQUIRE ( data.m_uvs.size() == 2 );
+            CHECK ( data.m_uvs[0][1] == Approx( 0.75 ) );
+            CHECK ( data.m_uvs[1][0] == Approx( 1 ) );
+            CHECK ( data.m_uvs[1][1] == Approx( 0 ) );
+            CHECK ( data.m_normals.size() == 1 );
+        }
+
+        THEN ( "Faces are split into triangles with zero-based indices" ) {
+            REQUIRE ( data.triangle_count() == 5 );
+            CHECK ( data.m_corners[0].m_pos == 0 );
+            CHECK ( data.m_corners[2].m_pos == 2 );
+            CHECK ( data.m_corners[0].m_uv == obj_no_index );
+            CHECK ( data.m_corners[0].m_normal == obj_no_index );
+
+            // The quad is a fan around its first corner
+            CHECK ( data.m_corners[3].m_pos == 0 );
+            CHECK ( data.m_corners[5].m_pos == 2 );
+            CHECK ( data.m_corners[6].m_pos == 0 );
+            CHECK ( data.m_corners[7].m_pos == 2 );
+            CHECK ( data.m_corners[8].m_pos == 3 );
+            CHECK ( data.m_corners[8].m_uv == 1 );
+            CHECK ( data.m_corners[8].m_normal == 0 );
+
+            CHECK ( data.m_corners[9].m_uv == obj_no_index );
+            CHECK ( data.m_corners[9].m_normal == 0 );
+
+            // Negative indices count back from the last attribute
+            CHECK ( data.m_corners[12].m_pos == 0 );
+            CHECK ( data.m_corners[13].m_pos == 1 );
+            CHECK ( data.m_corners[13].m_uv == 1 );
+            CHECK ( data.m_corners[14].m_normal == obj_no_index );
+        }
+    }
+
+    GIVEN ( "Text split into many small chunks" ) {
+        std::string text;
+        for (auto i = 0; i < 200; ++i) {
+            text += "v " + std::to_string(i) + " 0 0\nvn 0 1 0\n";
+            text += i < 2 ? "" : "f -3//-1 -2//-2 -1//-3\n";
+        }
+        obj_data whole, chunked;
+        auto whole_ok = parse_obj(text.data(), text.data() + text.size(), whole);
+        auto chunked_ok = parse_obj(text.data(), text.data() + text.size(), chunked, 7);
+
+        THEN ( "The result matches parsing it as one chunk" ) {
+            REQUIRE ( whole_ok );
+            REQUIRE ( chunked_ok );
+            REQUIRE ( chunked.m_positions.size() == 200 );
+            REQUIRE ( chunked.triangle_count() == 198 );
+            for (auto i = 0u; i < chunked.m_positions.size(); ++i) {
+                CHECK ( chunked.m_positions[i] == whole.m_positions[i] );
+            }
+            for (auto i = 0u; i < chunked.m_corners.size(); ++i) {
+                CHECK ( chunked.m_corners[i].m_pos == whole.m_corners[i].m_pos );
+                CHECK ( chunked.m_corners[i].m_normal == whole.m_corners[i].m_normal );
+            }
+            CHECK ( chunked.m_corners.back().m_pos == 199 );
+            CHECK ( chunked.m_corners.back().m_normal == 197 );
+        }
+    }
+
+    GIVEN ( "Numbers with exponents past the range of a double" ) {
+        std::string text = "v 0e400 1e400 -1e-400\n";
+        obj_data data;
+        auto ok = parse_obj(text.data(), text.data() + text.size(), data);
+
+        THEN ( "They parse to zero or infinity" ) {
+            REQUIRE ( ok );
+            REQUIRE ( data.m_positions.size() == 1 );
+            CHECK ( data.m_positions[0].x() == Approx( 0 ) );
+            CHECK ( std::isinf(data.m_positions[0].y()) );
+            CHECK ( data.m_positions[0].z() == Approx( 0 ) );
+        }
+    }
+
+    GIVEN ( "Malformed text" ) {
+        obj_data data;
+        std::string bad_number = "v 1 x 3\n";
+        std::string bad_index = "v 1 2 3\nf 1 2 3\n";
+        std::string short_face = "v 1 2 3\nf 1 1\n";
+        std::string huge_index = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4294967299\n";
+        std::string before_first = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/-1 2/-1 3/-1\n";
+
+        THEN ( "Parsing fails" ) {
+            CHECK ( !parse_obj(bad_number.data(), bad_number.data() + bad_number.size(), data) );
+            CHECK ( !parse_obj(bad_index.data(), bad_index.data() + bad_index.size(), data) );
+            CHECK ( !parse_obj(short_face.data(), short_face.data() + short_face.size(), data) );
+            CHECK ( !parse_obj(huge_index.data(), huge_index.data() + huge_index.size(), data) );
+            CHECK ( !parse_obj(before_first.data(), before_first.data() + before_first.size(), data) );
+        }
+    }
+
+    GIVEN ( "The cuboid mesh" ) {
+        obj_data data;
+        auto ok = load_obj(MESHES_PATH "/cuboid.obj", data);
+
+        THEN ( "It has six quads" ) {
+            REQUIRE ( ok );
+            CHECK ( data.m_positions.size() == 8 );
+            CHECK ( data.m_uvs.size() == 24 );
+            CHECK ( data.m_normals.size() == 8 );
+            CHECK ( data.triangle_count() == 12 );
+        }
+
+        THEN ( "A missing file is not loaded" ) {
+            CHECK ( !load_obj(MESHES_PATH "/missing.obj", data) );
+        }
+    }
+}
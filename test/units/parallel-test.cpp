@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/// Testing the parallel_for function
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/parallel.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+SCENARIO ( "parallel_for splits a range across threads", "[linalg][parallel]" ) {
+
+    GIVEN ( "A range large enough for several threads" ) {
+        const std::size_t count = 4096;
+
+        WHEN ( "Every item is counted" ) {
+            std::vector<std::atomic<int>> seen(count);
+            for (auto& s : seen) {
+                s = 0;
+            }
+            parallel_for(count, 64, [&](std::size_t begin, std::size_t end) {
+                for (auto i = begin; i < end; ++i) {
+                    ++seen[i];
+                }
+            });
+
+            THEN ( "Each item is visited once" ) {
+                auto once = true;
+                for (auto& s : seen) {
+                    once = once && s == 1;
+                }
+                CHECK ( once );
+            }
+        }
+
+        WHEN ( "The range of the calling thread throws" ) {
+            std::atomic<std::size_t> done(0);
+            auto run = [&] {
+                parallel_for(count, 64, [&](std::size_t begin, std::size_t end) {
+                    if (end == count) {
+                        throw std::runtime_error("last range");
+                    }
+                    done += end - begin;
+                });
+            };
+
+            THEN ( "The exception reaches the caller after the other ranges finish" ) {
+                CHECK_THROWS_AS ( run(), std::runtime_error );
+                CHECK ( done < count );
+            }
+        }
+    }
+}
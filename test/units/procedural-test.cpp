@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+/// Testing procedural meshes
+///
+
+
+#include <catch.hpp>
+
+#include <objects/procedural.h>
+#include <objects/meshes/cuboid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <vector>
+
+// Generated at compile time
+constexpr auto cube = make_cuboid<1>();
+constexpr auto sphere = make_uv_sphere<32, 16>();
+constexpr cuboid box;
+
+static_assert(cube.vertex_count() == 24 && cube.index_count() == 36, "cuboid counts");
+static_assert(cube.m_vertices[0] > 0.99f && cube.m_indices[35] == 22, "cuboid data");
+static_assert(sphere.m_vertices[1] > 0.99f, "the first ring is the top pole");
+static_assert(box.m_positions[0] > 0.99f && box.m_positions[71] < -0.99f, "cuboid positions");
+
+// The vertices and indices of either kind of generated mesh
+struct flat_mesh
+{
+    std::vector<float> m_vertices;
+    std::vector<std::uint32_t> m_indices;
+
+    std::size_t vertex_count() const { return m_vertices.size() / generated_vertex_floats; }
+    const float* vertex(std::size_t v) const { return m_vertices.data() + v * generated_vertex_floats; }
+};
+
+template <std::size_t V, std::size_t I>
+static flat_mesh flatten(const static_mesh<V, I>& mesh) {
+    return {{std::begin(mesh.m_vertices), std::end(mesh.m_vertices)},
+        {std::begin(mesh.m_indices), std::end(mesh.m_indices)}};
+}
+
+static flat_mesh flatten(const mesh_buffers& mesh) {
+    std::vector<float> vertices(mesh.m_vertices.size() / sizeof(float));
+    std::memcpy(vertices.data(), mesh.m_vertices.data(), mesh.m_vertices.size());
+    return {vertices, mesh.m_indices};
+}
+
+// Return the largest difference between the vertices of two meshes (or 1 if
+// their counts or indices differ)
+static float difference(const flat_mesh& a, const flat_mesh& b) {
+    if (a.m_vertices.size() != b.m_vertices.size() || a.m_indices != b.m_indices) {
+        return 1;
+    }
+    float worst = 0;
+    for (std::size_t i = 0; i < a.m_vertices.size(); ++i) {
+        worst = std::max(worst, std::abs(a.m_vertices[i] - b.m_vertices[i]));
+    }
+    return worst;
+}
+
+// Return the position of a vertex, rounded so that coincident vertices match
+static std::tuple<long, long, long> key(const flat_mesh& mesh, std::size_t v) {
+    auto p = mesh.vertex(v);
+    return std::make_tuple(std::lround(p[0] * 1e4f), std::lround(p[1] * 1e4f), std::lround(p[2] * 1e4f));
+}
+
+// Return true if every edge (between coincident positions) is used once in
+// each direction, so the surface is closed and consistently wound
+static bool is_closed(const flat_mesh& mesh) {
+    std::map<std::pair<std::tuple<long, long, long>, std::tuple<long, long, long>>, int> edges;
+    for (std::size_t i = 0; i < mesh.m_indices.size(); i += 3) {
+        for (std::size_t e = 0; e < 3; ++e) {
+            auto a = key(mesh, mesh.m_indices[i + e]), b = key(mesh, mesh.m_indices[i + (e + 1) % 3]);
+            edges[{a, b}] += 1;
+        }
+    }
+    for (auto& edge : edges) {
+        auto twin = edges.find({edge.first.second, edge.first.first});
+        if (edge.second != 1 || twin == edges.end() || twin->second != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return true if the indices are in range, the normals are unit length and
+// every triangle is counter-clockwise seen from the side its normals face
+static bool is_well_formed(const flat_mesh& mesh) {
+    for (auto i : mesh.m_indices) {
+        if (i >= mesh.vertex_count()) {
+            return false;
+        }
+    }
+    for (std::size_t v = 0; v < mesh.vertex_count(); ++v) {
+        auto n = mesh.vertex(v) + 3;
+        if (std::abs(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) - 1) > 1e-5f) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < mesh.m_indices.size(); i += 3) {
+        auto a = mesh.vertex(mesh.m_indices[i]), b = mesh.vertex(mesh.m_indices[i + 1]),
+             c = mesh.vertex(mesh.m_indices[i + 2]);
+        vector3 ab(b[0] - a[0], b[1] - a[1], b[2] - a[2]), ac(c[0] - a[0], c[1] - a[1], c[2] - a[2]);
+        vector3 normal(a[3] + b[3] + c[3], a[4] + b[4] + c[4], a[5] + b[5] + c[5]);
+        if (ab.cross(ac).dot(normal) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SCENARIO ( "Procedural meshes are generated", "[objects][procedural]" ) {
+
+    GIVEN ( "Meshes generated at compile time and at runtime" ) {
+        std::vector<std::pair<flat_mesh, flat_mesh>> closed {
+            {flatten(cube), flatten(generate_cuboid(1))},
+            {flatten(make_cuboid<3>()), flatten(generate_cuboid(3))},
+            {flatten(sphere), flatten(generate_uv_sphere(32, 16))},
+            {flatten(make_uv_sphere<8, 3>()), flatten(generate_uv_sphere(8, 3))},
+            {flatten(make_ico_sphere<1>()), flatten(generate_ico_sphere(1))},
+            {flatten(make_ico_sphere<4>()), flatten(generate_ico_sphere(4))},
+            {flatten(make_cylinder<8>()), flatten(generate_cylinder(8, 1))},
+            {flatten(make_cylinder<13, 3>()), flatten(generate_cylinder(13, 3))}
+        };
+        auto plane = flatten(make_plane<4, 2>());
+        auto runtime_plane = flatten(generate_plane(4, 2));
+
+        THEN ( "Both agree" ) {
+            float worst = difference(plane, runtime_plane);
+            for (auto& meshes : closed) {
+                worst = std::max(worst, difference(meshes.first, meshes.second));
+            }
+            CHECK ( worst < 1e-5f );
+        }
+
+        THEN ( "They are well formed and the solids are closed" ) {
+            bool well_formed = is_well_formed(plane), solid = true;
+            for (auto& meshes : closed) {
+                well_formed = well_formed && is_well_formed(meshes.first) && is_well_formed(meshes.second);
+                solid = solid && is_closed(meshes.first) && is_closed(meshes.second);
+            }
+            CHECK ( well_formed );
+            CHECK ( solid );
+            CHECK ( !is_closed(plane) );
+        }
+
+        THEN ( "The counts follow the tessellation" ) {
+            CHECK ( make_ico_sphere<4>().index_count() == 20 * 16 * 3 );
+            CHECK ( make_uv_sphere<8, 3>().index_count() == 8 * 4 * 3 );
+            CHECK ( generate_cylinder(13, 3).vertex_count() == 14 * 4 + 28 );
+            CHECK ( plane.vertex_count() == 15 );
+        }
+    }
+
+    GIVEN ( "A uv sphere generated at runtime" ) {
+        auto mesh = generate_uv_sphere(12, 6);
+
+        THEN ( "Its bounds are the unit cube" ) {
+            CHECK ( mesh.m_min.x() == Approx(-1) );
+            CHECK ( mesh.m_max.y() == Approx(1) );
+            CHECK ( mesh.m_min.z() == Approx(-1) );
+        }
+    }
+}
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/// Testing the quat class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/quat.h>
+
+#include <cmath>
+
+SCENARIO ( "The quat class can be used for rotations", "[linalg][quat]" ) {
+
+    GIVEN ( "A default constructed quat" ) {
+        quat q;
+
+        WHEN ( "It is converted to a matrix4" ) {
+            auto m = q.to_matrix4();
+
+            THEN ( "The matrix is the identity matrix" ) {
+                CHECK ( m == matrix4() );
+            }
+        }
+    }
+
+    GIVEN ( "An angle and an axis" ) {
+        scalar rads = 0.8f;
+        vector3 axis(1, -2, 0.5f);
+
+        WHEN ( "The 'axis_angle' method is called" ) {
+            auto q = quat().axis_angle(rads, axis);
+            auto m = matrix4().rotate(rads, axis);
+
+            THEN ( "The quat matches matrix4::rotate" ) {
+                auto mq = q.to_matrix4();
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( mq.m_mat[i] == Approx( m.m_mat[i] ).margin(1e-6) );
+                }
+                CHECK ( q.len() == Approx( 1 ) );
+            }
+
+            AND_THEN ( "Rotating a vector matches the matrix" ) {
+                vector3 v(3, 1, -2);
+                auto r = q.rotate_vector(v);
+                CHECK ( r.x() == Approx( v.x() * m.m_mat[0] + v.y() * m.m_mat[4] + v.z() * m.m_mat[8] ) );
+                CHECK ( r.y() == Approx( v.x() * m.m_mat[1] + v.y() * m.m_mat[5] + v.z() * m.m_mat[9] ) );
+                CHECK ( r.z() == Approx( v.x() * m.m_mat[2] + v.y() * m.m_mat[6] + v.z() * m.m_mat[10] ) );
+            }
+        }
+    }
+
+    GIVEN ( "Two rotations" ) {
+        auto q1 = quat().axis_angle(0.5f, vector3(0, 0, 1));
+        auto q2 = quat().axis_angle(-1.2f, vector3(1, 1, 0));
+
+        WHEN ( "They are multiplied" ) {
+            auto q3 = q1 * q2;
+            quat q4(q1);
+            q4 *= q2;
+
+            THEN ( "The product matches the matrix4 product" ) {
+                auto m = q1.to_matrix4() * q2.to_matrix4();
+                auto mq = q3.to_matrix4();
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( mq.m_mat[i] == Approx( m.m_mat[i] ).margin(1e-6) );
+                }
+                CHECK ( q4 == q3 );
+            }
+        }
+
+        AND_WHEN ( "The first is multiplied by its inverse" ) {
+            auto q_conj = q1 * q1.clone().conjugate();
+            auto q_inv = q1 * q1.clone().invert();
+
+            THEN ( "The result is the identity rotation" ) {
+                for (auto i = 0u; i < 4; ++i) {
+                    CHECK ( q_conj.m_quat[i] == Approx( quat().m_quat[i] ).margin(1e-6) );
+                    CHECK ( q_inv.m_quat[i] == Approx( quat().m_quat[i] ).margin(1e-6) );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "Two rotations about the same axis" ) {
+        vector3 axis(0, 1, 0);
+        auto q1 = quat().axis_angle(0.2f, axis);
+        auto q2 = quat().axis_angle(1.4f, axis);
+
+        WHEN ( "They are interpolated with 'slerp' and 'nlerp'" ) {
+            auto qs = q1.clone().slerp(q2, 0.25f);
+            auto qn = q1.clone().nlerp(q2, 0.25f);
+            auto q_end = q1.clone().slerp(q2, 1);
+
+            THEN ( "slerp is exact and nlerp is close" ) {
+                auto q_correct = quat().axis_angle(0.5f, axis);
+                for (auto i = 0u; i < 4; ++i) {
+                    CHECK ( qs.m_quat[i] == Approx( q_correct.m_quat[i] ).margin(1e-6) );
+                    CHECK ( qn.m_quat[i] == Approx( q_correct.m_quat[i] ).margin(1e-2) );
+                    CHECK ( q_end.m_quat[i] == Approx( q2.m_quat[i] ).margin(1e-6) );
+                }
+                CHECK ( qn.len() == Approx( 1 ) );
+            }
+        }
+
+        AND_WHEN ( "One of them is negated (the same rotation)" ) {
+            quat q2_neg(-q2.x(), -q2.y(), -q2.z(), -q2.w());
+            auto qs = q1.clone().slerp(q2_neg, 0.5f);
+
+            THEN ( "slerp takes the shorter path" ) {
+                auto m = qs.to_matrix4();
+                auto m_correct = quat().axis_angle(0.8f, axis).to_matrix4();
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( m.m_mat[i] == Approx( m_correct.m_mat[i] ).margin(1e-6) );
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/// Testing the skeleton and skin classes
+///
+
+
+#include <catch.hpp>
+
+#include <scene/skinning.h>
+
+// Check a vector component-wise
+static void check_vector(const vector3& actual, const vector3& expected, double margin) {
+    CHECK ( actual.x() == Approx( expected.x() ).margin(margin) );
+    CHECK ( actual.y() == Approx( expected.y() ).margin(margin) );
+    CHECK ( actual.z() == Approx( expected.z() ).margin(margin) );
+}
+
+SCENARIO ( "The skeleton and skin classes deform vertices", "[scene][skinning]" ) {
+
+    GIVEN ( "A two joint arm and vertices weighted to either or both joints" ) {
+        skeleton arm;
+        auto shoulder = arm.add_joint(no_parent);
+        matrix4 elbow_local;
+        elbow_local.m_mat[12] = 2;
+        auto elbow = arm.add_joint(shoulder, elbow_local);
+        arm.bind();
+
+        skin mesh;
+        mesh.add(vector3(1, 0, 0), vector3(0, 1, 0), {{{0, 0, 0, 0}}, {{1, 0, 0, 0}}});
+        mesh.add(vector3(3, 0, 0), vector3(0, 2, 0), {{{1, 0, 0, 0}}, {{1, 0, 0, 0}}});
+        mesh.add(vector3(2, 1, 0), vector3(0, 0, 1), {{{0, 1, 0, 0}}, {{0.5f, 0.5f, 0, 0}}});
+        for (scalar x = 0; x < 9; ++x) {
+            mesh.add(vector3(x, 0.5f, 0), vector3(1, 1, 0), {{{0, 1, 0, 0}}, {{0.25f, 0.75f, 0, 0}}});
+        }
+        std::vector<skinned_vertex> out(mesh.size());
+
+        WHEN ( "The skeleton is in its bind pose" ) {
+            skin_vertices(mesh, arm.palette(), out.data(), 0, mesh.size());
+
+            THEN ( "The vertices do not move and the normals are normalized" ) {
+                check_vector(out[0].m_pos, vector3(1, 0, 0), 1e-6);
+                check_vector(out[1].m_pos, vector3(3, 0, 0), 1e-6);
+                check_vector(out[1].m_normal, vector3(0, 1, 0), 1e-5);
+                check_vector(out[2].m_pos, vector3(2, 1, 0), 1e-6);
+            }
+        }
+
+        WHEN ( "The elbow is bent" ) {
+            matrix4 bend;
+            bend.rotate(1.2f, vector3(0, 0, 1));
+            arm.m_joints.set_local(elbow, bend.clone().mul(elbow_local));
+            arm.update_palette();
+            skin_vertices(mesh, arm.palette(), out.data(), 0, mesh.size());
+
+            auto& elbow_palette = arm.palette()[elbow];
+            matrix4 blend = arm.palette()[shoulder] * 0.25f + elbow_palette * 0.75f;
+
+            THEN ( "Each vertex follows the blend of its joints" ) {
+                check_vector(out[0].m_pos, vector3(1, 0, 0), 1e-6);
+                check_vector(out[1].m_pos, elbow_palette.transform_point(vector3(3, 0, 0)), 1e-5);
+                check_vector(out[1].m_normal,
+                    elbow_palette.transform_vector(vector3(0, 1, 0)), 1e-5);
+                check_vector(out[3 + 5].m_pos, blend.transform_point(vector3(5, 0.5f, 0)), 1e-5);
+                check_vector(out[3 + 5].m_normal,
+                    blend.transform_vector(vector3(1, 1, 0)).normalize(), 1e-5);
+            }
+
+            THEN ( "A joint at the elbow keeps the elbow in place" ) {
+                check_vector(elbow_palette.transform_point(vector3(2, 0, 0)), vector3(2, 0, 0), 1e-6);
+            }
+        }
+
+        WHEN ( "Several meshes are skinned at once" ) {
+            matrix4 bend;
+            bend.rotate(-0.7f, vector3(0, 0, 1));
+            arm.m_joints.set_local(shoulder, bend);
+            arm.update_palette();
+
+            skin empty;
+            std::vector<skinned_vertex> out2(mesh.size()), expected(mesh.size());
+            skin_job jobs[] = {
+                {&mesh, arm.palette(), out.data()},
+                {&empty, arm.palette(), nullptr},
+                {&mesh, arm.palette(), out2.data()}
+            };
+            skin_meshes(jobs, 3);
+            skin_vertices(mesh, arm.palette(), expected.data(), 0, mesh.size());
+
+            THEN ( "Each mesh matches skinning it on its own" ) {
+                for (auto i = 0u; i < mesh.size(); ++i) {
+                    CHECK ( out[i].m_pos == expected[i].m_pos );
+                    CHECK ( out2[i].m_pos == expected[i].m_pos );
+                    CHECK ( out2[i].m_normal == expected[i].m_normal );
+                }
+            }
+        }
+
+        WHEN ( "Meshes large enough to be split across threads are skinned at once" ) {
+            matrix4 bend;
+            bend.rotate(0.4f, vector3(0, 0, 1));
+            arm.m_joints.set_local(elbow, bend.clone().mul(elbow_local));
+            arm.update_palette();
+
+            // 26021 vertices make three ranges of 8676, which start inside
+            // the third and fifth meshes and span the empty one
+            const std::size_t sizes[] = {5003, 0, 9001, 17, 12000};
+            std::vector<skin> meshes(5);
+            std::vector<std::vector<skinned_vertex>> outs(5), expected(5);
+            std::vector<skin_job> jobs;
+            for (auto m = 0u; m < 5; ++m) {
+                for (auto v = 0u; v < sizes[m]; ++v) {
+                    auto x = static_cast<scalar>(v % 97) / 24, weight = static_cast<scalar>(v % 5) / 4;
+                    meshes[m].add(vector3(x, static_cast<scalar>(m), 0.5f), vector3(1, x, 0),
+                        {{{0, 1, 0, 0}}, {{1 - weight, weight, 0, 0}}});
+                }
+                outs[m].resize(sizes[m]);
+                expected[m].resize(sizes[m]);
+                jobs.push_back({&meshes[m], arm.palette(), outs[m].data()});
+                skin_vertices(meshes[m], arm.palette(), expected[m].data(), 0, sizes[m]);
+            }
+            skin_meshes(jobs.data(), jobs.size());
+
+            THEN ( "Each mesh matches skinning it on its own" ) {
+                auto same = true;
+                for (auto m = 0u; m < 5; ++m) {
+                    for (auto v = 0u; v < sizes[m]; ++v) {
+                        same = same && outs[m][v].m_pos == expected[m][v].m_pos
+                            && outs[m][v].m_normal == expected[m][v].m_normal;
+                    }
+                }
+                CHECK ( same );
+            }
+        }
+    }
+}
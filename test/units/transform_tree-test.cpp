@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/// Testing the transform_tree class
+///
+
+
+#include <catch.hpp>
+
+#include <scene/transform_tree.h>
+
+static matrix4 translation(scalar x, scalar y, scalar z) {
+    matrix4 m;
+    m.m_mat[12] = x;
+    m.m_mat[13] = y;
+    m.m_mat[14] = z;
+    return m;
+}
+
+SCENARIO ( "The transform_tree class propagates world transforms lazily", "[scene][transform_tree]" ) {
+
+    GIVEN ( "A root with a chain of two children and a second child" ) {
+        matrix4 spin;
+        spin.rotate(0.5f, vector3(0, 0, 1));
+
+        transform_tree tree;
+        auto root = tree.add(no_parent, spin);
+        auto a = tree.add(root, translation(1, 0, 0));
+        auto b = tree.add(a, translation(0, 2, 0));
+        auto c = tree.add(root, translation(0, 0, 3));
+
+        WHEN ( "The tree is updated for the first time" ) {
+            auto updated = tree.update();
+
+            THEN ( "Every world transform is local times the parent world transform" ) {
+                CHECK ( updated == 4 );
+                CHECK ( tree.world(root) == spin );
+                CHECK ( tree.world(a) == translation(1, 0, 0) * spin );
+                CHECK ( tree.world(b) == translation(0, 2, 0) * translation(1, 0, 0) * spin );
+                CHECK ( tree.world(c) == translation(0, 0, 3) * spin );
+                CHECK ( !tree.dirty() );
+            }
+
+            THEN ( "A second update recomputes nothing" ) {
+                CHECK ( tree.update() == 0 );
+            }
+        }
+
+        WHEN ( "A child is changed after an update" ) {
+            tree.update();
+            auto c_world = tree.world(c);
+            tree.set_local(a, translation(5, 0, 0));
+            auto updated = tree.update();
+
+            THEN ( "Only the child and its subtree are recomputed" ) {
+                CHECK ( updated == 2 );
+                CHECK ( tree.world(a) == translation(5, 0, 0) * spin );
+                CHECK ( tree.world(b) == translation(0, 2, 0) * translation(5, 0, 0) * spin );
+                CHECK ( tree.world(c) == c_world );
+            }
+        }
+
+        WHEN ( "The root is multiplied by a matrix after an update" ) {
+            tree.update();
+            tree.mul_local(root, translation(0, 1, 0));
+            auto updated = tree.update();
+            auto root_world = spin * translation(0, 1, 0);
+
+            THEN ( "The whole tree is recomputed" ) {
+                CHECK ( updated == 4 );
+                CHECK ( tree.local(root) == root_world );
+                CHECK ( tree.world(b) == translation(0, 2, 0) * translation(1, 0, 0) * root_world );
+                CHECK ( tree.world(c) == translation(0, 0, 3) * root_world );
+            }
+        }
+
+        WHEN ( "A node is added under a parent that is not in the tree" ) {
+            auto size = tree.size();
+            auto bad = tree.add(static_cast<node_id>(size), translation(1, 1, 1));
+
+            THEN ( "It is rejected" ) {
+                CHECK ( bad == no_parent );
+                CHECK ( tree.size() == size );
+            }
+        }
+
+        WHEN ( "The tree is cleared" ) {
+            tree.clear();
+
+            THEN ( "It is empty and clean" ) {
+                CHECK ( tree.size() == 0 );
+                CHECK ( !tree.dirty() );
+                CHECK ( tree.update() == 0 );
+            }
+        }
+    }
+}
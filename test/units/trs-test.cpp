@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/// Testing the trs class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/trs.h>
+
+SCENARIO ( "The trs class can be used for compact transforms", "[linalg][trs]" ) {
+
+    GIVEN ( "A default constructed trs" ) {
+        trs t;
+
+        WHEN ( "It is converted to a matrix4" ) {
+            auto m = t.to_matrix4();
+
+            THEN ( "The matrix is the identity matrix" ) {
+                CHECK ( m == matrix4() );
+            }
+        }
+    }
+
+    GIVEN ( "Two transforms" ) {
+        trs t1(quat().axis_angle(0.6f, vector3(1, 0, 1)), vector3(1, 2, 3), 2);
+        trs t2(quat().axis_angle(-0.3f, vector3(0, 1, 2)), vector3(-4, 0.5f, 1), 0.5f);
+
+        WHEN ( "They are multiplied" ) {
+            auto t3 = t1 * t2;
+
+            THEN ( "The product matches the matrix4 product" ) {
+                auto m = t1.to_matrix4() * t2.to_matrix4();
+                auto mt = t3.to_matrix4();
+                for (auto i = 0u; i < 16; ++i) {
+                    CHECK ( mt.m_mat[i] == Approx( m.m_mat[i] ).margin(1e-5) );
+                }
+            }
+        }
+
+        AND_WHEN ( "Points and directions are transformed" ) {
+            vector3 p(0.5f, -2, 3);
+            auto tp = t1.transform_point(p);
+            auto tv = t1.transform_vector(p);
+            auto m = t1.to_matrix4();
+
+            THEN ( "The results match the matrix" ) {
+                CHECK ( tp.x() == Approx( p.x() * m.m_mat[0] + p.y() * m.m_mat[4] + p.z() * m.m_mat[8] + m.m_mat[12] ) );
+                CHECK ( tp.y() == Approx( p.x() * m.m_mat[1] + p.y() * m.m_mat[5] + p.z() * m.m_mat[9] + m.m_mat[13] ) );
+                CHECK ( tp.z() == Approx( p.x() * m.m_mat[2] + p.y() * m.m_mat[6] + p.z() * m.m_mat[10] + m.m_mat[14] ) );
+                CHECK ( tv.x() == Approx( p.x() * m.m_mat[0] + p.y() * m.m_mat[4] + p.z() * m.m_mat[8] ) );
+            }
+        }
+
+        AND_WHEN ( "The first is inverted" ) {
+            auto t_inv = t1.clone().invert();
+
+            THEN ( "The inverse undoes the transform" ) {
+                vector3 p(7, -1, 0.25f);
+                auto p_back = t_inv.transform_point(t1.transform_point(p));
+                CHECK ( p_back.x() == Approx( p.x() ) );
+                CHECK ( p_back.y() == Approx( p.y() ) );
+                CHECK ( p_back.z() == Approx( p.z() ) );
+            }
+        }
+
+        AND_WHEN ( "They are interpolated" ) {
+            auto t_start = t1.clone().lerp(t2, 0);
+            auto t_end = t1.clone().lerp(t2, 1);
+            auto t_mid = t1.clone().lerp(t2, 0.5f);
+
+            THEN ( "The end points are reproduced" ) {
+                CHECK ( t_start == t1 );
+                CHECK ( t_end.m_pos == t2.m_pos );
+                CHECK ( t_end.m_scale == Approx( t2.m_scale ) );
+                CHECK ( t_mid.m_scale == Approx( 1.25f ) );
+            }
+        }
+    }
+
+}
@@ -281,4 +281,70 @@ SCENARIO ( "The vector3 class can be used for linear algebra", "[linalg][vector3
         }
     }
 
+    GIVEN ( "Three vector3 with any arbitrary values" ) {
+        scalar x1 = 1, y1 = 2, z1 = 3,
+               x2 = 11, y2 = 12, z2 = 13,
+               x3 = -4, y3 = 5, z3 = 0.5f;
+        vector3 v1(x1, y1, z1);
+        vector3 v2(x2, y2, z2);
+        vector3 v3(x3, y3, z3);
+        scalar s = 0.2f;
+
+        WHEN ( "A compound expression is evaluated" ) {
+            vector3 v4 = v1 + v2 * s - v3;
+            vector3 v5(v1);
+            v5 += s * (v2 - v3);
+            vector3 v6;
+            v6 = (v1 - v2) * s;
+
+            THEN ( "The results match the element-wise values" ) {
+                CHECK ( v4 == vector3(x1+x2*s-x3, y1+y2*s-y3, z1+z2*s-z3) );
+                CHECK ( v5 == vector3(x1+s*(x2-x3), y1+s*(y2-y3), z1+s*(z2-z3)) );
+                CHECK ( v6 == vector3((x1-x2)*s, (y1-y2)*s, (z1-z2)*s) );
+            }
+        }
+
+        AND_WHEN ( "An expression is assigned to one of its operands" ) {
+            v1 = v2 - v1 * s;
+
+            THEN ( "The operand is updated correctly" ) {
+                CHECK ( v1 == vector3(x2-x1*s, y2-y1*s, z2-z1*s) );
+            }
+        }
+    }
+
+}
+
+SCENARIO ( "The vector3d class works in double precision", "[linalg][vector3]" ) {
+
+    GIVEN ( "A vector3d and a vector3 with the same values" ) {
+        vector3d a(1, 1e-9, -2), b(0.5, 3, 1e9);
+        vector3 af(a);
+
+        THEN ( "The vector3 converts explicitly" ) {
+            CHECK ( vector3d(af) == vector3d(1, static_cast<double>(af.y()), -2) );
+            CHECK ( af == vector3(1, 1e-9f, -2) );
+        }
+
+        WHEN ( "Values differ by less than a float can resolve" ) {
+            auto c = b.clone();
+            c.z() += 1;
+
+            THEN ( "The vector3d still tells them apart" ) {
+                CHECK ( c != b );
+                CHECK ( vector3(c) == vector3(b) );
+            }
+        }
+
+        AND_WHEN ( "The methods and expressions are used" ) {
+            vector3d sum = a + b * 2.0;
+
+            THEN ( "The results are double precision" ) {
+                CHECK ( sum == vector3d(2, 6 + 1e-9, 2e9 - 2) );
+                CHECK ( a.dot(b) == Approx( 0.5 + 3e-9 - 2e9 ) );
+                CHECK ( a.clone().cross(b).dot(a) == Approx( 0 ).margin( 1e-6 ) );
+                CHECK ( a.clone().normalize().len() == Approx( 1 ) );
+            }
+        }
+    }
 }
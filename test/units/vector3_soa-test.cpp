@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/// Testing the vector3_soa class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/vector3_soa.h>
+
+#include <cstdint>
+#include <vector>
+
+SCENARIO ( "The vector3_soa class matches the vector3 methods", "[linalg][vector3_soa]" ) {
+
+    GIVEN ( "Two arrays of vectors (not a multiple of four long)" ) {
+        std::vector<vector3> a, b;
+        for (auto i = 0; i < 11; ++i) {
+            auto f = static_cast<scalar>(i);
+            a.emplace_back(f - 5, 0.5f * f, 3 - f);
+            b.emplace_back(2 * f, 1 - f, 0.25f * f + 1);
+        }
+        a[4] = vector3(0, 0, 0);
+
+        vector3_soa sa(a.data(), a.size()), sb(b.data(), b.size());
+
+        THEN ( "The lanes are aligned and hold the vectors" ) {
+            REQUIRE ( sa.size() == a.size() );
+            CHECK ( reinterpret_cast<std::uintptr_t>(sa.m_x.data()) % 32 == 0 );
+            CHECK ( reinterpret_cast<std::uintptr_t>(sa.m_y.data()) % 32 == 0 );
+            CHECK ( reinterpret_cast<std::uintptr_t>(sa.m_z.data()) % 32 == 0 );
+
+            std::vector<vector3> out(a.size());
+            sa.to_array(out.data());
+            for (auto i = 0u; i < a.size(); ++i) {
+                CHECK ( out[i] == a[i] );
+            }
+        }
+
+        WHEN ( "The 'dot', 'len' and 'len2' methods are called" ) {
+            std::vector<scalar> dots(a.size()), lens(a.size()), lens2(a.size());
+            sa.dot(sb, dots.data());
+            sa.len(lens.data());
+            sa.len2(lens2.data());
+
+            THEN ( "The results match vector3" ) {
+                for (auto i = 0u; i < a.size(); ++i) {
+                    CHECK ( dots[i] == Approx( a[i].dot(b[i]) ) );
+                    CHECK ( lens[i] == Approx( a[i].len() ) );
+                    CHECK ( lens2[i] == Approx( a[i].len2() ) );
+                }
+            }
+        }
+
+        AND_WHEN ( "The 'cross', 'normalize' and 'lerp' methods are called" ) {
+            auto crossed = sa.clone().cross(sb);
+            auto normalized = sa.clone().normalize();
+            auto lerped = sa.clone().lerp(sb, 0.25f);
+
+            THEN ( "The results match vector3" ) {
+                for (auto i = 0u; i < a.size(); ++i) {
+                    CHECK ( crossed.get(i) == a[i].clone().cross(b[i]) );
+                    CHECK ( normalized.get(i) == a[i].clone().normalize() );
+                    CHECK ( lerped.get(i) == a[i].clone().lerp(b[i], 0.25f) );
+                }
+            }
+        }
+
+        AND_WHEN ( "The 'add', 'sub' and 'scale' methods are called" ) {
+            auto summed = sa.clone().add(sb);
+            auto diffed = sa.clone().sub(sb);
+            auto scaled = sa.clone().scale(-2);
+
+            THEN ( "The results match vector3" ) {
+                for (auto i = 0u; i < a.size(); ++i) {
+                    CHECK ( summed.get(i) == a[i] + b[i] );
+                    CHECK ( diffed.get(i) == a[i] - b[i] );
+                    CHECK ( scaled.get(i) == a[i] * -2 );
+                }
+            }
+        }
+    }
+
+    GIVEN ( "A resized vector3_soa" ) {
+        vector3_soa s(3);
+        s.set(1, vector3(1, 2, 3));
+        s.resize(6);
+
+        THEN ( "The old vectors are kept and new ones are zero" ) {
+            CHECK ( s.size() == 6 );
+            CHECK ( s.get(1) == vector3(1, 2, 3) );
+            CHECK ( s.get(5) == vector3(0, 0, 0) );
+        }
+    }
+}
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+/// Testing the vector3a class
+///
+
+
+#include <catch.hpp>
+
+#include <linalg/vector3a.h>
+
+#include <cstdint>
+
+SCENARIO ( "The vector3a class matches the vector3 methods", "[linalg][vector3a]" ) {
+
+    GIVEN ( "Two vector3a and the same values as vector3" ) {
+        vector3 a(1, -2, 3.5f), b(-0.5f, 4, 2);
+        vector3a aa(a), ba(b);
+
+        THEN ( "The vector3a are padded and aligned" ) {
+            CHECK ( sizeof(vector3a) == 16 );
+            CHECK ( reinterpret_cast<std::uintptr_t>(&aa) % 16 == 0 );
+            CHECK ( aa.to_vector3() == a );
+        }
+
+        WHEN ( "The mutating methods are called" ) {
+            THEN ( "The results match vector3" ) {
+                CHECK ( aa.clone().add(ba).to_vector3() == a.clone().add(b) );
+                CHECK ( aa.clone().sub(ba).to_vector3() == a.clone().sub(b) );
+                CHECK ( aa.clone().scale(-3).to_vector3() == a.clone().scale(-3) );
+                CHECK ( aa.clone().normalize().to_vector3() == a.clone().normalize() );
+                CHECK ( aa.clone().cross(ba).to_vector3() == a.clone().cross(b) );
+                CHECK ( aa.clone().lerp(ba, 0.3f).to_vector3() == a.clone().lerp(b, 0.3f) );
+                CHECK ( aa.clone().cross(ba).m_vec[3] == Approx( 0 ) );
+            }
+        }
+
+        AND_WHEN ( "The information methods are called" ) {
+            THEN ( "The results match vector3" ) {
+                CHECK ( aa.dot(ba) == Approx( a.dot(b) ) );
+                CHECK ( aa.len() == Approx( a.len() ) );
+                CHECK ( aa.len2() == Approx( a.len2() ) );
+            }
+        }
+    }
+
+    GIVEN ( "A vector3a_array" ) {
+        vector3a_array vecs(5, vector3a(1, 2, 3));
+
+        THEN ( "Every vector is aligned" ) {
+            for (const auto& v : vecs) {
+                CHECK ( reinterpret_cast<std::uintptr_t>(v.m_vec.data()) % 16 == 0 );
+            }
+        }
+    }
+}